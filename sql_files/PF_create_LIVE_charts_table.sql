@@ -55,3 +55,22 @@ CREATE TABLE live_point_and_figure.pf_charts
 );
 
 ALTER TABLE live_point_and_figure.pf_charts OWNER TO data_updater_pg;
+
+-- P&F breadth for each exchange (or other group of charts) over time.
+-- Percentages are derived so they are always consistent with the counts.
+
+DROP TABLE IF EXISTS live_point_and_figure.pf_breadth CASCADE;
+
+CREATE TABLE live_point_and_figure.pf_breadth
+(
+    breadth_group TEXT NOT NULL,
+    as_of_date DATE NOT NULL,
+    charts INTEGER NOT NULL,
+    in_x_columns INTEGER NOT NULL,
+    on_buy_signal INTEGER NOT NULL,
+    percent_in_x_columns NUMERIC(6, 2) GENERATED ALWAYS AS (100.0 * in_x_columns / NULLIF(charts, 0)) STORED,
+    bullish_percent NUMERIC(6, 2) GENERATED ALWAYS AS (100.0 * on_buy_signal / NULLIF(charts, 0)) STORED,
+    PRIMARY KEY (breadth_group, as_of_date)
+);
+
+ALTER TABLE live_point_and_figure.pf_breadth OWNER TO data_updater_pg;
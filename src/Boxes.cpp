@@ -30,6 +30,7 @@
 /* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
 
 #include <algorithm>
+#include <cmath>
 #include <iterator>
 #include <utility>
 
@@ -137,6 +138,30 @@ size_t Boxes::Distance(const Box &from, const Box &to) const
     return rng::distance(y, x);
 } // -----  end of method Boxes::Distance  -----
 
+int64_t Boxes::BoxIndex(const Box &box) const
+{
+    return rng::distance(boxes_.begin(), rng::lower_bound(boxes_, box));
+} // -----  end of method Boxes::BoxIndex  -----
+
+Boxes::Box Boxes::BoxAtIndex(int64_t box_index) const
+{
+    BOOST_ASSERT_MSG(!boxes_.empty(), "No boxes to find a box index in.");
+
+    const auto last = static_cast<int64_t>(boxes_.size()) - 1;
+    if (box_index >= 0 && box_index <= last)
+    {
+        return boxes_[box_index];
+    }
+    const auto beyond = box_index < 0 ? box_index : box_index - last;
+    const auto &from = box_index < 0 ? boxes_.front() : boxes_.back();
+    if (box_scale_ == BoxScale::e_Percent)
+    {
+        return dbl2dec(dec2dbl(from) * std::pow(dec2dbl(percent_box_factor_up_), static_cast<double>(beyond)))
+            .rescale(percent_exponent_);
+    }
+    return from + runtime_box_size_ * decimal::Decimal{beyond};
+} // -----  end of method Boxes::BoxAtIndex  -----
+
 Boxes::Box Boxes::FindBox(const decimal::Decimal &new_value)
 {
     if (boxes_.empty())
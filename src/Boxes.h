@@ -121,6 +121,21 @@ public:
 
     [[nodiscard]] size_t Distance(const Box &from, const Box &to) const;
 
+    // position of a box in the list (binary search since the list is in ascending order).
+    // Positions change when boxes are added below so only compare ones taken together.
+
+    [[nodiscard]] int64_t BoxIndex(const Box &box) const;
+
+    // for things which can run off either end of the list (trend lines, price objectives)
+    // so positions past the ends are extended by the box size (or factor). Those boxes
+    // aren't added to the list.
+
+    [[nodiscard]] Box BoxAtIndex(int64_t box_index) const;
+    [[nodiscard]] double BoxIndexToDbl(int64_t box_index) const
+    {
+        return dec2dbl(BoxAtIndex(box_index));
+    }
+
     // ====================  MUTATORS      =======================================
 
     Box FindBox(const decimal::Decimal &new_value);
@@ -20,6 +20,7 @@
 #include <format>
 #include <memory>
 #include <ranges>
+#include <stdexcept>
 
 namespace rng = std::ranges;
 namespace vws = std::ranges::views;
@@ -38,6 +39,7 @@ namespace vws = std::ranges::views;
 // using namespace py::literals;
 
 #include "ConstructChartGraphic.h"
+#include "ConstructSVGChartGraphic.h"
 #include "PF_Column.h"
 #include "PF_Signals.h"
 
@@ -88,115 +90,240 @@ const auto tt_cat_buy_sym = Chart::ArrowShape();
 const auto tb_cat_sell_sym = Chart::ArrowShape(180);
 // NOLINTEND
 
-void ConstructCDPFChartGraphicAndWriteToFile(const PF_Chart &the_chart, const fs::path &output_filename,
-                                             const StreamedPrices &streamed_prices,
-                                             const std::string & /*show_trend_lines*/, X_AxisFormat date_or_time)
+void ConstructPFChartGraphicAndWriteToFile(const PF_Chart &the_chart, const fs::path &output_filename,
+                                           const StreamedPrices &streamed_prices, const std::string &show_trend_lines,
+                                           X_AxisFormat date_or_time, GraphicsRenderer renderer,
+                                           PF_ChartRenderData *render_data)
 {
-    BOOST_ASSERT_MSG(
-        !the_chart.empty(),
-        std::format("Chart for symbol: {} contains no data. Unable to draw graphic.", the_chart.GetSymbol()).c_str());
+    if (renderer == GraphicsRenderer::e_native)
+    {
+        ConstructSVGPFChartGraphicAndWriteToFile(the_chart, output_filename, streamed_prices, show_trend_lines,
+                                                 date_or_time);
+        return;
+    }
+    if (render_data != nullptr)
+    {
+        ConstructCDPFChartGraphicAndWriteToFile(the_chart, *render_data, output_filename, streamed_prices,
+                                                show_trend_lines, date_or_time);
+        return;
+    }
+    ConstructCDPFChartGraphicAndWriteToFile(the_chart, output_filename, streamed_prices, show_trend_lines,
+                                            date_or_time);
+}
 
+void ConstructSummaryGraphicAndWriteToFile(const PF_StreamedSummary &streamed_summary, const fs::path &output_filename,
+                                           GraphicsRenderer renderer)
+{
+    if (renderer == GraphicsRenderer::e_native)
+    {
+        ConstructSVGSummaryGraphicAndWriteToFile(streamed_summary, output_filename);
+        return;
+    }
+    ConstructCDSummaryGraphic(streamed_summary, output_filename);
+}
+
+void PF_ChartRenderData::Update(const PF_Chart &the_chart, X_AxisFormat date_or_time)
+{
     const auto columns_in_PF_Chart = the_chart.size();
+    const auto first_column_start = the_chart[0].GetTimeSpan().first;
+
+    // columns before the last one we saw are finished so they can't have changed.
+
+    size_t first_to_do = layers_.empty() ? 0 : layers_.size() - 1;
+    if (columns_in_PF_Chart < layers_.size() || date_or_time != date_or_time_ ||
+        first_column_start != first_column_start_ || the_chart.GetChartBaseName() != chart_name_)
+    {
+        first_to_do = 0;
+        layers_.clear();
+        rev_to_up_count_ = 0;
+        rev_to_down_count_ = 0;
+        chart_name_ = the_chart.GetChartBaseName();
+        first_column_start_ = first_column_start;
+        date_or_time_ = date_or_time;
+    }
+    columns_redone_ = columns_in_PF_Chart - first_to_do;
+
+    // new entries are filled in below along with the ones being redone.
+
+    for (auto *layer : {&up_top_, &up_bot_, &down_top_, &down_bot_, &rev_to_up_top_, &rev_to_up_bot_,
+                        &rev_to_down_top_, &rev_to_down_bot_})
+    {
+        layer->resize(columns_in_PF_Chart);
+    }
+    x_axis_labels_.resize(columns_in_PF_Chart);
+    layers_.resize(columns_in_PF_Chart, Layer::e_none);
+
+    const bool show_reversals = the_chart.GetReversalboxes() == 1;
+
+    for (size_t ndx = first_to_do; ndx < columns_in_PF_Chart; ++ndx)
+    {
+        const auto &col = the_chart[ndx];
+
+        // same choices GetTopBottomForColumns makes for each of its filters.
+
+        Layer layer = Layer::e_none;
+        if (col.GetDirection() != PF_Column::Direction::e_Unknown)
+        {
+            const bool up = col.GetDirection() == PF_Column::Direction::e_Up;
+            if (!col.GetHadReversal())
+            {
+                layer = up ? Layer::e_up : Layer::e_down;
+            }
+            else if (show_reversals && col.GetReversalboxes() == 1)
+            {
+                layer = up ? Layer::e_rev_to_up : Layer::e_rev_to_down;
+            }
+        }
+
+        // a column being redone may have been a reversal last time
+
+        rev_to_up_count_ -= layers_[ndx] == Layer::e_rev_to_up ? 1 : 0;
+        rev_to_down_count_ -= layers_[ndx] == Layer::e_rev_to_down ? 1 : 0;
+        layers_[ndx] = layer;
+
+        up_top_[ndx] = up_bot_[ndx] = down_top_[ndx] = down_bot_[ndx] = Chart::NoValue;
+        rev_to_up_top_[ndx] = rev_to_up_bot_[ndx] = rev_to_down_top_[ndx] = rev_to_down_bot_[ndx] = Chart::NoValue;
+
+        if (layer != Layer::e_none)
+        {
+            const auto top = dec2dbl(the_chart.GetBoxes().FindNextBox(col.GetTop()));
+            const auto bot = dec2dbl(col.GetBottom());
+            switch (layer)
+            {
+                using enum Layer;
+                case e_up:
+                    up_top_[ndx] = top;
+                    up_bot_[ndx] = bot;
+                    break;
+                case e_down:
+                    down_top_[ndx] = top;
+                    down_bot_[ndx] = bot;
+                    break;
+                case e_rev_to_up:
+                    rev_to_up_top_[ndx] = top;
+                    rev_to_up_bot_[ndx] = bot;
+                    ++rev_to_up_count_;
+                    break;
+                case e_rev_to_down:
+                    rev_to_down_top_[ndx] = top;
+                    rev_to_down_bot_[ndx] = bot;
+                    ++rev_to_down_count_;
+                    break;
+                case e_none:
+                default:
+                    break;
+            }
+        }
+
+        // for x-axis label, we use the begin date for each column
+
+        x_axis_labels_[ndx] = date_or_time == X_AxisFormat::e_show_date
+                                  ? std::format("{:%F}", col.GetTimeSpan().first)
+                                  : UTCTimePointToLocalTZHMSString(col.GetTimeSpan().first);
+    }
+
+    // limit the number of columns shown on graphic if requested
 
     const auto max_columns_for_graph = the_chart.GetMaxGraphicColumns();
-    size_t skipped_columns = max_columns_for_graph < 1 || columns_in_PF_Chart <= max_columns_for_graph
-                                 ? 0
-                                 : columns_in_PF_Chart - max_columns_for_graph;
+    skipped_columns_ = max_columns_for_graph < 1 || columns_in_PF_Chart <= static_cast<size_t>(max_columns_for_graph)
+                           ? 0
+                           : columns_in_PF_Chart - max_columns_for_graph;
 
-    // std::cout << std::format("cols in chart: {}, max_cols: {}, skipped: {}\n", columns_in_PF_Chart,
-    // max_columns_for_graph, skipped_columns); return;
+    CollectSignals(the_chart);
+}
+
+void PF_ChartRenderData::CollectSignals(const PF_Chart &the_chart)
+{
+    // there aren't many signals and where they go depends on how many columns
+    // we skip so these are always done from scratch.
+
+    signals_ = Signals_1{};
+
+    auto filter_skipped_cols = the_chart.GetSignals() | vws::filter([this](const auto &sig) {
+                                   return static_cast<size_t>(sig.column_number_) >= skipped_columns_;
+                               });
+
+    for (const auto &sig : filter_skipped_cols)
+    {
+        const double price = dec2dbl(sig.signal_price_);
+        const double x = sig.column_number_ - skipped_columns_;
+        switch (sig.signal_type_)
+        {
+            using enum PF_SignalType;
+            case e_double_top_buy:
+                signals_.dt_buys_price_.emplace_back(price);
+                signals_.dt_buys_x_.emplace_back(x);
+                break;
+            case e_double_bottom_sell:
+                signals_.db_sells_price_.emplace_back(price);
+                signals_.db_sells_x_.emplace_back(x);
+                break;
+            case e_triple_top_buy:
+                signals_.tt_buys_price_.emplace_back(price);
+                signals_.tt_buys_x_.emplace_back(x);
+                break;
+            case e_triple_bottom_sell:
+                signals_.tb_sells_price_.emplace_back(price);
+                signals_.tb_sells_x_.emplace_back(x);
+                break;
+            case e_bullish_tt_buy:
+                signals_.bullish_tt_buys_price_.emplace_back(price);
+                signals_.bullish_tt_buys_x_.emplace_back(x);
+                break;
+            case e_bearish_tb_sell:
+                signals_.bearish_tb_sells_price_.emplace_back(price);
+                signals_.bearish_tb_sells_x_.emplace_back(x);
+                break;
+            case e_catapult_buy:
+                signals_.cat_buys_price_.emplace_back(price);
+                signals_.cat_buys_x_.emplace_back(x);
+                break;
+            case e_catapult_sell:
+                signals_.cat_sells_price_.emplace_back(price);
+                signals_.cat_sells_x_.emplace_back(x);
+                break;
+            case e_ttop_catapult_buy:
+                signals_.tt_cat_buys_price_.emplace_back(price);
+                signals_.tt_cat_buys_x_.emplace_back(x);
+                break;
+            case e_tbottom_catapult_sell:
+                signals_.tb_cat_sells_price_.emplace_back(price);
+                signals_.tb_cat_sells_x_.emplace_back(x);
+                break;
+            case e_unknown:
+            default:
+                break;
+        }
+    }
+}
+
+void ConstructCDPFChartGraphicAndWriteToFile(const PF_Chart &the_chart, const fs::path &output_filename,
+                                             const StreamedPrices &streamed_prices,
+                                             const std::string &show_trend_lines, X_AxisFormat date_or_time)
+{
+    PF_ChartRenderData render_data;
+    ConstructCDPFChartGraphicAndWriteToFile(the_chart, render_data, output_filename, streamed_prices,
+                                            show_trend_lines, date_or_time);
+}
+
+void ConstructCDPFChartGraphicAndWriteToFile(const PF_Chart &the_chart, PF_ChartRenderData &render_data,
+                                             const fs::path &output_filename, const StreamedPrices &streamed_prices,
+                                             const std::string &show_trend_lines, X_AxisFormat date_or_time)
+{
+    BOOST_ASSERT_MSG(
+        !the_chart.empty(),
+        std::format("Chart for symbol: {} contains no data. Unable to draw graphic.", the_chart.GetSymbol()).c_str());
 
     // for our chart graphic there are 4 types of columns: up, down, reversed-to-up and reversed-to-down.
     // there will be a separate layer for each of these types so a different color can be assigned to each.
     // in order for eveything to line up correctly each layer must contain all the points whether they are
-    // used in that layor or not.  'NoValue' values are used. So, fill each layer with 'NoValue' then
-    // over-write the values that are used in that layer.
-
-    PF_Chart::ColumnTopBottomList up_layer{
-        columns_in_PF_Chart, PF_Chart::ColumnTopBottomInfo{.col_top_ = Chart::NoValue, .col_bot_ = Chart::NoValue}};
-    PF_Chart::ColumnTopBottomList down_layer{
-        columns_in_PF_Chart, PF_Chart::ColumnTopBottomInfo{.col_top_ = Chart::NoValue, .col_bot_ = Chart::NoValue}};
-    PF_Chart::ColumnTopBottomList reversed_to_up_layer{
-        columns_in_PF_Chart, PF_Chart::ColumnTopBottomInfo{.col_top_ = Chart::NoValue, .col_bot_ = Chart::NoValue}};
-    PF_Chart::ColumnTopBottomList reversed_to_down_layer{
-        columns_in_PF_Chart, PF_Chart::ColumnTopBottomInfo{.col_top_ = Chart::NoValue, .col_bot_ = Chart::NoValue}};
-
-    // collect data for each graphic layer.
-
-    auto up_cols = the_chart.GetTopBottomForColumns(PF_ColumnFilter::e_up_column);
-    auto down_cols = the_chart.GetTopBottomForColumns(PF_ColumnFilter::e_down_column);
-    PF_Chart::ColumnTopBottomList rev_to_up_cols;
-    PF_Chart::ColumnTopBottomList rev_to_down_cols;
-    if (the_chart.GetReversalboxes() == 1 && the_chart.HasReversedColumns())
-    {
-        rev_to_up_cols = the_chart.GetTopBottomForColumns(PF_ColumnFilter::e_reversed_to_up);
-        rev_to_down_cols = the_chart.GetTopBottomForColumns(PF_ColumnFilter::e_reversed_to_down);
-    }
-    // next, merge to data for each column type into the layer list
-
-    rng::for_each(up_cols, [&up_layer](const auto &col_info) { up_layer[col_info.col_nbr_] = col_info; });
-    rng::for_each(down_cols, [&down_layer](const auto &col_info) { down_layer[col_info.col_nbr_] = col_info; });
-    if (!rev_to_up_cols.empty())
-    {
-        rng::for_each(rev_to_up_cols, [&reversed_to_up_layer](const auto &col_info) {
-            reversed_to_up_layer[col_info.col_nbr_] = col_info;
-        });
-    }
-    if (!rev_to_down_cols.empty())
-    {
-        rng::for_each(rev_to_down_cols, [&reversed_to_down_layer](const auto &col_info) {
-            reversed_to_down_layer[col_info.col_nbr_] = col_info;
-        });
-    }
-
-    // now, make our data arrays for the graphic software
-    // but first, limit the number of columns shown on graphic if requested
-
-    std::vector<double> up_data_top;
-    up_data_top.reserve(columns_in_PF_Chart - skipped_columns);
-    std::vector<double> up_data_bot;
-    up_data_bot.reserve(columns_in_PF_Chart - skipped_columns);
-
-    rng::for_each(up_layer | vws::drop(skipped_columns), [&up_data_top, &up_data_bot](const auto &col_info) {
-        up_data_top.push_back(col_info.col_top_);
-        up_data_bot.push_back(col_info.col_bot_);
-    });
-
-    std::vector<double> down_data_top;
-    down_data_top.reserve(columns_in_PF_Chart - skipped_columns);
-    std::vector<double> down_data_bot;
-    down_data_bot.reserve(columns_in_PF_Chart - skipped_columns);
-
-    rng::for_each(down_layer | vws::drop(skipped_columns), [&down_data_top, &down_data_bot](const auto &col_info) {
-        down_data_top.push_back(col_info.col_top_);
-        down_data_bot.push_back(col_info.col_bot_);
-    });
-
-    std::vector<double> reversed_to_up_data_top;
-    std::vector<double> reversed_to_up_data_bot;
-    if (!rev_to_up_cols.empty())
-    {
-        reversed_to_up_data_top.reserve(columns_in_PF_Chart - skipped_columns);
-        reversed_to_up_data_bot.reserve(columns_in_PF_Chart - skipped_columns);
-        rng::for_each(reversed_to_up_layer | vws::drop(skipped_columns),
-                      [&reversed_to_up_data_top, &reversed_to_up_data_bot](const auto &col_info) {
-                          reversed_to_up_data_top.push_back(col_info.col_top_);
-                          reversed_to_up_data_bot.push_back(col_info.col_bot_);
-                      });
-    }
+    // used in that layor or not.  'NoValue' values are used. render_data has all that.
 
-    std::vector<double> reversed_to_down_data_top;
-    std::vector<double> reversed_to_down_data_bot;
-    if (!rev_to_down_cols.empty())
-    {
-        reversed_to_down_data_top.reserve(columns_in_PF_Chart - skipped_columns);
-        reversed_to_down_data_bot.reserve(columns_in_PF_Chart - skipped_columns);
-        rng::for_each(reversed_to_down_layer | vws::drop(skipped_columns),
-                      [&reversed_to_down_data_top, &reversed_to_down_data_bot](const auto &col_info) {
-                          reversed_to_down_data_top.push_back(col_info.col_top_);
-                          reversed_to_down_data_bot.push_back(col_info.col_bot_);
-                      });
-    }
+    render_data.Update(the_chart, date_or_time);
+
+    const auto max_columns_for_graph = the_chart.GetMaxGraphicColumns();
+    const auto skipped_columns = render_data.skipped_columns_;
+    const auto shown_columns = render_data.ShownColumns();
 
     // want to show approximate overall change in value (computed from boxes, not actual prices)
 
@@ -229,27 +356,11 @@ void ConstructCDPFChartGraphicAndWriteToFile(const PF_Chart &the_chart, const fs
         std::chrono::zoned_time(std::chrono::current_zone(),
                                 std::chrono::clock_cast<std::chrono::system_clock>(the_chart.GetLastChangeTime())));
 
-    // for x-axis label, we use the begin date for each column
     // the chart software wants an array of const char*.
-    // this will take several steps.
-
-    std::vector<std::string> x_axis_labels;
-    x_axis_labels.reserve(columns_in_PF_Chart - skipped_columns);
-
-    rng::for_each(the_chart | vws::drop(skipped_columns), [&x_axis_labels, &date_or_time](const auto &col) {
-        if (date_or_time == X_AxisFormat::e_show_date)
-        {
-            x_axis_labels.emplace_back(std::format("{:%F}", col.GetTimeSpan().first));
-        }
-        else
-        {
-            x_axis_labels.emplace_back(UTCTimePointToLocalTZHMSString(col.GetTimeSpan().first));
-        }
-    });
 
     std::vector<const char *> x_axis_label_data;
-    x_axis_label_data.reserve(columns_in_PF_Chart - skipped_columns);
-    rng::for_each(x_axis_labels,
+    x_axis_label_data.reserve(shown_columns);
+    rng::for_each(render_data.x_axis_labels_ | vws::drop(skipped_columns),
                   [&x_axis_label_data](const auto &label) { x_axis_label_data.push_back(label.c_str()); });
 
     std::unique_ptr<XYChart> c;
@@ -277,7 +388,7 @@ void ConstructCDPFChartGraphicAndWriteToFile(const PF_Chart &the_chart, const fs
 
     c->xAxis()->setLabels(StringArray(x_axis_label_data.data(), x_axis_label_data.size()))->setFontAngle(45.);
 
-    c->xAxis()->setLabelStep((columns_in_PF_Chart - skipped_columns) / 40, 0);
+    c->xAxis()->setLabelStep(shown_columns / 40, 0);
 
     c->yAxis()->setLabelStyle("Arial Bold");
     if (the_chart.IsPercent())
@@ -295,29 +406,33 @@ void ConstructCDPFChartGraphicAndWriteToFile(const PF_Chart &the_chart, const fs
     c->yAxis2()->copyAxis(c->yAxis());
 
     // now we can add our data for the columns.  Each column type in its own layer.
+    // limit the number of columns shown by bumping the pointer and adjusting the count.
 
-    c->addBoxLayer(DoubleArray(up_data_top.data(), up_data_top.size()),
-                   DoubleArray(up_data_bot.data(), up_data_bot.size()), GREEN, "Up");
-    c->addBoxLayer(DoubleArray(down_data_top.data(), down_data_top.size()),
-                   DoubleArray(down_data_bot.data(), down_data_bot.size()), RED, "Down");
+    auto shown = [skipped_columns, shown_columns](const std::vector<double> &layer) {
+        return DoubleArray(layer.data() + skipped_columns, static_cast<int>(shown_columns));
+    };
+
+    c->addBoxLayer(shown(render_data.up_top_), shown(render_data.up_bot_), GREEN, "Up");
+    c->addBoxLayer(shown(render_data.down_top_), shown(render_data.down_bot_), RED, "Down");
 
     // reversal layes do not always occur
 
-    if (!reversed_to_up_data_top.empty())
+    if (render_data.rev_to_up_count_ > 0)
     {
-        c->addBoxLayer(DoubleArray(reversed_to_up_data_top.data(), reversed_to_up_data_top.size()),
-                       DoubleArray(reversed_to_up_data_bot.data(), reversed_to_up_data_bot.size()), BLUE, "Revse2Up");
+        c->addBoxLayer(shown(render_data.rev_to_up_top_), shown(render_data.rev_to_up_bot_), BLUE, "Revse2Up");
     }
-    if (!reversed_to_down_data_top.empty())
+    if (render_data.rev_to_down_count_ > 0)
     {
-        c->addBoxLayer(DoubleArray(reversed_to_down_data_top.data(), reversed_to_down_data_top.size()),
-                       DoubleArray(reversed_to_down_data_bot.data(), reversed_to_down_data_bot.size()), ORANGE,
+        c->addBoxLayer(shown(render_data.rev_to_down_top_), shown(render_data.rev_to_down_bot_), ORANGE,
                        "Revse2Down");
     }
 
-    Signals_1 data_for_PF;
+    if (show_trend_lines == "angle")
+    {
+        ConstructCDPFChartGraphicAddTrendLines(the_chart, skipped_columns, shown_columns, c);
+    }
 
-    ConstructCDPFChartGraphicAddPFSignals(the_chart, data_for_PF, skipped_columns, c);
+    ConstructCDPFChartGraphicAddPFSignals(render_data.signals_, c);
 
     // let's show where we started from
 
@@ -423,7 +538,10 @@ void ConstructCDPFChartGraphicAndWriteToFile(const PF_Chart &the_chart, const fs
 
     if (!p)
     {
-        c->makeChart(output_filename.c_str());
+        if (!c->makeChart(output_filename.c_str()))
+        {
+            throw std::runtime_error(std::format("Unable to write PF_chart graphic to: {}.", output_filename.string()));
+        }
         return;
     }
 
@@ -434,69 +552,45 @@ void ConstructCDPFChartGraphicAndWriteToFile(const PF_Chart &the_chart, const fs
     m->addChart(0, 0, c.get());
     m->addChart(0, (kChartHeight2 * kDpi), p.get());
 
-    m->makeChart(output_filename.c_str());
+    if (!m->makeChart(output_filename.c_str()))
+    {
+        throw std::runtime_error(std::format("Unable to write PF_chart graphic to: {}.", output_filename.string()));
+    }
 }
 
-void ConstructCDPFChartGraphicAddPFSignals(const PF_Chart &the_chart, Signals_1 &data_arrays, size_t skipped_columns,
-                                           std::unique_ptr<XYChart> &the_graphic)
+void ConstructCDPFChartGraphicAddTrendLines(const PF_Chart &the_chart, size_t skipped_columns, size_t shown_columns,
+                                            std::unique_ptr<XYChart> &the_graphic)
 {
-    // we may need to drop some signals.
+    // 1 layer per line so a line isn't joined up to the next one of its kind. Each runs
+    // from where it starts to the column which breached it (or the current column).
 
-    auto filter_skipped_cols = the_chart.GetSignals() | vws::filter([skipped_columns](const auto &sig) {
-                                   return sig.column_number_ >= skipped_columns;
-                               });
+    const auto last_column = static_cast<int32_t>(the_chart.size()) - 1;
+    const auto first_shown = static_cast<int32_t>(skipped_columns);
 
-    for (const auto &sig : filter_skipped_cols)
+    std::vector<double> line_values(shown_columns);
+    for (const auto &line : the_chart.GetTrendLines())
     {
-        switch (sig.signal_type_)
+        const auto end_column = line.InForce() ? last_column : line.breach_column_;
+        const auto first_column = std::max(line.start_column_, first_shown);
+        if (end_column <= first_column)
         {
-            using enum PF_SignalType;
-            case e_double_top_buy:
-                data_arrays.dt_buys_price_.emplace_back(dec2dbl(sig.signal_price_));
-                data_arrays.dt_buys_x_.emplace_back(sig.column_number_ - skipped_columns);
-                break;
-            case e_double_bottom_sell:
-                data_arrays.db_sells_price_.emplace_back(dec2dbl(sig.signal_price_));
-                data_arrays.db_sells_x_.emplace_back(sig.column_number_ - skipped_columns);
-                break;
-            case e_triple_top_buy:
-                data_arrays.tt_buys_price_.emplace_back(dec2dbl(sig.signal_price_));
-                data_arrays.tt_buys_x_.emplace_back(sig.column_number_ - skipped_columns);
-                break;
-            case e_triple_bottom_sell:
-                data_arrays.tb_sells_price_.emplace_back(dec2dbl(sig.signal_price_));
-                data_arrays.tb_sells_x_.emplace_back(sig.column_number_ - skipped_columns);
-                break;
-            case e_bullish_tt_buy:
-                data_arrays.bullish_tt_buys_price_.emplace_back(dec2dbl(sig.signal_price_));
-                data_arrays.bullish_tt_buys_x_.emplace_back(sig.column_number_ - skipped_columns);
-                break;
-            case e_bearish_tb_sell:
-                data_arrays.bearish_tb_sells_price_.emplace_back(dec2dbl(sig.signal_price_));
-                data_arrays.bearish_tb_sells_x_.emplace_back(sig.column_number_ - skipped_columns);
-                break;
-            case e_catapult_buy:
-                data_arrays.cat_buys_price_.emplace_back(dec2dbl(sig.signal_price_));
-                data_arrays.cat_buys_x_.emplace_back(sig.column_number_ - skipped_columns);
-                break;
-            case e_catapult_sell:
-                data_arrays.cat_sells_price_.emplace_back(dec2dbl(sig.signal_price_));
-                data_arrays.cat_sells_x_.emplace_back(sig.column_number_ - skipped_columns);
-                break;
-            case e_ttop_catapult_buy:
-                data_arrays.tt_cat_buys_price_.emplace_back(dec2dbl(sig.signal_price_));
-                data_arrays.tt_cat_buys_x_.emplace_back(sig.column_number_ - skipped_columns);
-                break;
-            case e_tbottom_catapult_sell:
-                data_arrays.tb_cat_sells_price_.emplace_back(dec2dbl(sig.signal_price_));
-                data_arrays.tb_cat_sells_x_.emplace_back(sig.column_number_ - skipped_columns);
-                break;
-            case e_unknown:
-            default:
-                break;
+            continue;
+        }
+        rng::fill(line_values, Chart::NoValue);
+        for (auto col = first_column; col <= end_column; ++col)
+        {
+            line_values[col - first_shown] = the_chart.TrendLineValue(line, col);
         }
+        auto *the_layer = the_graphic->addLineLayer(
+            DoubleArray(line_values.data(), static_cast<int>(line_values.size())),
+            the_graphic->dashLineColor(line.kind_ == PF_TrendLineKind::e_bullish_support ? GREEN : RED,
+                                       Chart::DashLine));
+        the_layer->setLineWidth(2);
     }
+}
 
+void ConstructCDPFChartGraphicAddPFSignals(const Signals_1 &data_arrays, std::unique_ptr<XYChart> &the_graphic)
+{
     // now we can add layers (if any) with signals
 
     if (!data_arrays.dt_buys_price_.empty())
@@ -792,5 +886,8 @@ void ConstructCDSummaryGraphic(const PF_StreamedSummary &streamed_summary, const
     c->yAxis2()->copyAxis(c->yAxis());
     c->yAxis2()->setTickWidth(3, 1);
 
-    c->makeChart(output_filename.c_str());
+    if (!c->makeChart(output_filename.c_str()))
+    {
+        throw std::runtime_error(std::format("Unable to write summary graphic to: {}.", output_filename.string()));
+    }
 }
@@ -17,7 +17,9 @@
 #ifndef _CONSTRUCTCHARTGRAPHIC_INC_
 #define _CONSTRUCTCHARTGRAPHIC_INC_
 
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <vector>
 
 class XYChart;
@@ -74,21 +76,104 @@ struct Signals_2
 
 #include "PF_Chart.h"
 
+// =====================================================================================
+//        Class:  PF_ChartRenderData
+//  Description:  everything the ChartDirector graphic needs from a chart's columns:
+//                the 4 box layers, the x-axis labels and the signal arrays.
+//
+//  Made in 1 pass over the columns. Data is kept for every column, not just the ones
+//  shown, so a chart which is drawn over and over (streaming) only redoes the columns
+//  which could have changed since the last Update: the last one we saw (it was the
+//  current column then) and any added since. The graphic points at the tail it shows.
+//
+//  Anything which looks like a different chart (fewer columns, different first column,
+//  name or label format) gets a full rebuild.
+// =====================================================================================
+
+class PF_ChartRenderData
+{
+public:
+    void Update(const PF_Chart &the_chart, X_AxisFormat date_or_time);
+
+    [[nodiscard]] size_t ShownColumns() const { return up_top_.size() - skipped_columns_; }
+    [[nodiscard]] size_t ColumnsRedoneLastUpdate() const { return columns_redone_; }
+
+    // layer values are Chart::NoValue for columns not in that layer.
+
+    std::vector<double> up_top_;
+    std::vector<double> up_bot_;
+    std::vector<double> down_top_;
+    std::vector<double> down_bot_;
+    std::vector<double> rev_to_up_top_;
+    std::vector<double> rev_to_up_bot_;
+    std::vector<double> rev_to_down_top_;
+    std::vector<double> rev_to_down_bot_;
+
+    std::vector<std::string> x_axis_labels_;
+
+    // these are only for the columns shown so they are redone each time.
+
+    size_t skipped_columns_ = 0;
+    Signals_1 signals_;
+
+    size_t rev_to_up_count_ = 0;
+    size_t rev_to_down_count_ = 0;
+
+private:
+    enum class Layer : int8_t
+    {
+        e_none,
+        e_up,
+        e_down,
+        e_rev_to_up,
+        e_rev_to_down
+    };
+
+    void CollectSignals(const PF_Chart &the_chart);
+
+    std::vector<Layer> layers_;
+
+    std::string chart_name_;
+    PF_Column::TmPt first_column_start_{};
+    X_AxisFormat date_or_time_ = X_AxisFormat::e_show_date;
+    size_t columns_redone_ = 0;
+};
+
 // void ConstructChartGraphAndWriteToFile(const PF_Chart& the_chart, const fs::path& output_filename, const
 // streamed_prices& streamed_prices,
 //                                        const std::string& show_trend_lines, X_AxisFormat
 //                                        date_or_time=X_AxisFormat::e_show_date);
 
+// ChartDirector or our own SVG writer (ConstructSVGChartGraphic.h). Both make the same picture.
+
+// pass render_data to keep it between calls for the same chart (ChartDirector only).
+
+void ConstructPFChartGraphicAndWriteToFile(const PF_Chart &the_chart, const fs::path &output_filename,
+                                           const StreamedPrices &streamed_prices, const std::string &show_trend_lines,
+                                           X_AxisFormat date_or_time, GraphicsRenderer renderer,
+                                           PF_ChartRenderData *render_data = nullptr);
+
 void ConstructCDPFChartGraphicAndWriteToFile(const PF_Chart &the_chart, const fs::path &output_filename,
                                              const StreamedPrices &streamed_prices, const std::string &show_trend_lines,
                                              X_AxisFormat date_or_time = X_AxisFormat::e_show_date);
 
-void ConstructCDPFChartGraphicAddPFSignals(const PF_Chart &the_chart, Signals_1 &data_arrays, size_t skipped_columns,
-                                           std::unique_ptr<XYChart> &the_graphic);
+void ConstructCDPFChartGraphicAndWriteToFile(const PF_Chart &the_chart, PF_ChartRenderData &render_data,
+                                             const fs::path &output_filename, const StreamedPrices &streamed_prices,
+                                             const std::string &show_trend_lines, X_AxisFormat date_or_time);
+
+void ConstructCDPFChartGraphicAddPFSignals(const Signals_1 &data_arrays, std::unique_ptr<XYChart> &the_graphic);
+
+void ConstructCDPFChartGraphicAddTrendLines(const PF_Chart &the_chart, size_t skipped_columns, size_t shown_columns,
+                                            std::unique_ptr<XYChart> &the_graphic);
 
 void ConstructCDPricesGraphicAddSignals(const PF_Chart &the_chart, Signals_2 &data_arrays, size_t skipped_price_cols,
                                         const StreamedPrices &streamed_prices, std::unique_ptr<XYChart> &the_graphic);
 
+// the streamer's summary graphic, drawn by whichever renderer draws the charts.
+
+void ConstructSummaryGraphicAndWriteToFile(const PF_StreamedSummary &streamed_summary, const fs::path &output_filename,
+                                           GraphicsRenderer renderer);
+
 void ConstructCDSummaryGraphic(const PF_StreamedSummary &streamed_summary, const fs::path &output_filename);
 
 #endif // ----- #ifndef _CONSTRUCTCHARTGRAPHIC_INC_  -----
@@ -0,0 +1,804 @@
+// =====================================================================================
+//
+//       Filename:  ConstructSVGChartGraphic.cpp
+//
+//    Description:  Code to generate an SVG graphic of a PF_Chart without ChartDirector
+//
+//        Version:  1.0
+//        Created:  10/18/2026 09:12:40 AM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (), driedel@cox.net
+//   Organization:
+//
+// =====================================================================================
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <ranges>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <boost/assert.hpp>
+
+namespace rng = std::ranges;
+namespace vws = std::ranges::views;
+
+#include "ConstructSVGChartGraphic.h"
+#include "PF_Column.h"
+#include "PF_Signals.h"
+
+// same colors, sizes and layout as the ChartDirector graphics so the 2 can be used
+// interchangeably.
+
+namespace
+{
+constexpr std::string_view kRed = "#FF0000";
+constexpr std::string_view kBlack = "#000000";
+constexpr std::string_view kGreen = "#008000";
+constexpr std::string_view kYellow = "#FFFF00";
+constexpr std::string_view kBlue = "#0000FF";
+constexpr std::string_view kOrange = "#FFA500";
+constexpr std::string_view kLiteGray = "#C0C0C0";
+
+constexpr double kDpi{72};
+constexpr double kChartWidth{16 * kDpi};
+constexpr double kChartHeight1{14 * kDpi}; // P & F only
+constexpr double kChartHeight2{11 * kDpi}; // P & F above prices
+constexpr double kChartHeight3{8 * kDpi};  // prices
+constexpr double kChartHeight4{19 * kDpi}; // both
+
+constexpr double kPFMarkerSize{10};
+constexpr double kPriceMarkerSize{13};
+constexpr int32_t kMaxXLabels{40};
+
+struct PlotArea
+{
+    double left_;
+    double top_;
+    double width_;
+    double height_;
+
+    [[nodiscard]] double Right() const { return left_ + width_; }
+    [[nodiscard]] double Bottom() const { return top_ + height_; }
+
+    // middle of the ndx'th of 'slots' equal slices across the plot
+    [[nodiscard]] double X(std::size_t ndx, std::size_t slots) const
+    {
+        return left_ + (static_cast<double>(ndx) + 0.5) * width_ / static_cast<double>(std::max<std::size_t>(1, slots));
+    }
+};
+
+class YScale
+{
+public:
+    YScale(double low, double high, bool log_scale) : log_scale_{log_scale && low > 0}
+    {
+        if (high <= low)
+        {
+            high = low + 1;
+        }
+
+        // a little room above and below so nothing sits on the edge of the plot.
+
+        if (log_scale_)
+        {
+            low_ = std::log10(low) - (std::log10(high) - std::log10(low)) * 0.03;
+            high_ = std::log10(high) + (std::log10(high) - std::log10(low)) * 0.03;
+        }
+        else
+        {
+            low_ = low - (high - low) * 0.03;
+            high_ = high + (high - low) * 0.03;
+        }
+    }
+
+    [[nodiscard]] double Y(double value, const PlotArea &plot) const
+    {
+        const double where = log_scale_ ? std::log10(std::max(value, 1e-9)) : value;
+        return plot.Bottom() - (where - low_) / (high_ - low_) * plot.height_;
+    }
+
+    [[nodiscard]] double Low() const { return log_scale_ ? std::pow(10.0, low_) : low_; }
+    [[nodiscard]] double High() const { return log_scale_ ? std::pow(10.0, high_) : high_; }
+    [[nodiscard]] bool IsLog() const { return log_scale_; }
+
+private:
+    double low_ = 0;
+    double high_ = 1;
+    bool log_scale_ = false;
+};
+
+enum class MarkerShape : int32_t
+{
+    e_square,
+    e_circle,
+    e_triangle,
+    e_inverted_triangle,
+    e_cross,
+    e_up_arrow,
+    e_down_arrow
+};
+
+struct SignalStyle
+{
+    std::string_view name_;
+    MarkerShape shape_;
+    std::string_view color_;
+};
+
+// indexed by PF_SignalType
+
+constexpr std::array<SignalStyle, 11> kSignalStyles{{{"", MarkerShape::e_square, kBlack},
+                                                     {"dt buy", MarkerShape::e_square, kYellow},
+                                                     {"db sell", MarkerShape::e_square, kBlack},
+                                                     {"tt buy", MarkerShape::e_circle, kYellow},
+                                                     {"tb sell", MarkerShape::e_circle, kBlack},
+                                                     {"bullish tt buy", MarkerShape::e_triangle, kYellow},
+                                                     {"bearish tb sell", MarkerShape::e_inverted_triangle, kBlack},
+                                                     {"cat buy", MarkerShape::e_cross, kYellow},
+                                                     {"cat sell", MarkerShape::e_cross, kBlack},
+                                                     {"tt cat buy", MarkerShape::e_up_arrow, kYellow},
+                                                     {"tb cat sell", MarkerShape::e_down_arrow, kBlack}}};
+
+const SignalStyle *StyleFor(int32_t signal_type)
+{
+    if (signal_type <= std::to_underlying(PF_SignalType::e_unknown) ||
+        signal_type >= static_cast<int32_t>(kSignalStyles.size()))
+    {
+        return nullptr;
+    }
+    return &kSignalStyles[signal_type];
+}
+
+void AppendEscaped(std::string &svg, std::string_view text)
+{
+    for (const char c : text)
+    {
+        switch (c)
+        {
+            case '&':
+                svg += "&amp;";
+                break;
+            case '<':
+                svg += "&lt;";
+                break;
+            case '>':
+                svg += "&gt;";
+                break;
+            case '"':
+                svg += "&quot;";
+                break;
+            default:
+                svg += c;
+        }
+    }
+}
+
+void AppendText(std::string &svg, double x, double y, std::string_view text, std::string_view attributes)
+{
+    std::format_to(std::back_inserter(svg), R"(<text x="{:.1f}" y="{:.1f}" {}>)", x, y, attributes);
+    AppendEscaped(svg, text);
+    svg += "</text>\n";
+}
+
+void AppendMarker(std::string &svg, MarkerShape shape, double x, double y, double size, std::string_view color)
+{
+    // yellow doesn't show on white without an outline.
+
+    const auto half = size / 2;
+    auto out = std::back_inserter(svg);
+    switch (shape)
+    {
+        using enum MarkerShape;
+        case e_square:
+            std::format_to(out,
+                           R"(<rect x="{:.1f}" y="{:.1f}" width="{:.1f}" height="{:.1f}" fill="{}" stroke="#000"/>)",
+                           x - half, y - half, size, size, color);
+            break;
+        case e_circle:
+            std::format_to(out, R"(<circle cx="{:.1f}" cy="{:.1f}" r="{:.1f}" fill="{}" stroke="#000"/>)", x, y, half,
+                           color);
+            break;
+        case e_triangle:
+            std::format_to(out, R"(<path d="M{:.1f} {:.1f}L{:.1f} {:.1f}L{:.1f} {:.1f}Z" fill="{}" stroke="#000"/>)",
+                           x, y - half, x + half, y + half, x - half, y + half, color);
+            break;
+        case e_inverted_triangle:
+            std::format_to(out, R"(<path d="M{:.1f} {:.1f}L{:.1f} {:.1f}L{:.1f} {:.1f}Z" fill="{}" stroke="#000"/>)",
+                           x, y + half, x + half, y - half, x - half, y - half, color);
+            break;
+        case e_cross:
+        {
+            // 0.3 of the size for the width of the arms, like ChartDirector's CrossShape(0.3)
+            const auto arm = size * 0.15;
+            std::format_to(out,
+                           R"(<path d="M{0:.1f} {2:.1f}H{1:.1f}V{3:.1f}H{4:.1f}V{5:.1f}H{1:.1f}V{6:.1f}H{0:.1f})"
+                           R"(V{5:.1f}H{7:.1f}V{3:.1f}H{0:.1f}Z" fill="{8}" stroke="#000"/>)",
+                           x - arm, x + arm, y - half, y - arm, x + half, y + arm, y + half, x - half, color);
+            break;
+        }
+        case e_up_arrow:
+        case e_down_arrow:
+        {
+            const auto tip = shape == e_up_arrow ? -half : half;
+            std::format_to(out,
+                           R"(<path d="M{0:.1f} {1:.1f}L{2:.1f} {3:.1f}H{4:.1f}V{5:.1f}H{6:.1f}V{3:.1f}H{7:.1f}Z" )"
+                           R"(fill="{8}" stroke="#000"/>)",
+                           x, y + tip, x + half, y, x + half * 0.4, y - tip, x - half * 0.4, x - half, color);
+            break;
+        }
+    }
+    svg += '\n';
+}
+
+// 1, 2 or 5 times a power of 10
+
+double NiceStep(double range, int32_t how_many)
+{
+    const auto rough = range / how_many;
+    const auto magnitude = std::pow(10.0, std::floor(std::log10(rough)));
+    const auto scaled = rough / magnitude;
+    return (scaled < 1.5 ? 1 : scaled < 3 ? 2 : scaled < 7 ? 5 : 10) * magnitude;
+}
+
+std::vector<double> YTicks(const YScale &scale)
+{
+    std::vector<double> ticks;
+    const auto low = scale.Low();
+    const auto high = scale.High();
+
+    if (scale.IsLog() && high / low >= 10)
+    {
+        for (auto decade = std::pow(10.0, std::floor(std::log10(low))); decade <= high; decade *= 10)
+        {
+            for (const auto multiple : {1.0, 2.0, 5.0})
+            {
+                if (const auto tick = decade * multiple; tick >= low && tick <= high)
+                {
+                    ticks.push_back(tick);
+                }
+            }
+        }
+        return ticks;
+    }
+
+    const auto step = NiceStep(high - low, 10);
+    for (auto tick = std::ceil(low / step) * step; tick <= high; tick += step)
+    {
+        ticks.push_back(tick);
+    }
+    return ticks;
+}
+
+// horizontal grid lines with labels on both sides, vertical grid lines at the x labels.
+
+void AppendGridAndYAxis(std::string &svg, const PlotArea &plot, const YScale &scale, std::size_t slots,
+                        std::size_t label_step)
+{
+    auto out = std::back_inserter(svg);
+    std::format_to(out,
+                   R"(<rect x="{:.1f}" y="{:.1f}" width="{:.1f}" height="{:.1f}" fill="none" stroke="{}"/>)"
+                   "\n",
+                   plot.left_, plot.top_, plot.width_, plot.height_, kLiteGray);
+
+    const auto ticks = YTicks(scale);
+    const auto step = ticks.size() > 1 ? ticks[1] - ticks[0] : 1.0;
+    const auto decimals = scale.IsLog() ? 2 : std::clamp(static_cast<int32_t>(-std::floor(std::log10(step))), 0, 6);
+
+    for (const auto tick : ticks)
+    {
+        const auto y = scale.Y(tick, plot);
+        std::format_to(out, R"(<line x1="{:.1f}" y1="{:.1f}" x2="{:.1f}" y2="{:.1f}" stroke="{}"/>)"
+                            "\n",
+                       plot.left_, y, plot.Right(), y, kLiteGray);
+        const auto label = std::format("{:.{}f}", tick, decimals);
+        AppendText(svg, plot.left_ - 4, y + 4, label, R"(text-anchor="end" font-weight="bold")");
+        AppendText(svg, plot.Right() + 4, y + 4, label, R"(font-weight="bold")");
+    }
+
+    for (std::size_t ndx = 0; ndx < slots; ndx += label_step)
+    {
+        const auto x = plot.X(ndx, slots);
+        std::format_to(out, R"(<line x1="{:.1f}" y1="{:.1f}" x2="{:.1f}" y2="{:.1f}" stroke="{}"/>)"
+                            "\n",
+                       x, plot.top_, x, plot.Bottom(), kLiteGray);
+    }
+}
+
+template <typename MakeLabel>
+void AppendXLabels(std::string &svg, const PlotArea &plot, std::size_t slots, std::size_t label_step,
+                   MakeLabel make_label)
+{
+    for (std::size_t ndx = 0; ndx < slots; ndx += label_step)
+    {
+        const auto x = plot.X(ndx, slots);
+        const auto y = plot.Bottom() + 12;
+        AppendText(svg, x, y, make_label(ndx), std::format(R"svg(transform="rotate(45 {:.1f} {:.1f})")svg", x, y));
+    }
+}
+
+void AppendDashedMark(std::string &svg, const PlotArea &plot, double y, int32_t line_width)
+{
+    std::format_to(std::back_inserter(svg),
+                   R"(<line x1="{:.1f}" y1="{:.1f}" x2="{:.1f}" y2="{:.1f}" stroke="{}" stroke-width="{}" )"
+                   R"(stroke-dasharray="8 4"/>)"
+                   "\n",
+                   plot.left_, y, plot.Right(), y, kRed, line_width);
+}
+
+// legend entries across the top of the plot, left to right. A full row wraps to a new
+// one above it, into the space under the title.
+
+class Legend
+{
+public:
+    Legend(std::string &svg, double x, double y) : svg_{svg}, left_{x}, x_{x}, y_{y} {}
+
+    void AddBox(std::string_view color, std::string_view name)
+    {
+        MakeRoomFor(name);
+        std::format_to(std::back_inserter(svg_),
+                       R"(<rect x="{:.1f}" y="{:.1f}" width="10" height="10" fill="{}" stroke="#000"/>)"
+                       "\n",
+                       x_, y_ - 9, color);
+        AddName(name);
+    }
+
+    void AddMarker(const SignalStyle &style)
+    {
+        MakeRoomFor(style.name_);
+        AppendMarker(svg_, style.shape_, x_ + 5, y_ - 4, kPFMarkerSize, style.color_);
+        AddName(style.name_);
+    }
+
+private:
+    static double WidthOf(std::string_view name) { return 14 + 6.5 * static_cast<double>(name.size()) + 16; }
+
+    void MakeRoomFor(std::string_view name)
+    {
+        if (x_ > left_ && x_ + WidthOf(name) > kChartWidth - 20)
+        {
+            x_ = left_;
+            y_ -= 16;
+        }
+    }
+
+    void AddName(std::string_view name)
+    {
+        AppendText(svg_, x_ + 14, y_, name, R"(font-style="italic" font-weight="bold")");
+        x_ += WidthOf(name);
+    }
+
+    std::string &svg_;
+    double left_;
+    double x_;
+    double y_;
+};
+
+void AppendPFChart(std::string &svg, const PF_Chart &the_chart, double chart_height,
+                   const decimal::Decimal &first_box, bool show_trend_lines, X_AxisFormat date_or_time)
+{
+    const auto first_value = dec2dbl(first_box);
+    const auto columns_in_PF_Chart = the_chart.size();
+    const auto max_columns_for_graph = the_chart.GetMaxGraphicColumns();
+    const std::size_t skipped_columns =
+        max_columns_for_graph < 1 || columns_in_PF_Chart <= static_cast<std::size_t>(max_columns_for_graph)
+            ? 0
+            : columns_in_PF_Chart - max_columns_for_graph;
+    const auto shown_columns = columns_in_PF_Chart - skipped_columns;
+
+    // 1 pass over the columns we show for everything we draw from them.
+    // As with GetTopBottomForColumns, a box's top is the next box up so the box covers the column.
+
+    struct ColumnBox
+    {
+        double top_;
+        double bottom_;
+        int32_t layer_; // -1 means nothing to draw
+    };
+    std::vector<ColumnBox> boxes;
+    boxes.reserve(shown_columns);
+
+    double low = first_value;
+    double high = first_value;
+    std::array<bool, 4> layer_used{};
+    const bool show_reversals = the_chart.GetReversalboxes() == 1;
+
+    for (const auto &col : the_chart | vws::drop(skipped_columns))
+    {
+        int32_t layer = -1;
+        if (col.GetDirection() != PF_Column::Direction::e_Unknown)
+        {
+            const bool up = col.GetDirection() == PF_Column::Direction::e_Up;
+            if (!col.GetHadReversal())
+            {
+                layer = up ? 0 : 1;
+            }
+            else if (show_reversals && col.GetReversalboxes() == 1)
+            {
+                layer = up ? 2 : 3;
+            }
+        }
+        if (layer < 0)
+        {
+            boxes.push_back({0, 0, -1});
+            continue;
+        }
+        const auto top = dec2dbl(the_chart.GetBoxes().FindNextBox(col.GetTop()));
+        const auto bottom = dec2dbl(col.GetBottom());
+        boxes.push_back({top, bottom, layer});
+        layer_used[layer] = true;
+        low = std::min(low, bottom);
+        high = std::max(high, top);
+    }
+
+    auto shown_signals = the_chart.GetSignals() | vws::filter([skipped_columns](const auto &sig) {
+                             return static_cast<std::size_t>(sig.column_number_) >= skipped_columns;
+                         });
+    std::array<bool, kSignalStyles.size()> signal_used{};
+    for (const auto &sig : shown_signals)
+    {
+        const auto price = dec2dbl(sig.signal_price_);
+        low = std::min(low, price);
+        high = std::max(high, price);
+        if (StyleFor(std::to_underlying(sig.signal_type_)) != nullptr)
+        {
+            signal_used[std::to_underlying(sig.signal_type_)] = true;
+        }
+    }
+
+    // each trend line runs from where it starts to the column which breached it (or the
+    // current column).
+
+    struct TrendLinePoints
+    {
+        std::string_view color_;
+        std::size_t first_ndx_;
+        std::vector<double> values_;
+    };
+    std::vector<TrendLinePoints> trend_lines;
+    if (show_trend_lines)
+    {
+        const auto last_column = static_cast<int32_t>(columns_in_PF_Chart) - 1;
+        for (const auto &line : the_chart.GetTrendLines())
+        {
+            const auto end_column = line.InForce() ? last_column : line.breach_column_;
+            const auto first_column = std::max(line.start_column_, static_cast<int32_t>(skipped_columns));
+            if (end_column <= first_column)
+            {
+                continue;
+            }
+            TrendLinePoints points{.color_ = line.kind_ == PF_TrendLineKind::e_bullish_support ? kGreen : kRed,
+                                   .first_ndx_ = first_column - skipped_columns,
+                                   .values_ = {}};
+            for (auto col = first_column; col <= end_column; ++col)
+            {
+                points.values_.push_back(the_chart.TrendLineValue(line, col));
+                low = std::min(low, points.values_.back());
+                high = std::max(high, points.values_.back());
+            }
+            trend_lines.push_back(std::move(points));
+        }
+    }
+
+    const PlotArea plot{50, 100, kChartWidth - 120, chart_height - 200};
+    const YScale scale{low, high, the_chart.IsPercent()};
+    const auto label_step = std::max<std::size_t>(1, shown_columns / kMaxXLabels);
+
+    // title, same as ChartDirector's
+
+    const decimal::Decimal last_box = the_chart.back().GetDirection() == PF_Column::Direction::e_Up
+                                          ? the_chart.back().GetTop()
+                                          : the_chart.back().GetBottom();
+    const decimal::Decimal overall_pct_chg = ((last_box - first_box) / first_box * 100).rescale(-2);
+
+    AppendText(svg, kChartWidth / 2, 30,
+               std::format("{}{} X {} for {} {}. Overall % change: {}{}", the_chart.GetChartBoxSize().format("f"),
+                           (the_chart.IsPercent() ? "%" : ""), the_chart.GetReversalboxes(), the_chart.GetSymbol(),
+                           (the_chart.IsPercent() ? "percent" : ""), overall_pct_chg.format("f"),
+                           skipped_columns > 0 ? std::format(" (last {} cols)", max_columns_for_graph) : ""),
+               R"(text-anchor="middle" font-size="14" font-weight="bold")");
+    AppendText(svg, kChartWidth / 2, 50,
+               std::format("Last change: {:%a, %b %d, %Y at %I:%M:%S %p %Z}",
+                           std::chrono::zoned_time(std::chrono::current_zone(),
+                                                   std::chrono::clock_cast<std::chrono::system_clock>(
+                                                       the_chart.GetLastChangeTime()))),
+               R"(text-anchor="middle" font-size="14" font-weight="bold")");
+
+    AppendGridAndYAxis(svg, plot, scale, shown_columns, label_step);
+
+    AppendXLabels(svg, plot, shown_columns, label_step, [&](std::size_t ndx) {
+        const auto start = the_chart[skipped_columns + ndx].GetTimeSpan().first;
+        return date_or_time == X_AxisFormat::e_show_date ? std::format("{:%F}", start)
+                                                         : UTCTimePointToLocalTZHMSString(start);
+    });
+
+    // a box for each column. 1 group per layer so each gets its color once.
+
+    constexpr std::array<std::string_view, 4> layer_colors{kGreen, kRed, kBlue, kOrange};
+    constexpr std::array<std::string_view, 4> layer_names{"Up", "Down", "Revse2Up", "Revse2Down"};
+
+    const auto slot_width = plot.width_ / static_cast<double>(std::max<std::size_t>(1, shown_columns));
+    for (int32_t layer = 0; layer < 4; ++layer)
+    {
+        if (!layer_used[layer])
+        {
+            continue;
+        }
+        std::format_to(std::back_inserter(svg), R"(<g fill="{}" stroke="#000" stroke-width="0.5">)"
+                                                "\n",
+                       layer_colors[layer]);
+        for (const auto &[ndx, box] : vws::enumerate(boxes))
+        {
+            if (box.layer_ != layer)
+            {
+                continue;
+            }
+            const auto top = scale.Y(box.top_, plot);
+            std::format_to(std::back_inserter(svg),
+                           R"(<rect x="{:.1f}" y="{:.1f}" width="{:.1f}" height="{:.1f}"/>)"
+                           "\n",
+                           plot.left_ + (static_cast<double>(ndx) + 0.1) * slot_width, top, slot_width * 0.8,
+                           std::max(0.5, scale.Y(box.bottom_, plot) - top));
+        }
+        svg += "</g>\n";
+    }
+
+    // where we started from
+
+    AppendDashedMark(svg, plot, scale.Y(first_value, plot), 3);
+
+    for (const auto &points : trend_lines)
+    {
+        std::format_to(std::back_inserter(svg),
+                       R"(<polyline fill="none" stroke="{}" stroke-width="2" stroke-dasharray="8 4" points=")",
+                       points.color_);
+        for (const auto &[ndx, value] : vws::enumerate(points.values_))
+        {
+            std::format_to(std::back_inserter(svg), "{:.1f},{:.1f} ",
+                           plot.X(points.first_ndx_ + static_cast<std::size_t>(ndx), shown_columns),
+                           scale.Y(value, plot));
+        }
+        svg += "\"/>\n";
+    }
+
+    for (const auto &sig : shown_signals)
+    {
+        if (const auto *style = StyleFor(std::to_underlying(sig.signal_type_)); style != nullptr)
+        {
+            AppendMarker(svg, style->shape_, plot.X(sig.column_number_ - skipped_columns, shown_columns),
+                         scale.Y(dec2dbl(sig.signal_price_), plot), kPFMarkerSize, style->color_);
+        }
+    }
+
+    Legend legend{svg, plot.left_, plot.top_ - 12};
+    for (int32_t layer = 0; layer < 4; ++layer)
+    {
+        // ChartDirector always lists up and down.
+        if (layer < 2 || layer_used[layer])
+        {
+            legend.AddBox(layer_colors[layer], layer_names[layer]);
+        }
+    }
+    for (const auto &[which, used] : vws::enumerate(signal_used))
+    {
+        if (used)
+        {
+            legend.AddMarker(kSignalStyles[which]);
+        }
+    }
+}
+
+void AppendPricesChart(std::string &svg, const PF_Chart &the_chart, const StreamedPrices &streamed_prices,
+                       double first_value, X_AxisFormat date_or_time)
+{
+    // We get a LOT of data from Eodhd so limit how much we show to about 2 points per pixel.
+
+    const auto max_price_cols = static_cast<std::size_t>(kChartWidth - 120 - 50) * 2;
+    const std::size_t skipped_price_cols =
+        streamed_prices.price_.size() > max_price_cols ? streamed_prices.price_.size() - max_price_cols : 0;
+    const auto shown_prices = streamed_prices.price_.size() - skipped_price_cols;
+    auto prices = streamed_prices.price_ | vws::drop(skipped_price_cols);
+
+    const PlotArea plot{50, 50, kChartWidth - 120, kChartHeight3 - 200};
+    const auto [low, high] = rng::minmax(prices);
+    const YScale scale{std::min(low, first_value), std::max(high, first_value), false};
+    constexpr std::size_t label_step = kMaxXLabels;
+
+    AppendText(svg, kChartWidth / 2, 20,
+               std::format("Price data for {} {}", the_chart.GetSymbol(),
+                           (skipped_price_cols == 0 ? "" : std::format("Showing last {} cols", max_price_cols))),
+               R"(text-anchor="middle" font-size="14")");
+
+    AppendGridAndYAxis(svg, plot, scale, shown_prices, label_step);
+
+    AppendXLabels(svg, plot, shown_prices, label_step, [&](std::size_t ndx) {
+        const PF_Column::TmPt when{std::chrono::seconds{streamed_prices.timestamp_seconds_[skipped_price_cols + ndx]}};
+        return date_or_time == X_AxisFormat::e_show_date ? std::format("{:%F}", when)
+                                                         : UTCTimePointToLocalTZHMSString(when);
+    });
+
+    svg += R"(<polyline fill="none" stroke-width="1" stroke=")";
+    svg += kRed;
+    svg += R"(" points=")";
+    for (const auto &[ndx, price] : vws::enumerate(prices))
+    {
+        std::format_to(std::back_inserter(svg), "{:.1f},{:.1f} ", plot.X(static_cast<std::size_t>(ndx), shown_prices),
+                       scale.Y(price, plot));
+    }
+    svg += "\"/>\n";
+
+    AppendDashedMark(svg, plot, scale.Y(first_value, plot), 2);
+
+    std::array<bool, kSignalStyles.size()> signal_used{};
+    for (std::size_t ndx = skipped_price_cols; ndx < streamed_prices.signal_type_.size(); ++ndx)
+    {
+        if (const auto *style = StyleFor(streamed_prices.signal_type_[ndx]); style != nullptr)
+        {
+            AppendMarker(svg, style->shape_, plot.X(ndx - skipped_price_cols, shown_prices),
+                         scale.Y(streamed_prices.price_[ndx], plot), kPriceMarkerSize, style->color_);
+            signal_used[streamed_prices.signal_type_[ndx]] = true;
+        }
+    }
+
+    Legend legend{svg, plot.left_, plot.top_ - 10};
+    for (const auto &[which, used] : vws::enumerate(signal_used))
+    {
+        if (used)
+        {
+            legend.AddMarker(kSignalStyles[which]);
+        }
+    }
+}
+
+void WriteSVGToFile(const std::string &svg, const fs::path &output_filename)
+{
+    std::ofstream out{output_filename, std::ios::out | std::ios::binary | std::ios::trunc};
+    if (!out.is_open())
+    {
+        throw std::runtime_error(std::format("Unable to open file: {} for chart graphic.", output_filename.string()));
+    }
+    out.write(svg.data(), static_cast<std::streamsize>(svg.size()));
+    out.close();
+    if (out.fail())
+    {
+        throw std::runtime_error(std::format("Unable to write chart graphic to: {}.", output_filename.string()));
+    }
+}
+} // namespace
+
+void ConstructSVGPFChartGraphic(const PF_Chart &the_chart, const StreamedPrices &streamed_prices,
+                                const std::string &show_trend_lines, X_AxisFormat date_or_time, std::string &svg)
+{
+    BOOST_ASSERT_MSG(
+        !the_chart.empty(),
+        std::format("Chart for symbol: {} contains no data. Unable to draw graphic.", the_chart.GetSymbol()).c_str());
+
+    // where we started from: the first column's first box. Apparently, this can be 0.
+
+    const auto &first_col = the_chart[0];
+    decimal::Decimal first_box =
+        first_col.GetDirection() == PF_Column::Direction::e_Up ? first_col.GetBottom() : first_col.GetTop();
+    if (first_box == sv2dec("0.0"))
+    {
+        first_box = sv2dec("0.01");
+    }
+
+    const bool with_prices = !streamed_prices.price_.empty();
+    const auto total_height = with_prices ? kChartHeight4 : kChartHeight1;
+
+    // most of a chart is boxes at about 60 bytes each.
+    svg.clear();
+    svg.reserve(4096 + the_chart.size() * 64 + (with_prices ? streamed_prices.price_.size() * 12 : 0));
+
+    std::format_to(std::back_inserter(svg),
+                   R"(<svg xmlns="http://www.w3.org/2000/svg" width="{0}" height="{1}" viewBox="0 0 {0} {1}" )"
+                   R"(font-family="Arial, Helvetica, sans-serif" font-size="11">)"
+                   "\n"
+                   R"(<rect width="100%" height="100%" fill="#FFFFFF"/>)"
+                   "\n",
+                   kChartWidth, total_height);
+
+    AppendPFChart(svg, the_chart, with_prices ? kChartHeight2 : kChartHeight1, first_box,
+                  show_trend_lines == "angle", date_or_time);
+
+    if (with_prices)
+    {
+        std::format_to(std::back_inserter(svg), R"svg(<g transform="translate(0 {})">)svg"
+                                                "\n",
+                       kChartHeight2);
+        AppendPricesChart(svg, the_chart, streamed_prices, dec2dbl(first_box), date_or_time);
+        svg += "</g>\n";
+    }
+    svg += "</svg>\n";
+}
+
+void ConstructSVGPFChartGraphicAndWriteToFile(const PF_Chart &the_chart, const fs::path &output_filename,
+                                              const StreamedPrices &streamed_prices,
+                                              const std::string &show_trend_lines, X_AxisFormat date_or_time)
+{
+    std::string svg;
+    ConstructSVGPFChartGraphic(the_chart, streamed_prices, show_trend_lines, date_or_time, svg);
+    WriteSVGToFile(svg, output_filename);
+}
+
+void ConstructSVGSummaryGraphic(const PF_StreamedSummary &streamed_summary, std::string &svg)
+{
+    // a bar for each symbol showing its percent change from the previous day's close.
+    // A symbol without an opening price yet gets a label but no bar.
+
+    std::vector<double> deltas;
+    deltas.reserve(streamed_summary.size());
+    std::vector<std::string_view> symbols;
+    symbols.reserve(streamed_summary.size());
+    double low = 0;
+    double high = 0;
+    for (const auto &[symbol, data] : streamed_summary)
+    {
+        const auto delta = (data.latest_price_ - data.opening_price_) / data.opening_price_ * 100.;
+        deltas.push_back(delta);
+        symbols.push_back(symbol);
+        if (std::isfinite(delta))
+        {
+            low = std::min(low, delta);
+            high = std::max(high, delta);
+        }
+    }
+
+    svg.clear();
+    svg.reserve(4096 + streamed_summary.size() * 256);
+
+    std::format_to(std::back_inserter(svg),
+                   R"(<svg xmlns="http://www.w3.org/2000/svg" width="{0}" height="{1}" viewBox="0 0 {0} {1}" )"
+                   R"(font-family="Arial, Helvetica, sans-serif" font-size="11">)"
+                   "\n"
+                   R"(<rect width="100%" height="100%" fill="#FFFFFF"/>)"
+                   "\n",
+                   kChartWidth, kChartHeight1);
+
+    AppendText(svg, kChartWidth / 2, 30, "Showing percent change for streamed tickers.",
+               R"(text-anchor="middle" font-size="12")");
+    AppendText(svg, kChartWidth / 2, 46, "(relative to previous day's close)", R"(text-anchor="middle" font-size="12")");
+
+    const PlotArea plot{50, 100, kChartWidth - 120, kChartHeight1 - 200};
+    const YScale scale{low, high, false};
+    const auto slots = deltas.size();
+    AppendGridAndYAxis(svg, plot, scale, slots, 1);
+
+    const auto bar_width = plot.width_ / static_cast<double>(std::max<std::size_t>(1, slots)) * 0.8;
+    const auto zero = scale.Y(0, plot);
+    for (const auto &[ndx, delta] : vws::enumerate(deltas))
+    {
+        if (!std::isfinite(delta))
+        {
+            continue;
+        }
+        const auto top = std::min(zero, scale.Y(delta, plot));
+        std::format_to(std::back_inserter(svg),
+                       R"(<rect x="{:.1f}" y="{:.1f}" width="{:.1f}" height="{:.1f}" fill="{}"/>)"
+                       "\n",
+                       plot.X(static_cast<std::size_t>(ndx), slots) - bar_width / 2, top, bar_width,
+                       std::abs(scale.Y(delta, plot) - zero), delta >= 0 ? kGreen : kRed);
+    }
+
+    AppendXLabels(svg, plot, slots, 1, [&symbols](std::size_t ndx) { return symbols[ndx]; });
+    svg += "</svg>\n";
+}
+
+void ConstructSVGSummaryGraphicAndWriteToFile(const PF_StreamedSummary &streamed_summary,
+                                              const fs::path &output_filename)
+{
+    std::string svg;
+    ConstructSVGSummaryGraphic(streamed_summary, svg);
+    WriteSVGToFile(svg, output_filename);
+}
@@ -0,0 +1,46 @@
+// =====================================================================================
+//
+//       Filename:  ConstructSVGChartGraphic.h
+//
+//    Description:  Code to generate an SVG graphic of a PF_Chart without ChartDirector
+//
+//        Version:  1.0
+//        Created:  10/18/2026 09:12:40 AM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (), driedel@cox.net
+//   Organization:
+//
+// =====================================================================================
+
+#ifndef _CONSTRUCTSVGCHARTGRAPHIC_INC_
+#define _CONSTRUCTSVGCHARTGRAPHIC_INC_
+
+#include <string>
+
+#include "PF_Chart.h"
+
+// the same picture ConstructCDPFChartGraphicAndWriteToFile draws: a box for each column,
+// a marker for each signal, the 45 degree trend lines if show_trend_lines is 'angle' and,
+// if there are streamed prices, a price panel underneath.
+// It's written straight from the chart's columns into 1 string so there are no per-layer
+// arrays and nothing to link but the standard library.
+
+void ConstructSVGPFChartGraphic(const PF_Chart &the_chart, const StreamedPrices &streamed_prices,
+                                const std::string &show_trend_lines, X_AxisFormat date_or_time, std::string &svg);
+
+void ConstructSVGPFChartGraphicAndWriteToFile(const PF_Chart &the_chart, const fs::path &output_filename,
+                                              const StreamedPrices &streamed_prices,
+                                              const std::string &show_trend_lines,
+                                              X_AxisFormat date_or_time = X_AxisFormat::e_show_date);
+
+// the streamer's summary: what ConstructCDSummaryGraphic draws, a green or red bar for each
+// symbol's percent change from the previous day's close.
+
+void ConstructSVGSummaryGraphic(const PF_StreamedSummary &streamed_summary, std::string &svg);
+
+void ConstructSVGSummaryGraphicAndWriteToFile(const PF_StreamedSummary &streamed_summary,
+                                              const fs::path &output_filename);
+
+#endif // ----- #ifndef _CONSTRUCTSVGCHARTGRAPHIC_INC_  -----
@@ -14,9 +14,9 @@
 // =====================================================================================
 
 #include "Eodhd.h"
+#include "StreamedData.h"
 #include "boost/beast/core/buffers_to_string.hpp"
-#include <boost/regex.hpp>
-#include <boost/regex/config.hpp>
+#include <charconv>
 #include <print>
 #include <ranges>
 #include <utility>
@@ -94,109 +94,105 @@ void Eodhd::on_read_subscribe(beast::error_code ec, std::size_t bytes_transferre
 
 Eodhd::PF_Data Eodhd::ExtractStreamedData(const std::string &buffer)
 {
-
-    // response format is 'simple' so we'll use RegExes here too.
-
     // {"s":"TGT","p":141,"c":[14,37,41],"v":1,"dp":false,"ms":"open","t":1706109542329}
 
-    // make referencing the submatch groups more readable
-
-    enum GroupNumber : int
-    {
-        e_all = 0,
-        e_ticker = 1,
-        e_price = 2,
-        e_conditions = 3,
-        e_volume = 4,
-        e_dark_pool = 5,
-        e_mkt_status = 6,
-        e_time = 7
-    };
-
-    // enum GroupNumber
-    // {
-    //     e_all = 0,
-    //     e_ticker = 1,
-    //     e_price = 2,
-    //     e_volume = 3,
-    //     e_mkt_status = 4,
-    //     e_conditions = 5,
-    //     e_dark_pool = 6,
-    //     e_time = 7
-    // };
-
-    static const std::string kResponseString{
-        R"***(\{"s":"(.*)","p":([.0-9]*),"c":(.*),"v":(.*),"dp":(false|true),"ms":"(open|closed|close|extended-hours)?","t":([.0-9]*)\})***"};
-    // static const std::string kResponseString{
-    //     R"***(\{"s":"(.*)","p":([.0-9]*),"v":(.*),"e":(.*),"c":(.*),"dp":(false|true),"t":([.0-9]*)\})***"};
-    static const boost::regex kResponseRegex{kResponseString};
-
-    boost::cmatch fields;
-    const char *response_text = buffer.data();
-
-    PF_Data new_value;
-
-    if (bool matched_it = boost::regex_match(response_text, fields, kResponseRegex); matched_it)
+    // this runs for every message we receive so make one pass over the frame
+    // and work with views into it. Fields may come in any order.
+
+    std::string_view ticker;
+    std::string_view price;
+    std::string_view volume;
+    std::string_view dark_pool;
+    std::string_view mkt_status;
+    std::string_view time_stamp;
+    bool have_mkt_status{false};
+
+    StreamedDataScanner frame{buffer};
+    std::string_view key;
+    std::string_view value;
+    while (frame.NextField(key, value))
     {
-        std::string_view tmp_fld(response_text + fields.position(e_time), fields.length(std::to_underlying(e_time)));
-
-        // EODHD provides timestamp with milliseconds resolution.
-        new_value.time_stamp_ = tmp_fld;
-        // make it into nanoseconds.
-        new_value.time_stamp_.append("000000"sv);
-
-        int64_t time_value{};
-        if (auto [p, ec] = std::from_chars(new_value.time_stamp_.data(),
-                                           new_value.time_stamp_.data() + new_value.time_stamp_.size(), time_value);
-            ec != std::errc())
+        if (key == "s")
         {
-            throw std::runtime_error(std::format("Problem converting transaction timestamp to int64: {}\n",
-                                                 std::make_error_code(ec).message()));
+            ticker = value;
         }
-        new_value.time_stamp_nanoseconds_utc_ = UTC_TmPt_NanoSecs{std::chrono::nanoseconds{time_value}};
-
-        new_value.ticker_ =
-            std::string_view(response_text + fields.position(e_ticker), fields.length(std::to_underlying(e_ticker)));
-
-        tmp_fld =
-            std::string_view(response_text + fields.position(e_price), fields.length(std::to_underlying(e_price)));
-        new_value.last_price_ = decimal::Decimal{std::string{tmp_fld}};
-
-        tmp_fld =
-            std::string_view(response_text + fields.position(e_volume), fields.length(std::to_underlying(e_volume)));
-        if (auto [p, ec] = std::from_chars(tmp_fld.begin(), tmp_fld.end(), new_value.last_size_); ec != std::errc())
+        else if (key == "p")
         {
-            throw std::runtime_error(std::format("Problem converting transaction volume to int64: {}\n",
-                                                 std::make_error_code(ec).message()));
+            price = value;
         }
-
-        tmp_fld = std::string_view(response_text + fields.position(e_dark_pool),
-                                   fields.length(std::to_underlying(e_dark_pool)));
-        new_value.dark_pool_ = tmp_fld == "true";
-
-        tmp_fld = std::string_view(response_text + fields.position(e_mkt_status),
-                                   fields.length(std::to_underlying(e_mkt_status)));
-
-        if (tmp_fld == "open")
+        else if (key == "v")
         {
-            new_value.market_status_ = EodMktStatus::e_open;
+            volume = value;
         }
-        else if (tmp_fld == "closed")
+        else if (key == "dp")
         {
-            new_value.market_status_ = EodMktStatus::e_closed;
+            dark_pool = value;
         }
-        else if (tmp_fld == "extended-hours")
+        else if (key == "ms")
         {
-            new_value.market_status_ = EodMktStatus::e_extended_hours;
+            mkt_status = value;
+            have_mkt_status = true;
         }
-        else
+        else if (key == "t")
         {
-            new_value.market_status_ = EodMktStatus::e_unknown;
+            time_stamp = value;
         }
     }
-    else
+
+    PF_Data new_value;
+
+    const auto last_price = StreamedDecimal(price);
+    if (frame.Failed() || ticker.empty() || !last_price || volume.empty() || time_stamp.empty() ||
+        (dark_pool != "true" && dark_pool != "false") || !have_mkt_status)
     {
         spdlog::error(std::format("can't parse transaction buffer: ->{}<-", buffer));
+        return new_value;
+    }
+
+    // EODHD provides timestamp with milliseconds resolution.
+
+    int64_t time_value{};
+    if (auto [p, ec] = std::from_chars(time_stamp.data(), time_stamp.data() + time_stamp.size(), time_value);
+        ec != std::errc() || p != time_stamp.data() + time_stamp.size())
+    {
+        throw std::runtime_error(std::format("Problem converting transaction timestamp to int64: {}\n",
+                                             std::make_error_code(ec).message()));
+    }
+
+    // make it into nanoseconds.
+
+    new_value.time_stamp_ = time_stamp;
+    new_value.time_stamp_.append("000000"sv);
+    new_value.time_stamp_nanoseconds_utc_ =
+        UTC_TmPt_NanoSecs{std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::milliseconds{time_value})};
+
+    new_value.ticker_ = StreamedString(ticker);
+    new_value.last_price_ = *last_price;
+
+    if (auto [p, ec] = std::from_chars(volume.data(), volume.data() + volume.size(), new_value.last_size_);
+        ec != std::errc())
+    {
+        throw std::runtime_error(std::format("Problem converting transaction volume to int64: {}\n",
+                                             std::make_error_code(ec).message()));
+    }
+
+    new_value.dark_pool_ = dark_pool == "true";
+
+    if (mkt_status == "open")
+    {
+        new_value.market_status_ = EodMktStatus::e_open;
+    }
+    else if (mkt_status == "closed")
+    {
+        new_value.market_status_ = EodMktStatus::e_closed;
+    }
+    else if (mkt_status == "extended-hours")
+    {
+        new_value.market_status_ = EodMktStatus::e_extended_hours;
+    }
+    else
+    {
+        new_value.market_status_ = EodMktStatus::e_unknown;
     }
 
     return new_value;
@@ -207,11 +203,7 @@ void Eodhd::StopStreaming(StreamerContext &streamer_context)
 
     // tell our extractor code we are really done
 
-    {
-        std::lock_guard<std::mutex> lock(streamer_context.mtx_);
-        streamer_context.done_ = true;
-    }
-    streamer_context.cv_.notify_one();
+    streamer_context.streamed_data_.Close();
 
     // we need to send the unsubscribe message in a separate connection.
 
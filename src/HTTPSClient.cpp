@@ -0,0 +1,162 @@
+// =====================================================================================
+//       Filename:  HTTPSClient.cpp
+//    Description:  synchronous HTTPS GET client which keeps its connection (and TLS
+//                  session) between requests
+// =====================================================================================
+
+#include "HTTPSClient.h"
+
+#include <chrono>
+#include <format>
+#include <utility>
+
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/beast/version.hpp>
+
+#include <spdlog/spdlog.h>
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace net = boost::asio;
+namespace ssl = boost::asio::ssl;
+
+HTTPSClient::HTTPSClient(std::string host, std::string port)
+    : ctx_{ssl::context::tlsv12_client}, resolver_{ioc_}, host_{std::move(host)}, port_{std::move(port)}
+{
+    // without client caching on, OpenSSL doesn't keep the TLS 1.3 tickets needed to resume.
+    // We hang on to the session ourselves (SaveSession) so nothing is ever looked up in it.
+
+    SSL_CTX_set_session_cache_mode(ctx_.native_handle(), SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+}
+
+HTTPSClient::~HTTPSClient()
+{
+    Disconnect();
+    if (session_ != nullptr)
+    {
+        SSL_SESSION_free(session_);
+    }
+}
+
+std::string HTTPSClient::Get(const std::string &target)
+{
+    const bool reusing = stream_.has_value();
+    try
+    {
+        return DoGet(target);
+    }
+    catch (const beast::system_error &e)
+    {
+        // the server can close an idle connection at any time. We only find out when we use it.
+
+        if (!reusing)
+        {
+            throw;
+        }
+        spdlog::debug(std::format("Kept alive connection to: {} failed: {}. Reconnecting.", host_, e.what()));
+        Disconnect();
+        return DoGet(target);
+    }
+}
+
+std::string HTTPSClient::DoGet(const std::string &target)
+{
+    if (!stream_)
+    {
+        Connect();
+    }
+
+    http::request<http::string_body> req{http::verb::get, target, 11};
+    req.set(http::field::host, host_);
+    req.set(http::field::user_agent, BOOST_BEAST_VERSION_STRING);
+    req.keep_alive(true);
+
+    beast::get_lowest_layer(*stream_).expires_after(std::chrono::seconds(30));
+    http::write(*stream_, req);
+
+    http::response<http::string_body> res;
+    http::read(*stream_, buffer_, res);
+
+    if (!session_saved_)
+    {
+        SaveSession();
+    }
+    if (!res.keep_alive())
+    {
+        Disconnect();
+    }
+    return std::move(res.body());
+}
+
+void HTTPSClient::Connect()
+{
+    stream_.emplace(ioc_, ctx_);
+    buffer_.clear();
+
+    if (!SSL_set_tlsext_host_name(stream_->native_handle(), host_.c_str()))
+    {
+        throw beast::system_error{
+            beast::error_code(static_cast<int>(::ERR_get_error()), net::error::get_ssl_category())};
+    }
+    if (session_ != nullptr)
+    {
+        SSL_set_session(stream_->native_handle(), session_);
+    }
+
+    if (!endpoints_)
+    {
+        endpoints_ = resolver_.resolve(host_, port_);
+    }
+    beast::get_lowest_layer(*stream_).expires_after(std::chrono::seconds(30));
+    beast::get_lowest_layer(*stream_).connect(*endpoints_);
+    stream_->handshake(ssl::stream_base::client);
+
+    ++connections_;
+    if (SSL_session_reused(stream_->native_handle()) == 1)
+    {
+        ++resumed_sessions_;
+    }
+    session_saved_ = false;
+}
+
+void HTTPSClient::SaveSession()
+{
+    // TLS 1.3 servers send session tickets after the handshake so we can't do this
+    // until we've read something.
+
+    session_saved_ = true;
+    auto *session = SSL_get1_session(stream_->native_handle());
+    if (session == nullptr)
+    {
+        return;
+    }
+    if (SSL_SESSION_is_resumable(session) != 1)
+    {
+        SSL_SESSION_free(session);
+        return;
+    }
+    if (session_ != nullptr)
+    {
+        SSL_SESSION_free(session_);
+    }
+    session_ = session;
+}
+
+void HTTPSClient::Disconnect()
+{
+    if (!stream_)
+    {
+        return;
+    }
+
+    // no TLS shutdown. We'd only wait for the server to answer a connection we're done with.
+    // Tell OpenSSL it happened anyway or it marks the session as not resumable.
+
+    SSL_set_shutdown(stream_->native_handle(), SSL_SENT_SHUTDOWN | SSL_RECEIVED_SHUTDOWN);
+
+    beast::error_code ec;
+    beast::get_lowest_layer(*stream_).socket().shutdown(net::ip::tcp::socket::shutdown_both, ec);
+    beast::get_lowest_layer(*stream_).close();
+    stream_.reset();
+}
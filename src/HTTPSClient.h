@@ -0,0 +1,76 @@
+// =====================================================================================
+//       Filename:  HTTPSClient.h
+//    Description:  synchronous HTTPS GET client which keeps its connection (and TLS
+//                  session) between requests
+// =====================================================================================
+
+#ifndef _HTTPSCLIENT_INC_
+#define _HTTPSCLIENT_INC_
+
+#include <optional>
+#include <string>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/ssl.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/core/tcp_stream.hpp>
+#include <boost/beast/ssl/ssl_stream.hpp>
+
+// =====================================================================================
+//        Class:  HTTPSClient
+//  Description:  1 connection to 1 host, reused for as long as the server keeps it open.
+//
+//  A new connection (server closed it, or it went stale) resumes the previous TLS
+//  session when the server allows it so it costs 1 round trip, not 2, and no key
+//  exchange. A request on a reused connection which fails before any response is
+//  retried once on a new connection.
+//
+//  Not thread safe. Use 1 per thread.
+// =====================================================================================
+
+class HTTPSClient
+{
+public:
+    HTTPSClient(std::string host, std::string port);
+
+    HTTPSClient() = delete;
+    HTTPSClient(const HTTPSClient &) = delete;
+    HTTPSClient(HTTPSClient &&) = delete;
+    ~HTTPSClient();
+
+    HTTPSClient &operator=(const HTTPSClient &) = delete;
+    HTTPSClient &operator=(HTTPSClient &&) = delete;
+
+    // 'target' can be a path or a full URL. Returns the response body.
+
+    std::string Get(const std::string &target);
+
+    // for the curious: how many connections and how many of them resumed a TLS session.
+
+    [[nodiscard]] int32_t Connections() const { return connections_; }
+    [[nodiscard]] int32_t ResumedSessions() const { return resumed_sessions_; }
+
+private:
+    void Connect();
+    void Disconnect();
+    void SaveSession();
+    std::string DoGet(const std::string &target);
+
+    boost::asio::io_context ioc_;
+    boost::asio::ssl::context ctx_;
+    boost::asio::ip::tcp::resolver resolver_;
+    std::optional<boost::asio::ip::tcp::resolver::results_type> endpoints_;
+    std::optional<boost::beast::ssl_stream<boost::beast::tcp_stream>> stream_;
+    boost::beast::flat_buffer buffer_;
+    SSL_SESSION *session_ = nullptr;
+    bool session_saved_ = false; // for this connection
+
+    const std::string host_;
+    const std::string port_;
+
+    int32_t connections_ = 0;
+    int32_t resumed_sessions_ = 0;
+};
+
+#endif
@@ -64,8 +64,11 @@ PF_Chart::PF_Chart(const PF_Chart &rhs)
       symbol_{rhs.symbol_}, chart_base_name_{rhs.chart_base_name_}, base_box_size_{rhs.base_box_size_},
       fname_box_size_{rhs.fname_box_size_}, box_size_modifier_{rhs.box_size_modifier_}, first_date_{rhs.first_date_},
       last_change_date_{rhs.last_change_date_}, last_checked_date_{rhs.last_checked_date_}, y_min_{rhs.y_min_},
-      y_max_{rhs.y_max_}, current_direction_{rhs.current_direction_},
-      max_columns_for_graph_{rhs.max_columns_for_graph_}, last_change_was_reversal_{rhs.last_change_was_reversal_}
+      y_max_{rhs.y_max_}, current_direction_{rhs.current_direction_}, trend_lines_{rhs.trend_lines_},
+      trend_extreme_box_{rhs.trend_extreme_box_}, trend_extreme_column_{rhs.trend_extreme_column_},
+      congestion_{rhs.congestion_}, max_columns_for_graph_{rhs.max_columns_for_graph_},
+      last_change_was_reversal_{rhs.last_change_was_reversal_},
+      last_change_breached_trend_line_{rhs.last_change_breached_trend_line_}
 
 {
     // now, the reason for doing this explicitly is to fix the column box
@@ -88,8 +91,11 @@ PF_Chart::PF_Chart(PF_Chart &&rhs) noexcept
       fname_box_size_{std::move(rhs.fname_box_size_)}, box_size_modifier_{std::move(rhs.box_size_modifier_)},
       first_date_{rhs.first_date_}, last_change_date_{rhs.last_change_date_},
       last_checked_date_{rhs.last_checked_date_}, y_min_{std::move(rhs.y_min_)}, y_max_{std::move(rhs.y_max_)},
-      current_direction_{rhs.current_direction_}, max_columns_for_graph_{rhs.max_columns_for_graph_},
-      last_change_was_reversal_{rhs.last_change_was_reversal_}
+      current_direction_{rhs.current_direction_}, trend_lines_{std::move(rhs.trend_lines_)},
+      trend_extreme_box_{std::move(rhs.trend_extreme_box_)}, trend_extreme_column_{rhs.trend_extreme_column_},
+      congestion_{std::move(rhs.congestion_)}, max_columns_for_graph_{rhs.max_columns_for_graph_},
+      last_change_was_reversal_{rhs.last_change_was_reversal_},
+      last_change_breached_trend_line_{rhs.last_change_breached_trend_line_}
 
 {
     // now, the reason for doing this explicitly is to fix the column box
@@ -188,8 +194,13 @@ PF_Chart &PF_Chart::operator=(const PF_Chart &rhs)
         y_min_ = rhs.y_min_;
         y_max_ = rhs.y_max_;
         current_direction_ = rhs.current_direction_;
+        trend_lines_ = rhs.trend_lines_;
+        trend_extreme_box_ = rhs.trend_extreme_box_;
+        trend_extreme_column_ = rhs.trend_extreme_column_;
+        congestion_ = rhs.congestion_;
         max_columns_for_graph_ = rhs.max_columns_for_graph_;
         last_change_was_reversal_ = rhs.last_change_was_reversal_;
+        last_change_breached_trend_line_ = rhs.last_change_breached_trend_line_;
 
         // now, the reason for doing this explicitly is to fix the column box
         // pointers.
@@ -219,8 +230,13 @@ PF_Chart &PF_Chart::operator=(PF_Chart &&rhs) noexcept
         y_min_ = std::move(rhs.y_min_);
         y_max_ = std::move(rhs.y_max_);
         current_direction_ = rhs.current_direction_;
+        trend_lines_ = std::move(rhs.trend_lines_);
+        trend_extreme_box_ = std::move(rhs.trend_extreme_box_);
+        trend_extreme_column_ = rhs.trend_extreme_column_;
+        congestion_ = std::move(rhs.congestion_);
         max_columns_for_graph_ = rhs.max_columns_for_graph_;
         last_change_was_reversal_ = rhs.last_change_was_reversal_;
+        last_change_breached_trend_line_ = rhs.last_change_breached_trend_line_;
 
         // now, the reason for doing this explicitly is to fix the column box
         // pointers.
@@ -283,6 +299,14 @@ bool PF_Chart::operator==(const PF_Chart &rhs) const
     {
         return false;
     }
+    if (trend_lines_ != rhs.trend_lines_)
+    {
+        return false;
+    }
+    if (congestion_ != rhs.congestion_)
+    {
+        return false;
+    }
 
     return true;
 } // -----  end of method PF_Chart::operator==  -----
@@ -311,6 +335,7 @@ PF_Column::Status PF_Chart::AddValue(const decimal::Decimal &new_value, PF_Colum
     auto [status, new_col] = current_column_.AddValue(new_value, the_time);
 
     last_change_was_reversal_ = false;
+    last_change_breached_trend_line_ = false;
 
     if (status == PF_Column::Status::e_Accepted)
     {
@@ -328,6 +353,7 @@ PF_Column::Status PF_Chart::AddValue(const decimal::Decimal &new_value, PF_Colum
         // the_time); had_signal)
         if (auto found_signal = LookForNewSignal(*this, new_value, the_time); found_signal)
         {
+            SetPriceObjectives(found_signal.value());
             AddSignal(found_signal.value());
             status = PF_Column::Status::e_AcceptedWithSignal;
         }
@@ -335,6 +361,7 @@ PF_Column::Status PF_Chart::AddValue(const decimal::Decimal &new_value, PF_Colum
     else if (status == PF_Column::Status::e_Reversal)
     {
         columns_.push_back(current_column_);
+        UpdateCongestion(columns_.back(), columns_.size() < 2 ? nullptr : &columns_[columns_.size() - 2]);
         current_column_ = std::move(new_col.value());
 
         // now continue on processing the value.
@@ -347,15 +374,202 @@ PF_Column::Status PF_Chart::AddValue(const decimal::Decimal &new_value, PF_Colum
         // the_time); found_signal)
         if (auto found_signal = LookForNewSignal(*this, new_value, the_time); found_signal)
         {
+            SetPriceObjectives(found_signal.value());
             AddSignal(found_signal.value());
             status = PF_Column::Status::e_AcceptedWithSignal;
         }
     }
+    if (status != PF_Column::Status::e_Ignored)
+    {
+        UpdateTrendLines(current_column_, columns_.empty() ? nullptr : &columns_.back(), the_time);
+        UpdateVerticalObjectives();
+    }
     current_direction_ = current_column_.GetDirection();
     last_checked_date_ = the_time;
     return status;
 } // -----  end of method PF_Chart::AddValue  -----
 
+void PF_Chart::UpdateTrendLines(const PF_Column &col, const PF_Column *prev_col, PF_Column::TmPt the_time)
+{
+    const auto col_nbr = col.GetColumnNumber();
+    const bool up = col.GetDirection() == PF_Column::Direction::e_Up;
+    const bool down = col.GetDirection() == PF_Column::Direction::e_Down;
+
+    if (trend_lines_.empty())
+    {
+        // the 1st reversal gives us a high or low to start from.
+
+        if (prev_col == nullptr || (!up && !down))
+        {
+            return;
+        }
+        if (up)
+        {
+            StartTrendLine(PF_TrendLineKind::e_bullish_support, prev_col->GetColumnNumber(), prev_col->GetBottom());
+        }
+        else
+        {
+            StartTrendLine(PF_TrendLineKind::e_bearish_resistance, prev_col->GetColumnNumber(), prev_col->GetTop());
+        }
+    }
+
+    // support is breached by O's and resistance by X's reaching the line. Otherwise keep
+    // track of the high (low) to start the next line from.
+
+    auto &line = trend_lines_.back();
+    const bool support = line.kind_ == PF_TrendLineKind::e_bullish_support;
+    const bool breached = support ? down && boxes_.BoxIndex(col.GetBottom()) <= TrendLineBoxIndex(line, col_nbr)
+                                  : up && boxes_.BoxIndex(col.GetTop()) >= TrendLineBoxIndex(line, col_nbr);
+    if (breached)
+    {
+        line.breach_column_ = col_nbr;
+        line.breach_time_ = the_time;
+        line.breach_box_ = support ? col.GetBottom() : col.GetTop();
+        last_change_breached_trend_line_ = true;
+
+        StartTrendLine(support ? PF_TrendLineKind::e_bearish_resistance : PF_TrendLineKind::e_bullish_support,
+                       trend_extreme_column_, trend_extreme_box_);
+
+        // the new line's low (high) so far is the breaching column's.
+
+        trend_extreme_box_ = support ? col.GetBottom() : col.GetTop();
+        trend_extreme_column_ = col_nbr;
+    }
+    else if (support ? col.GetTop() > trend_extreme_box_ : col.GetBottom() < trend_extreme_box_)
+    {
+        trend_extreme_box_ = support ? col.GetTop() : col.GetBottom();
+        trend_extreme_column_ = col_nbr;
+    }
+} // -----  end of method PF_Chart::UpdateTrendLines  -----
+
+void PF_Chart::StartTrendLine(PF_TrendLineKind kind, int32_t start_column, decimal::Decimal start_box)
+{
+    trend_lines_.push_back({.kind_ = kind,
+                            .start_column_ = start_column,
+                            .start_box_ = start_box,
+                            .breach_column_ = -1,
+                            .breach_time_ = {},
+                            .breach_box_ = -1});
+    trend_extreme_box_ = std::move(start_box);
+    trend_extreme_column_ = start_column;
+} // -----  end of method PF_Chart::StartTrendLine  -----
+
+int64_t PF_Chart::TrendLineBoxIndex(const PF_TrendLine &line, int32_t column_number) const
+{
+    const int64_t columns_along = column_number - line.start_column_;
+    if (line.kind_ == PF_TrendLineKind::e_bullish_support)
+    {
+        return boxes_.BoxIndex(line.start_box_) - 1 + columns_along;
+    }
+    return boxes_.BoxIndex(line.start_box_) + 1 - columns_along;
+} // -----  end of method PF_Chart::TrendLineBoxIndex  -----
+
+void PF_Chart::UpdateCongestion(const PF_Column &col, const PF_Column *prev_col)
+{
+    const auto &bottom = col.GetBottom();
+    const auto &top = col.GetTop();
+
+    if (congestion_.columns_ > 0 && bottom <= congestion_.common_high_ && top >= congestion_.common_low_)
+    {
+        congestion_.columns_ += 1;
+        congestion_.common_low_ = std::max(congestion_.common_low_, bottom);
+        congestion_.common_high_ = std::min(congestion_.common_high_, top);
+        congestion_.low_ = std::min(congestion_.low_, bottom);
+        congestion_.high_ = std::max(congestion_.high_, top);
+        return;
+    }
+
+    // nothing in common with the old congestion. It's over and a new one starts with this
+    // column and, if they overlap, the one before.
+
+    if (prev_col != nullptr && bottom <= prev_col->GetTop() && top >= prev_col->GetBottom())
+    {
+        congestion_ = {.columns_ = 2,
+                       .common_low_ = std::max(bottom, prev_col->GetBottom()),
+                       .common_high_ = std::min(top, prev_col->GetTop()),
+                       .low_ = std::min(bottom, prev_col->GetBottom()),
+                       .high_ = std::max(top, prev_col->GetTop())};
+        return;
+    }
+    congestion_ = {.columns_ = 1, .common_low_ = bottom, .common_high_ = top, .low_ = bottom, .high_ = top};
+} // -----  end of method PF_Chart::UpdateCongestion  -----
+
+void PF_Chart::SetPriceObjectives(PF_Signal &new_sig) const
+{
+    new_sig.vertical_objective_ = VerticalObjective(new_sig.signal_category_);
+    new_sig.horizontal_objective_ = HorizontalObjective(new_sig.signal_category_);
+} // -----  end of method PF_Chart::SetPriceObjectives  -----
+
+void PF_Chart::UpdateVerticalObjectives()
+{
+    // signals are in column order so the current column's are at the end.
+
+    for (auto &sig : signals_ | vws::reverse)
+    {
+        if (sig.column_number_ != current_column_.GetColumnNumber())
+        {
+            break;
+        }
+        sig.vertical_objective_ = VerticalObjective(sig.signal_category_);
+    }
+} // -----  end of method PF_Chart::UpdateVerticalObjectives  -----
+
+decimal::Decimal PF_Chart::VerticalObjective(PF_SignalCategory category) const
+{
+    const auto bottom_ndx = boxes_.BoxIndex(current_column_.GetBottom());
+    const auto top_ndx = boxes_.BoxIndex(current_column_.GetTop());
+    const auto count = (top_ndx - bottom_ndx + 1) * current_column_.GetReversalboxes();
+
+    if (category == PF_SignalCategory::e_PF_Buy)
+    {
+        return boxes_.BoxAtIndex(bottom_ndx + count);
+    }
+    if (category == PF_SignalCategory::e_PF_Sell)
+    {
+        // can't go below nothing.
+
+        auto objective = boxes_.BoxAtIndex(top_ndx - count);
+        return objective > 0 ? objective : decimal::Decimal{-1};
+    }
+    return -1;
+} // -----  end of method PF_Chart::VerticalObjective  -----
+
+decimal::Decimal PF_Chart::HorizontalObjective(PF_SignalCategory category) const
+{
+    const auto columns = congestion_.columns_ + 1; // the breakout column counts too
+    if (congestion_.columns_ == 0 || columns < PF_Congestion::kMinColumns)
+    {
+        return -1;
+    }
+    const auto count = static_cast<int64_t>(columns) * current_column_.GetReversalboxes();
+
+    if (category == PF_SignalCategory::e_PF_Buy)
+    {
+        return boxes_.BoxAtIndex(boxes_.BoxIndex(congestion_.low_) + count);
+    }
+    if (category == PF_SignalCategory::e_PF_Sell)
+    {
+        auto objective = boxes_.BoxAtIndex(boxes_.BoxIndex(congestion_.high_) - count);
+        return objective > 0 ? objective : decimal::Decimal{-1};
+    }
+    return -1;
+} // -----  end of method PF_Chart::HorizontalObjective  -----
+
+std::optional<int64_t> PF_Chart::BoxesFromTrendLine() const
+{
+    const auto line = GetCurrentTrendLine();
+    if (!line)
+    {
+        return {};
+    }
+    const auto line_ndx = TrendLineBoxIndex(*line, current_column_.GetColumnNumber());
+    if (line->kind_ == PF_TrendLineKind::e_bullish_support)
+    {
+        return boxes_.BoxIndex(current_column_.GetBottom()) - line_ndx;
+    }
+    return line_ndx - boxes_.BoxIndex(current_column_.GetTop());
+} // -----  end of method PF_Chart::BoxesFromTrendLine  -----
+
 std::optional<StreamedPrices> PF_Chart::BuildChartFromCSVStream(std::istream *input_data, std::string_view date_format,
                                                                 std::string_view delim,
                                                                 PF_CollectAndReturnStreamedPrices return_streamed_data)
@@ -592,6 +806,7 @@ void PF_Chart::ConvertChartToJsonAndWriteToFile(const fs::path &output_filename)
     BOOST_ASSERT_MSG(out.is_open(), std::format("Unable to open file: {} for chart output.", output_filename).c_str());
     ConvertChartToJsonAndWriteToStream(out);
     out.close();
+    BOOST_ASSERT_MSG(!out.fail(), std::format("Unable to write chart output to: {}.", output_filename).c_str());
 } // -----  end of method PF_Chart::ConvertChartToJsonAndWriteToFile  -----
 
 void PF_Chart::ConvertChartToJsonAndWriteToStream(std::ostream &stream) const
@@ -610,6 +825,7 @@ void PF_Chart::ConvertChartToTableAndWriteToFile(const fs::path &output_filename
                      std::format("Unable to open file: {} for graphics data output.", output_filename).c_str());
     ConvertChartToTableAndWriteToStream(out);
     out.close();
+    BOOST_ASSERT_MSG(!out.fail(), std::format("Unable to write graphics data output to: {}.", output_filename).c_str());
 } // -----  end of method PF_Chart::ConvertChartToTableAndWriteToFile  -----
 
 void PF_Chart::ConvertChartToTableAndWriteToStream(std::ostream &stream, X_AxisFormat date_or_time) const
@@ -702,6 +918,16 @@ Json::Value PF_Chart::ToJSON() const
     }
     result["signals"] = signals;
 
+    Json::Value trend_lines{Json::arrayValue};
+    for (const auto &line : trend_lines_)
+    {
+        trend_lines.append(PF_TrendLineToJSON(line));
+    }
+    result["trend_lines"] = trend_lines;
+    result["trend_extreme_box"] = trend_extreme_box_.format("f");
+    result["trend_extreme_column"] = trend_extreme_column_;
+    result["congestion"] = PF_CongestionToJSON(congestion_);
+
     result["first_date"] = first_date_.time_since_epoch().count();
     result["last_change_date"] = last_change_date_.time_since_epoch().count();
     result["last_check_date"] = last_checked_date_.time_since_epoch().count();
@@ -729,6 +955,7 @@ Json::Value PF_Chart::ToJSON() const
     };
     result["max_columns"] = max_columns_for_graph_;
     result["last_change_was_reversal"] = last_change_was_reversal_;
+    result["last_change_breached_trend_line"] = last_change_breached_trend_line_;
 
     Json::Value cols{Json::arrayValue};
     for (const auto &col : columns_)
@@ -800,8 +1027,127 @@ void PF_Chart::FromJSON(const Json::Value &new_data)
     rng::for_each(cols, [this](const auto &next_val) { this->columns_.emplace_back(&boxes_, next_val); });
 
     current_column_ = PF_Column{&boxes_, new_data["current_column"]};
+
+    trend_lines_.clear();
+    if (new_data.isMember("trend_lines"))
+    {
+        rng::for_each(new_data["trend_lines"],
+                      [this](const auto &next_val) { this->trend_lines_.push_back(PF_TrendLineFromJSON(next_val)); });
+        trend_extreme_box_ = decimal::Decimal{new_data["trend_extreme_box"].asCString()};
+        trend_extreme_column_ = new_data["trend_extreme_column"].asInt();
+    }
+    else
+    {
+        // saved before we kept trend lines. Work them out from the columns this once.
+
+        trend_extreme_box_ = -1;
+        trend_extreme_column_ = -1;
+        for (size_t ndx = 0; ndx < size(); ++ndx)
+        {
+            const auto &col = (*this)[ndx];
+            UpdateTrendLines(col, ndx == 0 ? nullptr : &(*this)[ndx - 1], col.GetTimeSpan().second);
+        }
+    }
+    last_change_breached_trend_line_ = new_data.isMember("last_change_breached_trend_line") &&
+                                       new_data["last_change_breached_trend_line"].asBool();
+
+    if (new_data.isMember("congestion"))
+    {
+        congestion_ = PF_CongestionFromJSON(new_data["congestion"]);
+    }
+    else
+    {
+        // same for the congestion, only completed columns are part of it.
+
+        congestion_ = {};
+        for (size_t ndx = 0; ndx < columns_.size(); ++ndx)
+        {
+            UpdateCongestion(columns_[ndx], ndx == 0 ? nullptr : &columns_[ndx - 1]);
+        }
+    }
 } // -----  end of method PF_Chart::FromJSON  -----
 
+Json::Value PF_CongestionToJSON(const PF_Congestion &congestion)
+{
+    Json::Value result;
+    result["columns"] = congestion.columns_;
+    result["common_low"] = congestion.common_low_.format("f");
+    result["common_high"] = congestion.common_high_.format("f");
+    result["low"] = congestion.low_.format("f");
+    result["high"] = congestion.high_.format("f");
+
+    return result;
+} // -----  end of method PF_CongestionToJSON  -----
+
+PF_Congestion PF_CongestionFromJSON(const Json::Value &new_data)
+{
+    PF_Congestion congestion;
+    congestion.columns_ = new_data["columns"].asInt();
+    congestion.common_low_ = decimal::Decimal{new_data["common_low"].asCString()};
+    congestion.common_high_ = decimal::Decimal{new_data["common_high"].asCString()};
+    congestion.low_ = decimal::Decimal{new_data["low"].asCString()};
+    congestion.high_ = decimal::Decimal{new_data["high"].asCString()};
+
+    return congestion;
+} // -----  end of method PF_CongestionFromJSON  -----
+
+Json::Value PF_TrendLineToJSON(const PF_TrendLine &line)
+{
+    Json::Value result;
+    switch (line.kind_)
+    {
+        using enum PF_TrendLineKind;
+        case e_none:
+            result["kind"] = "none";
+            break;
+
+        case e_bullish_support:
+            result["kind"] = "support";
+            break;
+
+        case e_bearish_resistance:
+            result["kind"] = "resistance";
+            break;
+    };
+    result["start_column"] = line.start_column_;
+    result["start_box"] = line.start_box_.format("f");
+    result["breach_column"] = line.breach_column_;
+    result["breach_time"] = line.breach_time_.time_since_epoch().count();
+    result["breach_box"] = line.breach_box_.format("f");
+
+    return result;
+} // -----  end of method PF_TrendLineToJSON  -----
+
+PF_TrendLine PF_TrendLineFromJSON(const Json::Value &new_data)
+{
+    PF_TrendLine line;
+
+    if (const auto kind = new_data["kind"].asString(); kind == "support")
+    {
+        line.kind_ = PF_TrendLineKind::e_bullish_support;
+    }
+    else if (kind == "resistance")
+    {
+        line.kind_ = PF_TrendLineKind::e_bearish_resistance;
+    }
+    else if (kind == "none")
+    {
+        line.kind_ = PF_TrendLineKind::e_none;
+    }
+    else
+    {
+        throw std::invalid_argument{
+            std::format("Invalid trend line kind provided: {}. Must be 'support', 'resistance' or 'none'.", kind)};
+    }
+    line.start_column_ = new_data["start_column"].asInt();
+    line.start_box_ = decimal::Decimal{new_data["start_box"].asCString()};
+    line.breach_column_ = new_data["breach_column"].asInt();
+    line.breach_time_ = PF_Column::TmPt{std::chrono::nanoseconds{new_data["breach_time"].asInt64()}};
+    line.breach_box_ = decimal::Decimal{new_data["breach_box"].asCString()};
+
+    return line;
+} // -----  end of method PF_TrendLineFromJSON  -----
+
 // ===  FUNCTION
 // ======================================================================
 //         Name:  ComputeATR
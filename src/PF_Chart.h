@@ -81,6 +81,67 @@ enum class X_AxisFormat : int32_t
     e_show_time
 };
 
+enum class GraphicsRenderer : int32_t
+{
+    e_chartdirector,
+    e_native
+};
+
+// du Plessis' 45 degree trend lines. A bullish support line starts 1 box below the low
+// of a decline and rises 1 box per column. A bearish resistance line starts 1 box above
+// the high of a rally and falls 1 box per column. A column of O's reaching the support
+// line (X's reaching the resistance line) breaches it and the opposite line is started
+// from the high (low) made while the breached line was in force.
+
+enum class PF_TrendLineKind : int32_t
+{
+    e_none,
+    e_bullish_support,
+    e_bearish_resistance
+};
+
+struct PF_TrendLine
+{
+    PF_TrendLineKind kind_ = PF_TrendLineKind::e_none;
+    int32_t start_column_ = -1;
+    decimal::Decimal start_box_ = -1; // the low (high) the line is drawn from, not the line's 1st box
+    int32_t breach_column_ = -1;      // -1 while in force
+    PF_Column::TmPt breach_time_ = {};
+    decimal::Decimal breach_box_ = -1; // column's bottom (top) when it reached the line
+
+    [[nodiscard]] bool InForce() const
+    {
+        return kind_ != PF_TrendLineKind::e_none && breach_column_ < 0;
+    }
+
+    bool operator==(const PF_TrendLine &rhs) const = default;
+};
+
+using PF_TrendLineList = std::vector<PF_TrendLine>;
+
+[[nodiscard]] Json::Value PF_TrendLineToJSON(const PF_TrendLine &line);
+[[nodiscard]] PF_TrendLine PF_TrendLineFromJSON(const Json::Value &new_data);
+
+// the congestion (trading range) the last completed column is part of: the run of
+// columns, ending with it, which all have at least 1 row in common. Horizontal counts
+// are taken across it when a signal breaks out of it.
+
+struct PF_Congestion
+{
+    static constexpr int32_t kMinColumns = 3; // counting the breakout column
+
+    int32_t columns_ = 0;
+    decimal::Decimal common_low_ = -1; // the rows all the columns share
+    decimal::Decimal common_high_ = -1;
+    decimal::Decimal low_ = -1; // lowest bottom and highest top of the columns
+    decimal::Decimal high_ = -1;
+
+    bool operator==(const PF_Congestion &rhs) const = default;
+};
+
+[[nodiscard]] Json::Value PF_CongestionToJSON(const PF_Congestion &congestion);
+[[nodiscard]] PF_Congestion PF_CongestionFromJSON(const Json::Value &new_data);
+
 class PF_Chart
 {
 public:
@@ -297,6 +358,41 @@ public:
         return signals_;
     }
 
+    // all the trend lines drawn so far, oldest first. Only the last can be in force.
+
+    [[nodiscard]] const PF_TrendLineList &GetTrendLines() const
+    {
+        return trend_lines_;
+    }
+    [[nodiscard]] std::optional<PF_TrendLine> GetCurrentTrendLine() const
+    {
+        return (!trend_lines_.empty() && trend_lines_.back().InForce() ? trend_lines_.back()
+                                                                        : std::optional<PF_TrendLine>{std::nullopt});
+    }
+
+    // where a line is in a column, as a box index (see Boxes::BoxIndex) or a price for drawing.
+
+    [[nodiscard]] int64_t TrendLineBoxIndex(const PF_TrendLine &line, int32_t column_number) const;
+    [[nodiscard]] double TrendLineValue(const PF_TrendLine &line, int32_t column_number) const
+    {
+        return boxes_.BoxIndexToDbl(TrendLineBoxIndex(line, column_number));
+    }
+
+    // boxes between the current column and the line in force: below (above) it for
+    // support (resistance) this many boxes would reach it.
+
+    [[nodiscard]] std::optional<int64_t> BoxesFromTrendLine() const;
+
+    [[nodiscard]] bool LastChangeBreachedTrendLine() const
+    {
+        return last_change_breached_trend_line_;
+    }
+
+    [[nodiscard]] const PF_Congestion &GetCongestion() const
+    {
+        return congestion_;
+    }
+
     // NOTE: this does NOT include current_column_ so in order to avoid confusion, remove it.
     // ** use the iterator interface to properly access columns **
     // [[nodiscard]] const std::vector<PF_Column> &GetColumns() const { return columns_; }
@@ -348,6 +444,15 @@ public:
     {
         return AddValue(dbl2dec(new_value), PF_Column::TmPt{std::chrono::seconds(the_time)});
     }
+
+    // values strictly inside this range can't change the chart as it is now. Lets a
+    // caller which has fallen behind skip them (see PF_Column::QuietRange).
+
+    [[nodiscard]] std::optional<std::pair<decimal::Decimal, decimal::Decimal>> QuietRange()
+    {
+        return current_column_.QuietRange();
+    }
+
     std::optional<StreamedPrices> BuildChartFromCSVStream(
         std::istream *input_data, std::string_view date_format, std::string_view delim,
         PF_CollectAndReturnStreamedPrices return_streamed_data = PF_CollectAndReturnStreamedPrices::e_no);
@@ -405,6 +510,24 @@ private:
 
     void FromJSON(const Json::Value &new_data);
 
+    // call after every change to the current column. Keeps the high (low) made since the
+    // line in force was started so breaching it needs no look back through the columns.
+
+    void UpdateTrendLines(const PF_Column &col, const PF_Column *prev_col, PF_Column::TmPt the_time);
+    void StartTrendLine(PF_TrendLineKind kind, int32_t start_column, decimal::Decimal start_box);
+
+    // call with each column as it is completed.
+
+    void UpdateCongestion(const PF_Column &col, const PF_Column *prev_col);
+
+    // objectives for a signal in the current column. Vertical counts grow with the column
+    // so they are redone after every change to it.
+
+    void SetPriceObjectives(PF_Signal &new_sig) const;
+    void UpdateVerticalObjectives();
+    [[nodiscard]] decimal::Decimal VerticalObjective(PF_SignalCategory category) const;
+    [[nodiscard]] decimal::Decimal HorizontalObjective(PF_SignalCategory category) const;
+
     // ====================  DATA MEMBERS
     // =======================================
 
@@ -429,8 +552,15 @@ private:
 
     PF_Column::Direction current_direction_ = PF_Column::Direction::e_Unknown;
 
+    PF_TrendLineList trend_lines_;
+    decimal::Decimal trend_extreme_box_ = -1; // high (low) since the line in force started
+    int32_t trend_extreme_column_ = -1;
+
+    PF_Congestion congestion_;
+
     int64_t max_columns_for_graph_ = 0; // how many columns to show in graphic
     bool last_change_was_reversal_ = false;
+    bool last_change_breached_trend_line_ = false;
 
 }; // -----  end of class PF_Chart  -----
 
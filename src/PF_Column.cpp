@@ -260,6 +260,37 @@ PF_Column::AddResult PF_Column::TryToExtendDown(const decimal::Decimal &new_valu
     return {Status::e_Ignored, std::nullopt};
 } // -----  end of method PF_Column::TryToExtendDown  -----
 
+std::optional<std::pair<decimal::Decimal, decimal::Decimal>> PF_Column::QuietRange()
+{
+    // same box tests, in the same order, as TryToExtendUp and TryToExtendDown.
+
+    if (IsEmpty() || direction_ == Direction::e_Unknown)
+    {
+        return std::nullopt;
+    }
+
+    if (direction_ == Direction::e_Up)
+    {
+        Boxes::Box possible_new_top = boxes_->FindNextBox(top_);
+        Boxes::Box possible_new_column_top = boxes_->FindPrevBox(top_);
+
+        for (auto x = reversal_boxes_; x > 1; --x)
+        {
+            possible_new_column_top = boxes_->FindPrevBox(possible_new_column_top);
+        }
+        return std::make_pair(possible_new_column_top, possible_new_top);
+    }
+
+    Boxes::Box possible_new_bottom = boxes_->FindPrevBox(bottom_);
+    Boxes::Box possible_new_column_bottom = boxes_->FindNextBox(bottom_);
+
+    for (auto x = reversal_boxes_; x > 1; --x)
+    {
+        possible_new_column_bottom = boxes_->FindNextBox(possible_new_column_bottom);
+    }
+    return std::make_pair(possible_new_bottom, possible_new_column_bottom);
+} // -----  end of method PF_Column::QuietRange  -----
+
 PF_Column::ColumnBoxes PF_Column::GetColumnBoxes() const
 
 {
@@ -147,6 +147,12 @@ public:
     [[nodiscard]] AddResult AddValue(const decimal::Decimal &new_value, TmPt the_time);
     [[nodiscard]] AddResult AddValue(std::string_view new_value, std::string_view the_time);
 
+    // values strictly between these 2 would be ignored by AddValue given the column as it
+    // is now. Nothing is certain to be ignored until the column has a direction.
+    // Not const because finding the boxes can extend the box list (just as AddValue would).
+
+    [[nodiscard]] std::optional<std::pair<decimal::Decimal, decimal::Decimal>> QuietRange();
+
     // ====================  OPERATORS     =======================================
 
     PF_Column &operator=(const PF_Column &rhs) = default;
@@ -187,6 +187,8 @@ Json::Value PF_SignalToJSON(const PF_Signal &signal)
     result["column"] = signal.column_number_;
     result["price"] = signal.signal_price_.format(".2f");
     result["box"] = signal.box_.format("f");
+    result["vertical_objective"] = signal.vertical_objective_.format("f");
+    result["horizontal_objective"] = signal.horizontal_objective_.format("f");
 
     return result;
 } // -----  end of method PF_SignalToJSON  -----
@@ -271,6 +273,14 @@ PF_Signal PF_SignalFromJSON(const Json::Value &new_data)
     new_sig.signal_price_ = decimal::Decimal{new_data["price"].asString()};
     new_sig.box_ = decimal::Decimal{new_data["box"].asString()};
 
+    // signals saved before there were objectives don't have them.
+
+    if (new_data.isMember("vertical_objective"))
+    {
+        new_sig.vertical_objective_ = decimal::Decimal{new_data["vertical_objective"].asString()};
+        new_sig.horizontal_objective_ = decimal::Decimal{new_data["horizontal_objective"].asString()};
+    }
+
     return new_sig;
 } // -----  end of method PF_SignalFromJSON  -----
 
@@ -21,6 +21,7 @@
 #include <json/json.h>
 
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <format>
 #include <optional>
@@ -59,6 +60,37 @@ enum class PF_SignalType : int32_t
     e_tbottom_catapult_sell
 };
 
+// for tables indexed by signal type
+
+constexpr std::size_t kSignalTypeCount = std::to_underlying(PF_SignalType::e_tbottom_catapult_sell) + 1;
+
+// which side a signal type is on. No default so a new type must be added here.
+
+constexpr PF_SignalCategory SignalCategoryOf(PF_SignalType signal_type)
+{
+    switch (signal_type)
+    {
+        using enum PF_SignalType;
+        case e_double_top_buy:
+        case e_triple_top_buy:
+        case e_bullish_tt_buy:
+        case e_catapult_buy:
+        case e_ttop_catapult_buy:
+            return PF_SignalCategory::e_PF_Buy;
+
+        case e_double_bottom_sell:
+        case e_triple_bottom_sell:
+        case e_bearish_tb_sell:
+        case e_catapult_sell:
+        case e_tbottom_catapult_sell:
+            return PF_SignalCategory::e_PF_Sell;
+
+        case e_unknown:
+            return PF_SignalCategory::e_unknown;
+    }
+    return PF_SignalCategory::e_unknown;
+}
+
 // if we have multiple signals at the same point, show highest priority signal.
 
 enum class PF_SignalPriority : int32_t
@@ -90,6 +122,15 @@ struct PF_Signal
     int32_t column_number_ = -1;
     decimal::Decimal signal_price_ = -1;
     decimal::Decimal box_ = -1;
+
+    // price objectives (targets). -1 means there isn't one.
+    // vertical:   boxes in the signal's column times reversal boxes, from its bottom (buy) or top (sell).
+    //             Kept up to date while the column grows.
+    // horizontal: columns in the congestion the signal broke out of times reversal boxes, from the
+    //             congestion's low (buy) or high (sell).
+
+    decimal::Decimal vertical_objective_ = -1;
+    decimal::Decimal horizontal_objective_ = -1;
 };
 
 // for Python
@@ -305,12 +346,13 @@ template <> struct std::formatter<PF_Signal> : std::formatter<std::string>
         std::format_to(std::back_inserter(s),
                        "category: {}. type: {}. priority: {}. time: {:%F %X}. col: {}. "
                        "price "
-                       "{} box: {}.",
+                       "{} box: {}. objectives: vertical: {} horizontal: {}.",
                        (signal.signal_category_ == PF_SignalCategory::e_PF_Buy    ? "Buy"
                         : signal.signal_category_ == PF_SignalCategory::e_PF_Sell ? "Sell"
                                                                                   : "Unknown"),
                        signal.signal_type_, std::to_underlying(signal.priority_), signal.tpt_, signal.column_number_,
-                       signal.signal_price_.format(".2f"), signal.box_.format("f"));
+                       signal.signal_price_.format(".2f"), signal.box_.format("f"),
+                       signal.vertical_objective_.format("f"), signal.horizontal_objective_.format("f"));
 
         return formatter<std::string>::format(s, ctx);
     }
@@ -262,6 +262,23 @@ void PF_DB::UpdateLastCheckedDateInChartsDB(std::string_view exchange, std::stri
 
 } // -----  end of method PF_Chart::UpdateLastCheckedDateInChartsDB  -----
 
+void PF_DB::StoreBreadthInDB(std::string_view group, std::string_view as_of_date, int64_t charts, int64_t in_x_columns,
+                             int64_t on_buy_signal) const
+{
+    pqxx::connection c{std::format("dbname={} user={}", db_params_.db_name_, db_params_.user_name_)};
+    pqxx::work trxn{c};
+
+    const auto store_breadth_stmt = std::format(
+        "INSERT INTO {}_point_and_figure.pf_breadth (breadth_group, as_of_date, charts, in_x_columns, on_buy_signal) "
+        "VALUES ({}, {}, {}, {}, {}) ON CONFLICT (breadth_group, as_of_date) DO UPDATE SET charts = EXCLUDED.charts, "
+        "in_x_columns = EXCLUDED.in_x_columns, on_buy_signal = EXCLUDED.on_buy_signal",
+        db_params_.PF_db_mode_, trxn.quote(group), trxn.quote(as_of_date), charts, in_x_columns, on_buy_signal);
+
+    trxn.exec(store_breadth_stmt);
+    trxn.commit();
+
+} // -----  end of method PF_DB::StoreBreadthInDB  -----
+
 // ===  FUNCTION  ======================================================================
 //         Name:  RetrieveMostRecentStockDataRecordsFromDB
 //  Description:  just run the supplied query and convert the results set in our format.
@@ -95,6 +95,11 @@ public:
 
     void UpdateLastCheckedDateInChartsDB(std::string_view exchange, std::string_view last_checked_date) const;
 
+    // 1 point in the breadth time series. Storing the same group and date again replaces it.
+
+    void StoreBreadthInDB(std::string_view group, std::string_view as_of_date, int64_t charts, int64_t in_x_columns,
+                          int64_t on_buy_signal) const;
+
     [[nodiscard]] std::vector<StockDataRecord> RetrieveMostRecentStockDataRecordsFromDB(std::string_view symbol,
                                                                                         std::string_view begin_date,
                                                                                         int32_t how_many) const;
@@ -0,0 +1,255 @@
+// =====================================================================================
+//       Filename:  SPSC_RingBuffer.h
+//    Description:  bounded single producer/single consumer ring buffer used for the
+//                  hand-offs between streaming pipeline stages
+// =====================================================================================
+
+#ifndef _SPSC_RINGBUFFER_INC_
+#define _SPSC_RINGBUFFER_INC_
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// how long a waiting side stays busy before going to sleep.
+// spin first (cheapest wake up), then give up the time slice for a while,
+// then park on a futex until the other side says something changed.
+
+struct SpinThenPark
+{
+    int32_t spin_count_ = 512;
+    int32_t yield_count_ = 32;
+};
+
+// =====================================================================================
+//        Class:  SPSC_RingBuffer
+//  Description:  exactly one thread may push and exactly one thread may pop.
+//
+//  The producer and consumer indexes live on separate cache lines along with each
+//  side's cached copy of the other index so a side only reads the other's index line
+//  when its cached copy says the buffer looks full (producer) or empty (consumer).
+//
+//  Each successful push or pop does touch shared state though: it issues a seq_cst
+//  fence and then reads the other side's waiting flag (see Wake). The flags and the
+//  futex words are kept on cache lines of their own which are only written when a
+//  side parks or unparks, so while both sides are keeping up that read hits a line
+//  neither side is writing. The notify call itself is only made when the flag is set
+//  so there is no futex traffic at all in that case. The fence is the price of not
+//  losing a wake up; it is 1 full barrier per operation (or per PopBatch).
+// =====================================================================================
+
+template <typename T> class SPSC_RingBuffer
+{
+public:
+    static constexpr std::size_t kDefaultCapacity = 4096;
+
+    explicit SPSC_RingBuffer(std::size_t capacity = kDefaultCapacity)
+        : mask_{std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1}, slots_(mask_ + 1)
+    {
+    }
+
+    SPSC_RingBuffer(const SPSC_RingBuffer &) = delete;
+    SPSC_RingBuffer(SPSC_RingBuffer &&) = delete;
+    ~SPSC_RingBuffer() = default;
+
+    SPSC_RingBuffer &operator=(const SPSC_RingBuffer &) = delete;
+    SPSC_RingBuffer &operator=(SPSC_RingBuffer &&) = delete;
+
+    // ====================  PRODUCER SIDE  =======================================
+
+    // value is only moved from if there was room.
+
+    bool TryPush(T &&value)
+    {
+        const auto tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ > mask_)
+        {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ > mask_)
+            {
+                return false;
+            }
+        }
+        slots_[tail & mask_] = std::move(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        Wake(consumer_waiting_, consumer_signal_);
+        return true;
+    }
+
+    // waits while full. Returns false (and drops value) only if the buffer was closed.
+
+    bool Push(T value, const SpinThenPark &policy = {})
+    {
+        for (int32_t attempt = 0;; ++attempt)
+        {
+            if (closed_.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+            if (TryPush(std::move(value)))
+            {
+                return true;
+            }
+            Backoff(attempt, policy, producer_waiting_, producer_signal_,
+                    [this] { return tail_.load(std::memory_order_relaxed) - head_.load(std::memory_order_acquire) <= mask_; });
+        }
+    }
+
+    // no more data is coming. The consumer drains what is left then stops.
+
+    void Close()
+    {
+        closed_.store(true, std::memory_order_release);
+        consumer_signal_.fetch_add(1, std::memory_order_release);
+        consumer_signal_.notify_all();
+        producer_signal_.fetch_add(1, std::memory_order_release);
+        producer_signal_.notify_all();
+    }
+
+    // ====================  CONSUMER SIDE  =======================================
+
+    bool TryPop(T &value)
+    {
+        const auto head = head_.load(std::memory_order_relaxed);
+        if (head == cached_tail_)
+        {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_)
+            {
+                return false;
+            }
+        }
+        value = std::move(slots_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        Wake(producer_waiting_, producer_signal_);
+        return true;
+    }
+
+    // move up to max_items into 'batch' (appended) with a single index update.
+    // Returns number of items moved.
+
+    std::size_t PopBatch(std::vector<T> &batch, std::size_t max_items)
+    {
+        const auto head = head_.load(std::memory_order_relaxed);
+        cached_tail_ = tail_.load(std::memory_order_acquire);
+        const auto how_many = std::min<std::size_t>(cached_tail_ - head, max_items);
+        for (std::size_t i = 0; i < how_many; ++i)
+        {
+            batch.push_back(std::move(slots_[(head + i) & mask_]));
+        }
+        if (how_many > 0)
+        {
+            head_.store(head + how_many, std::memory_order_release);
+            Wake(producer_waiting_, producer_signal_);
+        }
+        return how_many;
+    }
+
+    // wait until there is something to pop. Returns false once the buffer
+    // has been closed and everything in it consumed.
+
+    bool WaitForData(const SpinThenPark &policy = {})
+    {
+        for (int32_t attempt = 0;; ++attempt)
+        {
+            if (head_.load(std::memory_order_relaxed) != tail_.load(std::memory_order_acquire))
+            {
+                return true;
+            }
+            if (closed_.load(std::memory_order_acquire))
+            {
+                // one last look in case the producer pushed right before closing.
+
+                return head_.load(std::memory_order_relaxed) != tail_.load(std::memory_order_acquire);
+            }
+            Backoff(attempt, policy, consumer_waiting_, consumer_signal_, [this] {
+                return head_.load(std::memory_order_relaxed) != tail_.load(std::memory_order_acquire);
+            });
+        }
+    }
+
+    // ====================  ACCESSORS  =======================================
+
+    // approximate when called from a thread other than producer or consumer.
+
+    [[nodiscard]] std::size_t size() const
+    {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+    [[nodiscard]] bool empty() const { return size() == 0; }
+    [[nodiscard]] std::size_t capacity() const { return mask_ + 1; }
+    [[nodiscard]] bool IsClosed() const { return closed_.load(std::memory_order_acquire); }
+
+private:
+    static constexpr std::size_t kCacheLine = 64;
+
+    static void Wake(std::atomic<bool> &waiting, std::atomic<uint32_t> &signal)
+    {
+        // pairs with the fence in Backoff: either we see the waiter's flag or it
+        // sees our index update before it parks.
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiting.load(std::memory_order_relaxed))
+        {
+            signal.fetch_add(1, std::memory_order_release);
+            signal.notify_one();
+        }
+    }
+
+    void Backoff(int32_t attempt, const SpinThenPark &policy, std::atomic<bool> &waiting,
+                 std::atomic<uint32_t> &signal, const auto &ready)
+    {
+        if (attempt < policy.spin_count_)
+        {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#endif
+            return;
+        }
+        if (attempt < policy.spin_count_ + policy.yield_count_)
+        {
+            std::this_thread::yield();
+            return;
+        }
+        const auto seen = signal.load(std::memory_order_acquire);
+        waiting.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!ready() && !closed_.load(std::memory_order_acquire))
+        {
+            signal.wait(seen, std::memory_order_acquire);
+        }
+        waiting.store(false, std::memory_order_relaxed);
+    }
+
+    // consumer owned
+
+    alignas(kCacheLine) std::atomic<std::size_t> head_ = 0;
+    std::size_t cached_tail_ = 0;
+
+    // producer owned
+
+    alignas(kCacheLine) std::atomic<std::size_t> tail_ = 0;
+    std::size_t cached_head_ = 0;
+
+    // parking. Written only by a side going to sleep (or by whoever wakes it) but
+    // the waiting flags are read by the other side on every push or pop.
+
+    alignas(kCacheLine) std::atomic<bool> consumer_waiting_ = false;
+    std::atomic<uint32_t> consumer_signal_ = 0;
+
+    alignas(kCacheLine) std::atomic<bool> producer_waiting_ = false;
+    std::atomic<uint32_t> producer_signal_ = 0;
+
+    // shared, read mostly
+
+    alignas(kCacheLine) const std::size_t mask_;
+    std::vector<T> slots_;
+    std::atomic<bool> closed_ = false;
+};
+
+#endif
@@ -17,4 +17,397 @@
 #ifndef _STREAMEDDATA_INC_
 #define _STREAMEDDATA_INC_
 
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <decimal.hh>
+
+// =====================================================================================
+//        Class:  StreamedDataScanner
+//  Description:  forward only, non-allocating walk over the small, flat JSON frames the
+//                streaming services send us. It is NOT a general JSON parser: string
+//                escapes are stepped over but not decoded and values are handed back as
+//                views into the frame. Use StreamedString() on any string value that is
+//                copied out of the frame.
+//
+//                string values come back without their quotes. Arrays and objects come
+//                back whole (brackets included) so they can be scanned in turn.
+// =====================================================================================
+
+class StreamedDataScanner
+{
+public:
+    // 'text' must start (after any white space) with '{' or '['.
+
+    explicit StreamedDataScanner(std::string_view text) : rest_{text}
+    {
+        SkipWhiteSpace();
+        if (rest_.empty() || (rest_.front() != '{' && rest_.front() != '['))
+        {
+            failed_ = true;
+            return;
+        }
+        rest_.remove_prefix(1);
+    }
+
+    // next "key": value pair of an object. false at the end of the object or on bad input.
+
+    bool NextField(std::string_view &key, std::string_view &value)
+    {
+        if (!StartNextItem())
+        {
+            return false;
+        }
+        if (rest_.front() != '"' || !ScanValue(key))
+        {
+            failed_ = true;
+            return false;
+        }
+        SkipWhiteSpace();
+        if (rest_.empty() || rest_.front() != ':')
+        {
+            failed_ = true;
+            return false;
+        }
+        rest_.remove_prefix(1);
+        SkipWhiteSpace();
+        return ScanValue(value);
+    }
+
+    // next element of an array. false at the end of the array or on bad input.
+
+    bool NextElement(std::string_view &value)
+    {
+        if (!StartNextItem())
+        {
+            return false;
+        }
+        return ScanValue(value);
+    }
+
+    [[nodiscard]] bool Failed() const { return failed_; }
+
+private:
+    void SkipWhiteSpace()
+    {
+        while (!rest_.empty() && (rest_.front() == ' ' || rest_.front() == '\t' || rest_.front() == '\n' ||
+                                  rest_.front() == '\r'))
+        {
+            rest_.remove_prefix(1);
+        }
+    }
+
+    // positions us at the start of the next key or element. Consumes the separating comma.
+
+    bool StartNextItem()
+    {
+        if (failed_ || done_)
+        {
+            return false;
+        }
+        SkipWhiteSpace();
+        if (!rest_.empty() && rest_.front() == ',' && started_)
+        {
+            rest_.remove_prefix(1);
+            SkipWhiteSpace();
+        }
+        if (rest_.empty())
+        {
+            failed_ = true;
+            return false;
+        }
+        if (rest_.front() == '}' || rest_.front() == ']')
+        {
+            done_ = true;
+            return false;
+        }
+        started_ = true;
+        return true;
+    }
+
+    bool ScanValue(std::string_view &value)
+    {
+        if (rest_.empty())
+        {
+            failed_ = true;
+            return false;
+        }
+        const char first = rest_.front();
+        if (first == '"')
+        {
+            // a quote after a backslash is part of the string, not its end.
+
+            std::size_t close = 1;
+            while (close < rest_.size() && rest_[close] != '"')
+            {
+                close += rest_[close] == '\\' ? 2 : 1;
+            }
+            if (close >= rest_.size())
+            {
+                failed_ = true;
+                return false;
+            }
+            value = rest_.substr(1, close - 1);
+            rest_.remove_prefix(close + 1);
+            return true;
+        }
+        if (first == '{' || first == '[')
+        {
+            // nested structure. Track depth but ignore brackets inside strings.
+
+            int32_t depth = 0;
+            bool in_string = false;
+            for (std::size_t i = 0; i < rest_.size(); ++i)
+            {
+                const char c = rest_[i];
+                if (in_string)
+                {
+                    if (c == '\\')
+                    {
+                        ++i;
+                    }
+                    else
+                    {
+                        in_string = c != '"';
+                    }
+                    continue;
+                }
+                if (c == '"')
+                {
+                    in_string = true;
+                }
+                else if (c == '{' || c == '[')
+                {
+                    ++depth;
+                }
+                else if ((c == '}' || c == ']') && --depth == 0)
+                {
+                    value = rest_.substr(0, i + 1);
+                    rest_.remove_prefix(i + 1);
+                    return true;
+                }
+            }
+            failed_ = true;
+            return false;
+        }
+
+        // number or literal (true, false, null)
+
+        const auto end = rest_.find_first_of(",}] \t\r\n");
+        if (end == 0 || end == std::string_view::npos)
+        {
+            failed_ = true;
+            return false;
+        }
+        value = rest_.substr(0, end);
+        rest_.remove_prefix(end);
+        return true;
+    }
+
+    std::string_view rest_;
+    bool started_ = false;
+    bool done_ = false;
+    bool failed_ = false;
+};
+
+// string values from the scanner still have any escapes in them. Those can't come through
+// to tickers etc. so decode them on the way out. Tickers never have any so it's just a copy.
+
+inline std::string StreamedString(std::string_view text)
+{
+    if (text.find('\\') == std::string_view::npos)
+    {
+        return std::string{text};
+    }
+
+    auto code_unit = [&text](std::size_t pos, uint32_t &result) {
+        if (pos + 4 > text.size())
+        {
+            return false;
+        }
+        const auto [p, ec] = std::from_chars(text.data() + pos, text.data() + pos + 4, result, 16);
+        return ec == std::errc() && p == text.data() + pos + 4;
+    };
+
+    std::string result;
+    result.reserve(text.size());
+    for (std::size_t i = 0; i < text.size(); ++i)
+    {
+        if (text[i] != '\\' || i + 1 == text.size())
+        {
+            result += text[i];
+            continue;
+        }
+        const char c = text[++i];
+        uint32_t code{};
+        switch (c)
+        {
+            case 'b':
+                result += '\b';
+                break;
+            case 'f':
+                result += '\f';
+                break;
+            case 'n':
+                result += '\n';
+                break;
+            case 'r':
+                result += '\r';
+                break;
+            case 't':
+                result += '\t';
+                break;
+            case 'u':
+                if (!code_unit(i + 1, code))
+                {
+                    result += c;
+                    break;
+                }
+                i += 4;
+
+                // characters outside the BMP come as a surrogate pair.
+
+                if (uint32_t low{}; code >= 0xD800 && code < 0xDC00 && text.substr(i + 1, 2) == "\\u" &&
+                                    code_unit(i + 3, low) && low >= 0xDC00 && low < 0xE000)
+                {
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    i += 6;
+                }
+                if (code < 0x80)
+                {
+                    result += static_cast<char>(code);
+                }
+                else if (code < 0x800)
+                {
+                    result += static_cast<char>(0xC0 | (code >> 6));
+                    result += static_cast<char>(0x80 | (code & 0x3F));
+                }
+                else if (code < 0x10000)
+                {
+                    result += static_cast<char>(0xE0 | (code >> 12));
+                    result += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                    result += static_cast<char>(0x80 | (code & 0x3F));
+                }
+                else
+                {
+                    result += static_cast<char>(0xF0 | (code >> 18));
+                    result += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+                    result += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                    result += static_cast<char>(0x80 | (code & 0x3F));
+                }
+                break;
+            default:
+                result += c; // \" \\ and \/
+                break;
+        }
+    }
+    return result;
+}
+
+// mpdecimal wants a NUL terminated string. Prices are short so use the stack, not the heap.
+
+inline std::optional<decimal::Decimal> StreamedDecimal(std::string_view text)
+{
+    std::array<char, 48> digits{};
+    if (text.empty() || text.size() >= digits.size() ||
+        text.find_first_not_of("+-.0123456789eE") != std::string_view::npos)
+    {
+        return {};
+    }
+    text.copy(digits.data(), text.size());
+    return decimal::Decimal{digits.data()};
+}
+
+// ISO 8601 timestamp as sent by Tiingo: YYYY-MM-DDTHH:MM:SS[.fraction](Z|+HH:MM|-HH:MM)
+// Same result as std::chrono::parse("%FT%T%Ez", ...) without the stream machinery.
+
+inline std::optional<std::chrono::utc_time<std::chrono::nanoseconds>> StreamedISOTimestamp(std::string_view text)
+{
+    auto digits = [&text](std::size_t pos, std::size_t len, int32_t &result) {
+        if (pos + len > text.size())
+        {
+            return false;
+        }
+        const auto [p, ec] = std::from_chars(text.data() + pos, text.data() + pos + len, result);
+        return ec == std::errc() && p == text.data() + pos + len;
+    };
+    auto is_at = [&text](std::size_t pos, char c) { return pos < text.size() && text[pos] == c; };
+
+    int32_t year{};
+    int32_t month{};
+    int32_t day{};
+    int32_t hour{};
+    int32_t minute{};
+    int32_t second{};
+    if (!digits(0, 4, year) || !is_at(4, '-') || !digits(5, 2, month) || !is_at(7, '-') || !digits(8, 2, day) ||
+        !(is_at(10, 'T') || is_at(10, ' ')) || !digits(11, 2, hour) || !is_at(13, ':') || !digits(14, 2, minute) ||
+        !is_at(16, ':') || !digits(17, 2, second))
+    {
+        return {};
+    }
+    const std::chrono::year_month_day ymd{std::chrono::year{year}, std::chrono::month{static_cast<uint32_t>(month)},
+                                          std::chrono::day{static_cast<uint32_t>(day)}};
+    if (!ymd.ok() || hour > 23 || minute > 59 || second > 60)
+    {
+        return {};
+    }
+
+    std::size_t pos = 19;
+    int64_t fraction_ns{0};
+    if (is_at(pos, '.'))
+    {
+        ++pos;
+        int64_t scale = 100'000'000;
+        const auto fraction_start = pos;
+        for (; pos < text.size() && text[pos] >= '0' && text[pos] <= '9'; ++pos)
+        {
+            fraction_ns += (text[pos] - '0') * scale; // anything past nanoseconds just adds 0
+            scale /= 10;
+        }
+        if (pos == fraction_start)
+        {
+            return {};
+        }
+    }
+
+    std::chrono::minutes offset{0};
+    if (is_at(pos, 'Z'))
+    {
+        ++pos;
+    }
+    else if (is_at(pos, '+') || is_at(pos, '-'))
+    {
+        int32_t off_hours{};
+        int32_t off_minutes{};
+        if (!digits(pos + 1, 2, off_hours) || !is_at(pos + 3, ':') || !digits(pos + 4, 2, off_minutes))
+        {
+            return {};
+        }
+        offset = std::chrono::hours{off_hours} + std::chrono::minutes{off_minutes};
+        if (text[pos] == '-')
+        {
+            offset = -offset;
+        }
+        pos += 6;
+    }
+    else
+    {
+        return {};
+    }
+    if (pos != text.size())
+    {
+        return {};
+    }
+
+    const std::chrono::sys_time<std::chrono::nanoseconds> local_as_sys{
+        std::chrono::sys_days{ymd} + std::chrono::hours{hour} + std::chrono::minutes{minute} +
+        std::chrono::seconds{second} + std::chrono::nanoseconds{fraction_ns}};
+    return std::chrono::utc_clock::from_sys(local_as_sys - offset);
+}
+
 #endif // ----- #ifndef _STREAMEDDATA_INC_  -----
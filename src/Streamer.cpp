@@ -313,17 +313,18 @@ void RemoteDataSource::on_read(beast::error_code ec, std::size_t bytes_transferr
     // Process Data
     if (buffer_.size() > 0 && context_ptr_)
     {
+        const auto received_ns = WallClockNanoseconds();
+
         // We read the data, then manually consume it.
         std::string buffer_content = beast::buffers_to_string(buffer_.cdata());
 
         // Remove the processed bytes from the buffer so it's empty for the next read
         buffer_.clear();
 
-        {
-            std::lock_guard<std::mutex> queue_lock(context_ptr_->mtx_);
-            context_ptr_->streamed_data_.push(std::move(buffer_content));
-        }
-        context_ptr_->cv_.notify_one();
+        // this only waits if the parser has fallen a full buffer behind.
+
+        context_ptr_->streamed_data_.Push(StreamedFrame{std::move(buffer_content), received_ns},
+                                          context_ptr_->wait_policy_);
     }
 
     // Loop
@@ -426,29 +427,11 @@ void RemoteDataSource::UseSymbols(const std::vector<std::string> &symbols)
 
 std::string RemoteDataSource::RequestData(const std::string &request_string)
 {
-    // Keep this synchronous for one-off requests
-    net::io_context ioc_req;
-    ssl::context ctx_req{ssl::context::tlsv12_client};
-    beast::ssl_stream<beast::tcp_stream> stream(ioc_req, ctx_req);
-    tcp::resolver resolver_req{ioc_req};
-
-    if (!SSL_set_tlsext_host_name(stream.native_handle(), host_.c_str()))
-        throw beast::system_error{
-            beast::error_code(static_cast<int>(::ERR_get_error()), net::error::get_ssl_category())};
-
-    auto const results = resolver_req.resolve(host_, port_);
-    beast::get_lowest_layer(stream).connect(results);
-    stream.handshake(ssl::stream_base::client);
-
-    http::request<http::string_body> req{http::verb::get, request_string, version};
-    req.set(http::field::host, host_);
-    req.set(http::field::user_agent, BOOST_BEAST_VERSION_STRING);
-    http::write(stream, req);
-
-    beast::flat_buffer buffer;
-    http::response<http::string_body> res;
-    http::read(stream, buffer, res);
-
-    beast::get_lowest_layer(stream).close();
-    return res.body();
+    // Keep this synchronous for one-off requests. The connection stays open between them.
+
+    if (!rest_client_)
+    {
+        rest_client_ = std::make_unique<HTTPSClient>(host_, port_);
+    }
+    return rest_client_->Get(request_string);
 }
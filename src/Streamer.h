@@ -7,11 +7,8 @@
 #define _STREAMER_INC_
 
 #include <chrono>
-#include <condition_variable>
 #include <memory>
-#include <mutex>
 #include <optional>
-#include <queue>
 #include <random>
 #include <vector>
 
@@ -34,6 +31,8 @@ namespace net = boost::asio;            // from <boost/asio.hpp>
 namespace ssl = boost::asio::ssl;       // from <boost/asio/ssl.hpp>
 using tcp = boost::asio::ip::tcp;       // from <boost/asio/ip/tcp.hpp>
 
+#include "HTTPSClient.h"
+#include "SPSC_RingBuffer.h"
 #include "Uniqueifier.h"
 #include "utilities.h"
 
@@ -76,22 +75,47 @@ public:
         int32_t last_size_{-1};
         bool dark_pool_{false};
         EodMktStatus market_status_{EodMktStatus::e_unknown};
+        int32_t symbol_id_{-1}; // filled in by the consumer, not the data source
+
+        // for latency measurement. WallClockNanoseconds() when the frame was read and parsed.
+
+        int64_t received_ns_{0};
+        int64_t parsed_ns_{0};
     };
 
+    // a message as read from the websocket.
+
+    struct StreamedFrame
+    {
+        std::string text_;
+        int64_t received_ns_{0};
+    };
+
+    // websocket reader -> parser. Single producer (the io_context thread), single consumer (the parser).
+    // Closing the buffer is how we say we are done.
+
     struct StreamerContext
     {
-        std::condition_variable cv_ = {};
-        bool done_ = false; // Flag to signal completion
-        std::mutex mtx_ = {};
-        std::queue<std::string> streamed_data_;
+        explicit StreamerContext(std::size_t capacity = SPSC_RingBuffer<StreamedFrame>::kDefaultCapacity,
+                                 SpinThenPark wait_policy = {})
+            : streamed_data_{capacity}, wait_policy_{wait_policy}
+        {
+        }
+        SPSC_RingBuffer<StreamedFrame> streamed_data_;
+        SpinThenPark wait_policy_;
     };
 
+    // parser -> chart processor. Single producer (the parser), single consumer (the processor).
+
     struct ProcessorContext
     {
-        std::condition_variable cv_ = {};
-        bool done_ = false; // Flag to signal completion
-        std::mutex mtx_ = {};
-        std::queue<PF_Data> extracted_data_ = {};
+        explicit ProcessorContext(std::size_t capacity = SPSC_RingBuffer<PF_Data>::kDefaultCapacity,
+                                  SpinThenPark wait_policy = {})
+            : extracted_data_{capacity}, wait_policy_{wait_policy}
+        {
+        }
+        SPSC_RingBuffer<PF_Data> extracted_data_;
+        SpinThenPark wait_policy_;
     };
 
     // ====================  LIFECYCLE     =======================================
@@ -105,6 +129,15 @@ public:
 
     // ====================  ACCESSORS     =======================================
 
+    // system clock so it can be compared with the time stamps the services send.
+
+    static int64_t WallClockNanoseconds()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    }
+
     // Synchronous request (kept for non-streaming data)
     std::string RequestData(const std::string &request_string);
 
@@ -181,6 +214,10 @@ protected:
     bool *had_signal_ptr_ = nullptr;
 
     std::vector<std::string> symbol_list_;
+
+    // REST requests. Made on first use and kept so later requests reuse its connection.
+    std::unique_ptr<HTTPSClient> rest_client_;
+
     const std::string host_;
     const std::string port_;
     const std::string api_key_;
@@ -15,10 +15,9 @@
 // =====================================================================================
 
 #include "Tiingo.h"
-#include <boost/regex.hpp>
+#include "StreamedData.h"
 #include <format>
 #include <ranges>
-#include <sstream>
 
 #include <json/json.h> // Ensure jsoncpp is available
 
@@ -106,53 +105,64 @@ Tiingo::PF_Data Tiingo::ExtractStreamedData(const std::string &buffer)
     // Tiingo only provides 3 fields for its 'free' IEX feed
     // - nanoseconds timestamp as fully formatted text string
     // - symbol
-    // - price as a 2-digit float.
+    // - price as a 2-digit float (sometimes quoted, sometimes not).
 
-    static const boost::regex kNumericTradePrice{R"***(("data":\["(?:[^,]*,){2})([0-9]*\.[0-9]*)])***"};
-    static const boost::regex kQuotedTradePrice{R"***(("data":\[(?:[^,]*,){2})"([0-9]*\.[0-9]*)")***"};
-    static const std::string kStringTradePrice{R"***($1"$2"])***"};
-    const std::string zapped_buffer = boost::regex_replace(buffer, kNumericTradePrice, kStringTradePrice);
+    // {"messageType":"A","service":"iex","data":["2024-04-12T10:23:45.123456789-04:00","spy",512.34]}
 
-    JSONCPP_STRING err;
-    Json::Value response;
+    // this runs for every message we receive so make one pass over the frame
+    // and work with views into it. No DOM, no regexes, no string streams.
 
-    Json::CharReaderBuilder builder;
-    const std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    PF_Data new_value;
 
-    if (!reader->parse(zapped_buffer.data(), zapped_buffer.data() + zapped_buffer.size(), &response, &err))
+    std::string_view message_type;
+    std::string_view data;
+
+    StreamedDataScanner frame{buffer};
+    std::string_view key;
+    std::string_view value;
+    while (frame.NextField(key, value))
     {
-        throw std::runtime_error("Problem parsing tiingo response: "s + err);
+        if (key == "messageType")
+        {
+            message_type = value;
+        }
+        else if (key == "data")
+        {
+            data = value;
+        }
+    }
+    if (frame.Failed() || message_type.empty())
+    {
+        throw std::runtime_error(std::format("Problem parsing tiingo response: ->{}<-", buffer));
     }
 
-    PF_Data new_value;
-
-    auto message_type = response["messageType"];
-    if (strcmp(message_type.asCString(), "A") == 0)
+    if (message_type == "A")
     {
-        auto data = response["data"];
+        std::string_view time_stamp;
+        std::string_view ticker;
+        std::string_view price;
+
+        StreamedDataScanner elements{data};
+        const bool have_fields =
+            elements.NextElement(time_stamp) && elements.NextElement(ticker) && elements.NextElement(price);
 
-        boost::smatch m;
-        if (bool found_it = boost::regex_search(zapped_buffer, m, kQuotedTradePrice); !found_it)
+        const auto time_stamp_utc = StreamedISOTimestamp(time_stamp);
+        const auto last_price = StreamedDecimal(price);
+        if (!have_fields || !time_stamp_utc || ticker.empty() || !last_price)
         {
-            spdlog::error("can't find trade price in buffer: {}", buffer);
+            spdlog::error("can't find trade data in buffer: {}", buffer);
         }
         else
         {
             new_value.subscription_id_ = subscription_id_;
-            new_value.time_stamp_ = data[0].asCString();
-            std::istringstream(new_value.time_stamp_) >>
-                std::chrono::parse("%FT%T%Ez", new_value.time_stamp_nanoseconds_utc_);
-            new_value.ticker_ = data[1].asCString();
+            new_value.time_stamp_ = time_stamp;
+            new_value.time_stamp_nanoseconds_utc_ = *time_stamp_utc;
+            new_value.ticker_ = StreamedString(ticker);
             rng::for_each(new_value.ticker_, [](char &c) { c = std::toupper(c); });
-            new_value.last_price_ = decimal::Decimal{m[2].str()};
+            new_value.last_price_ = *last_price;
             new_value.last_size_ = 100; // not reported by new Tiingo IEX data so just use a standard number
         }
     }
-    // else if (message_type == "I")
-    // {
-    //     subscription_id_ = response["data"]["subscriptionId"].asString();
-    //     //        std::cout << "json cpp subscription ID: " << subscription_id_ << '\n';
-    // }
     else if (message_type == "H")
     {
         // heartbeat , just return
@@ -169,11 +179,7 @@ void Tiingo::StopStreaming(StreamerContext &streamer_context)
 
     // tell our extractor code we are really done
 
-    {
-        std::lock_guard<std::mutex> lock(streamer_context.mtx_);
-        streamer_context.done_ = true;
-    }
-    streamer_context.cv_.notify_one();
+    streamer_context.streamed_data_.Close();
 
     // we need to send the unsubscribe message in a separate connection.
 
@@ -0,0 +1,175 @@
+#include "backtest/Backtest.h"
+
+#include <algorithm>
+#include <exception>
+#include <format>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+#include "PF_Chart.h"
+#include "common/WorkerPool.h"
+
+PF_Chart MakeBacktestChart(const BacktestPrices &prices, const BacktestParams &params, bool box_size_from_range)
+{
+    // same as the loader: with a computed box size the given one is the modifier.
+
+    return box_size_from_range
+               ? PF_Chart{prices.symbol_, prices.range_, params.reversal_boxes_, params.box_size_, params.box_scale_}
+               : PF_Chart{prices.symbol_, params.box_size_, params.reversal_boxes_, 0, params.box_scale_};
+}
+
+std::optional<double> SignalReturn(const BacktestPrices &prices, std::size_t ndx, int32_t horizon,
+                                   PF_SignalCategory signal_category)
+{
+    const auto exit_ndx = ndx + static_cast<std::size_t>(horizon);
+    const auto entry = prices.closes_dbl_[ndx];
+    if (exit_ndx >= prices.closes_dbl_.size() || entry <= 0.0)
+    {
+        return {};
+    }
+    const double direction = signal_category == PF_SignalCategory::e_PF_Sell ? -1.0 : 1.0;
+    return direction * (prices.closes_dbl_[exit_ndx] / entry - 1.0);
+}
+
+SignalOutcomes &SignalOutcomes::operator+=(const SignalOutcomes &rhs)
+{
+    signals_ += rhs.signals_;
+    for (std::size_t horizon = 0; horizon < rhs.evaluated_.size(); ++horizon)
+    {
+        evaluated_[horizon] += rhs.evaluated_[horizon];
+        wins_[horizon] += rhs.wins_[horizon];
+        return_sum_[horizon] += rhs.return_sum_[horizon];
+        return_sq_sum_[horizon] += rhs.return_sq_sum_[horizon];
+    }
+    return *this;
+}
+
+BacktestResult &BacktestResult::operator+=(const BacktestResult &rhs)
+{
+    charts_ += rhs.charts_;
+    charts_failed_ += rhs.charts_failed_;
+    for (std::size_t which = 0; which < by_signal_type_.size(); ++which)
+    {
+        by_signal_type_[which] += rhs.by_signal_type_[which];
+    }
+    return *this;
+}
+
+Backtester::Backtester(std::vector<BacktestParams> grid, std::vector<int32_t> horizons, bool box_size_from_range)
+    : horizons_{std::move(horizons)}, box_size_from_range_{box_size_from_range}
+{
+    results_.reserve(grid.size());
+    for (const auto &params : grid)
+    {
+        results_.push_back(NoResults(params));
+    }
+}
+
+BacktestResult Backtester::NoResults(const BacktestParams &params) const
+{
+    BacktestResult result{.params_ = params, .charts_ = 0, .charts_failed_ = 0, .by_signal_type_ = {}};
+    for (auto &outcomes : result.by_signal_type_)
+    {
+        outcomes.evaluated_.resize(horizons_.size());
+        outcomes.wins_.resize(horizons_.size());
+        outcomes.return_sum_.resize(horizons_.size());
+        outcomes.return_sq_sum_.resize(horizons_.size());
+    }
+    return result;
+}
+
+void Backtester::Run(const std::vector<BacktestPrices> &universe, int32_t thread_count)
+{
+    if (results_.empty() || universe.empty())
+    {
+        return;
+    }
+
+    // a few pieces per thread for each parameter set so nobody waits long on the
+    // last one. Each piece has its own results which are added up at the end.
+
+    struct Piece
+    {
+        std::size_t which_params_ = 0;
+        std::size_t first_symbol_ = 0;
+        std::size_t end_symbol_ = 0;
+        BacktestResult result_;
+    };
+
+    const auto threads = static_cast<std::size_t>(std::max(1, thread_count));
+    const auto pieces_per_params = std::max<std::size_t>(1, (threads * 4 + results_.size() - 1) / results_.size());
+    const auto symbols_per_piece =
+        std::max<std::size_t>(1, (universe.size() + pieces_per_params - 1) / pieces_per_params);
+
+    std::vector<Piece> pieces;
+    for (std::size_t which_params = 0; which_params < results_.size(); ++which_params)
+    {
+        for (std::size_t first = 0; first < universe.size(); first += symbols_per_piece)
+        {
+            pieces.push_back({.which_params_ = which_params,
+                              .first_symbol_ = first,
+                              .end_symbol_ = std::min(first + symbols_per_piece, universe.size()),
+                              .result_ = NoResults(results_[which_params].params_)});
+        }
+    }
+
+    ForEachOnWorkerPool(pieces, thread_count, [this, &universe](Piece &piece) {
+        for (auto symbol_ndx = piece.first_symbol_; symbol_ndx < piece.end_symbol_; ++symbol_ndx)
+        {
+            ReplaySymbol(universe[symbol_ndx], piece.result_.params_, piece.result_);
+        }
+    });
+
+    for (const auto &piece : pieces)
+    {
+        results_[piece.which_params_] += piece.result_;
+    }
+}
+
+void Backtester::ReplaySymbol(const BacktestPrices &prices, const BacktestParams &params,
+                              BacktestResult &result) const
+{
+    if (prices.closes_.empty() || (box_size_from_range_ && prices.range_ <= decimal::Decimal{0}))
+    {
+        return;
+    }
+
+    try
+    {
+        auto chart = MakeBacktestChart(prices, params, box_size_from_range_);
+
+        for (std::size_t ndx = 0; ndx < prices.closes_.size(); ++ndx)
+        {
+            if (chart.AddValue(prices.closes_[ndx], prices.dates_[ndx]) != PF_Column::Status::e_AcceptedWithSignal)
+            {
+                continue;
+            }
+            const auto signal = chart.GetMostRecentSignal();
+            auto &outcomes = result.by_signal_type_[static_cast<std::size_t>(std::to_underlying(signal->signal_type_))];
+            outcomes.signals_ += 1;
+
+            for (std::size_t horizon = 0; horizon < horizons_.size(); ++horizon)
+            {
+                const auto the_return = SignalReturn(prices, ndx, horizons_[horizon], signal->signal_category_);
+                if (!the_return)
+                {
+                    continue;
+                }
+                outcomes.evaluated_[horizon] += 1;
+                outcomes.wins_[horizon] += *the_return > 0.0 ? 1 : 0;
+                outcomes.return_sum_[horizon] += *the_return;
+                outcomes.return_sq_sum_[horizon] += *the_return * *the_return;
+            }
+        }
+        result.charts_ += 1;
+    }
+    catch (const std::exception &e)
+    {
+        result.charts_failed_ += 1;
+        spdlog::error(std::format("Unable to backtest symbol: {} with box size: {}, reversal: {}, scale: {} "
+                                  "because: {}.",
+                                  prices.symbol_, params.box_size_.format("f"), params.reversal_boxes_,
+                                  params.box_scale_, e.what()));
+    }
+}
@@ -0,0 +1,118 @@
+#ifndef PF_BACKTEST_INC
+#define PF_BACKTEST_INC
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <decimal.hh>
+
+#include "Boxes.h"
+#include "PF_Signals.h"
+
+// =====================================================================================
+//        Class:  Backtester
+//  Description:  replays each symbol's price history through a grid of chart
+//                parameters and scores the signals the charts set off.
+//
+//  Every (box size, reversal, scale) in the grid gets a fresh chart per symbol which is
+//  fed the prices in order. Each time AddValue reports a new signal (what LookForNewSignal
+//  found) we look at the close some number of prices later for each horizon and record
+//  the return in the signal's direction -- a sell followed by a drop counts as a gain.
+//
+//  Results are kept per parameter set and per PF_SignalType and add up over calls to
+//  Run so a universe can be fed an exchange at a time without holding all of it.
+//
+//  A universe's prices are shared, read only, by all the threads. Work is handed out as
+//  (parameter set, run of symbols) pieces so all the cores stay busy whether the grid is
+//  big and the universe small or the other way around.
+// =====================================================================================
+
+// 1 symbol's prices, in date order.
+
+struct BacktestPrices
+{
+    std::string symbol_;
+    std::vector<std::chrono::utc_time<std::chrono::utc_clock::duration>> dates_;
+    std::vector<decimal::Decimal> closes_;
+    std::vector<double> closes_dbl_; // same prices, for computing returns
+    decimal::Decimal range_;         // max - min close. Base box size for box_size_from_range.
+};
+
+struct BacktestParams
+{
+    decimal::Decimal box_size_;
+    int32_t reversal_boxes_ = 0;
+    BoxScale box_scale_ = BoxScale::e_Linear;
+};
+
+// what came after signals of 1 type. The vectors have 1 entry per horizon.
+
+struct SignalOutcomes
+{
+    int64_t signals_ = 0;
+    std::vector<int64_t> evaluated_; // signals with enough prices after them to measure
+    std::vector<int64_t> wins_;      // return > 0
+    std::vector<double> return_sum_;
+    std::vector<double> return_sq_sum_;
+
+    SignalOutcomes &operator+=(const SignalOutcomes &rhs);
+};
+
+struct BacktestResult
+{
+    BacktestParams params_;
+    int64_t charts_ = 0;
+    int64_t charts_failed_ = 0;
+    std::array<SignalOutcomes, kSignalTypeCount> by_signal_type_;
+
+    BacktestResult &operator+=(const BacktestResult &rhs);
+};
+
+class PF_Chart;
+
+// a new, empty chart for 'prices' the way the backtester makes them. With box_size_from_range
+// the box size in params is a modifier of the symbol's price range.
+
+[[nodiscard]] PF_Chart MakeBacktestChart(const BacktestPrices &prices, const BacktestParams &params,
+                                         bool box_size_from_range);
+
+// the return in the signal's direction 'horizon' prices after the one at 'ndx' or nothing
+// if the prices run out first.
+
+[[nodiscard]] std::optional<double> SignalReturn(const BacktestPrices &prices, std::size_t ndx, int32_t horizon,
+                                                 PF_SignalCategory signal_category);
+
+class Backtester
+{
+public:
+    // horizons are counted in prices (trading days for eod data).
+    // With box_size_from_range, box sizes in the grid are modifiers of each symbol's
+    // price range, the same as the loader's --use-MinMax.
+
+    Backtester(std::vector<BacktestParams> grid, std::vector<int32_t> horizons, bool box_size_from_range);
+
+    void Run(const std::vector<BacktestPrices> &universe, int32_t thread_count);
+
+    [[nodiscard]] const std::vector<int32_t> &GetHorizons() const
+    {
+        return horizons_;
+    }
+    [[nodiscard]] const std::vector<BacktestResult> &GetResults() const
+    {
+        return results_;
+    }
+
+private:
+    [[nodiscard]] BacktestResult NoResults(const BacktestParams &params) const;
+    void ReplaySymbol(const BacktestPrices &prices, const BacktestParams &params, BacktestResult &result) const;
+
+    std::vector<int32_t> horizons_;
+    std::vector<BacktestResult> results_; // 1 per grid entry, in grid order
+    bool box_size_from_range_ = false;
+};
+
+#endif
@@ -0,0 +1,169 @@
+#include "backtest/BoxSizeOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <format>
+#include <limits>
+#include <ranges>
+#include <utility>
+
+namespace vws = std::ranges::views;
+
+#include <spdlog/spdlog.h>
+
+#include "PF_Chart.h"
+#include "common/WorkerPool.h"
+
+namespace
+{
+constexpr double kCantChoose = -std::numeric_limits<double>::infinity();
+}
+
+BoxSizeOptimizer::BoxSizeOptimizer(BoxSizeOptimizerSettings settings) : settings_{std::move(settings)}
+{
+    // modifiers vary fastest so each (reversal, scale) pair's candidates are together.
+
+    for (const auto &[reversal, scale, modifier] :
+         vws::cartesian_product(settings_.reversals_, settings_.scales_, settings_.modifiers_))
+    {
+        params_.push_back({.box_size_ = modifier, .reversal_boxes_ = reversal, .box_scale_ = scale});
+    }
+}
+
+std::vector<ChosenBoxSize> BoxSizeOptimizer::Run(const std::vector<BacktestPrices> &universe,
+                                                 int32_t thread_count) const
+{
+    std::vector<ChosenBoxSize> chosen;
+    if (params_.empty() || universe.empty())
+    {
+        return chosen;
+    }
+
+    std::vector<Candidate> candidates;
+    candidates.reserve(universe.size() * params_.size());
+    for (std::size_t symbol_ndx = 0; symbol_ndx < universe.size(); ++symbol_ndx)
+    {
+        for (std::size_t which_params = 0; which_params < params_.size(); ++which_params)
+        {
+            candidates.push_back({.symbol_ndx_ = symbol_ndx, .which_params_ = which_params});
+        }
+    }
+
+    ForEachOnWorkerPool(candidates, thread_count, [this, &universe](Candidate &candidate) {
+        BuildCandidate(universe[candidate.symbol_ndx_], candidate);
+    });
+
+    // each symbol's candidates are together and, within those, each (reversal, scale)
+    // pair's. Ties go to the first (smallest) modifier.
+
+    const auto modifiers = settings_.modifiers_.size();
+    for (std::size_t first = 0; first < candidates.size(); first += modifiers)
+    {
+        const auto &prices = universe[candidates[first].symbol_ndx_];
+
+        std::size_t best = first;
+        double best_score = kCantChoose;
+        for (auto ndx = first; ndx < first + modifiers; ++ndx)
+        {
+            const auto score = Score(prices, candidates[ndx]);
+            if (score > best_score)
+            {
+                best = ndx;
+                best_score = score;
+            }
+        }
+        if (best_score == kCantChoose)
+        {
+            spdlog::debug(std::format("No box size could be chosen for symbol: {} reversal: {} scale: {}.",
+                                      prices.symbol_, params_[candidates[first].which_params_].reversal_boxes_,
+                                      params_[candidates[first].which_params_].box_scale_));
+            continue;
+        }
+
+        const auto &params = params_[candidates[best].which_params_];
+        chosen.push_back({.symbol_ = prices.symbol_,
+                          .base_box_size_ = prices.range_,
+                          .box_size_modifier_ = params.box_size_,
+                          .reversal_boxes_ = params.reversal_boxes_,
+                          .box_scale_ = params.box_scale_,
+                          .score_ = best_score});
+    }
+    return chosen;
+}
+
+void BoxSizeOptimizer::BuildCandidate(const BacktestPrices &prices, Candidate &candidate) const
+{
+    if (prices.closes_.empty() || prices.range_ <= decimal::Decimal{0})
+    {
+        return;
+    }
+
+    const auto &params = params_[candidate.which_params_];
+    try
+    {
+        auto chart = MakeBacktestChart(prices, params, true);
+
+        for (std::size_t ndx = 0; ndx < prices.closes_.size(); ++ndx)
+        {
+            if (chart.AddValue(prices.closes_[ndx], prices.dates_[ndx]) != PF_Column::Status::e_AcceptedWithSignal ||
+                settings_.score_ != BoxSizeScore::e_signals)
+            {
+                continue;
+            }
+            const auto the_return =
+                SignalReturn(prices, ndx, settings_.horizon_, chart.GetMostRecentSignal()->signal_category_);
+            if (the_return)
+            {
+                candidate.evaluated_ += 1;
+                candidate.return_sum_ += *the_return;
+                candidate.return_sq_sum_ += *the_return * *the_return;
+            }
+        }
+        candidate.columns_ = static_cast<int64_t>(chart.size());
+        candidate.built_ = true;
+    }
+    catch (const std::exception &e)
+    {
+        spdlog::error(std::format("Unable to build candidate chart for symbol: {} with box size modifier: {}, "
+                                  "reversal: {}, scale: {} because: {}.",
+                                  prices.symbol_, params.box_size_.format("f"), params.reversal_boxes_,
+                                  params.box_scale_, e.what()));
+    }
+}
+
+double BoxSizeOptimizer::Score(const BacktestPrices &prices, const Candidate &candidate) const
+{
+    if (!candidate.built_ || candidate.columns_ < 1)
+    {
+        return kCantChoose;
+    }
+
+    switch (settings_.score_)
+    {
+        case BoxSizeScore::e_columns:
+        {
+            const auto target = static_cast<double>(settings_.target_columns_);
+            return -std::abs(static_cast<double>(candidate.columns_) - target) / target;
+        }
+        case BoxSizeScore::e_column_length:
+        {
+            const auto column_length =
+                static_cast<double>(prices.closes_.size()) / static_cast<double>(candidate.columns_);
+            return -std::abs(column_length - settings_.target_column_length_) / settings_.target_column_length_;
+        }
+        case BoxSizeScore::e_signals:
+        {
+            if (candidate.evaluated_ < settings_.min_signals_)
+            {
+                return kCantChoose;
+            }
+            const auto evaluated = static_cast<double>(candidate.evaluated_);
+            const auto mean = candidate.return_sum_ / evaluated;
+            const auto std_dev = std::sqrt(std::max(0.0, candidate.return_sq_sum_ / evaluated - mean * mean));
+            return mean / std::max(std_dev, 1e-9) * std::sqrt(evaluated);
+        }
+        default:
+            return kCantChoose;
+    }
+}
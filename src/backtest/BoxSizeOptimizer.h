@@ -0,0 +1,91 @@
+#ifndef PF_BOXSIZEOPTIMIZER_INC
+#define PF_BOXSIZEOPTIMIZER_INC
+
+#include <cstdint>
+#include <vector>
+
+#include <decimal.hh>
+
+#include "Boxes.h"
+#include "backtest/Backtest.h"
+#include "common/ChosenBoxSizes.h"
+
+// =====================================================================================
+//        Class:  BoxSizeOptimizer
+//  Description:  picks a box size for each symbol by building a chart for every
+//                candidate from the symbol's prices and keeping the one which scores
+//                best.
+//
+//  Candidates are modifiers of the symbol's price range -- the loader's --use-MinMax --
+//  so 1 list of them makes sense for a whole universe of differently priced symbols.
+//  A box size is chosen for each (reversal, scale) pair.
+//
+//  Scores (bigger is better):
+//      e_columns       -- how close the chart comes to a target number of columns.
+//      e_column_length -- how close the average number of prices per column comes to a
+//                         target. Few prices per column means the chart reverses too often.
+//      e_signals       -- t statistic of the signals' returns at the horizon. Candidates
+//                         with fewer than min_signals measurable signals can't be chosen.
+//
+//  All the candidate charts for a universe are built at once on a worker pool sharing,
+//  read only, the universe's prices. A symbol none of whose candidates can be chosen is
+//  left out of the results.
+// =====================================================================================
+
+enum class BoxSizeScore : int32_t
+{
+    e_unknown,
+    e_columns,
+    e_column_length,
+    e_signals
+};
+
+struct BoxSizeOptimizerSettings
+{
+    std::vector<decimal::Decimal> modifiers_;
+    std::vector<int32_t> reversals_;
+    std::vector<BoxScale> scales_;
+    BoxSizeScore score_ = BoxSizeScore::e_columns;
+    int32_t target_columns_ = 60;
+    double target_column_length_ = 5.0;
+    int32_t horizon_ = 20;
+    int32_t min_signals_ = 5;
+};
+
+class BoxSizeOptimizer
+{
+public:
+    explicit BoxSizeOptimizer(BoxSizeOptimizerSettings settings);
+
+    // 1 entry per symbol and (reversal, scale) in symbol order.
+
+    [[nodiscard]] std::vector<ChosenBoxSize> Run(const std::vector<BacktestPrices> &universe,
+                                                 int32_t thread_count) const;
+
+    [[nodiscard]] const BoxSizeOptimizerSettings &GetSettings() const
+    {
+        return settings_;
+    }
+
+private:
+    // what a candidate's chart looked like after all the prices.
+
+    struct Candidate
+    {
+        std::size_t symbol_ndx_ = 0;
+        std::size_t which_params_ = 0;
+        int64_t columns_ = 0;
+        int64_t evaluated_ = 0;
+        double return_sum_ = 0.0;
+        double return_sq_sum_ = 0.0;
+        bool built_ = false;
+    };
+
+    void BuildCandidate(const BacktestPrices &prices, Candidate &candidate) const;
+    [[nodiscard]] double Score(const BacktestPrices &prices, const Candidate &candidate) const;
+
+    BoxSizeOptimizerSettings settings_;
+    std::vector<BacktestParams> params_; // modifier x reversal x scale
+};
+
+#endif
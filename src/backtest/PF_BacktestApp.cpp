@@ -0,0 +1,533 @@
+#include "backtest/PF_BacktestApp.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <sstream>
+#include <thread>
+
+namespace rng = std::ranges;
+namespace vws = std::ranges::views;
+
+#include <boost/assert.hpp>
+
+#include "utilities.h"
+
+namespace
+{
+struct OutcomeStats
+{
+    double mean_ = 0.0;
+    double std_dev_ = 0.0;
+    double win_rate_ = 0.0;
+};
+
+OutcomeStats StatsForHorizon(const SignalOutcomes &outcomes, std::size_t horizon)
+{
+    const auto evaluated = static_cast<double>(outcomes.evaluated_[horizon]);
+    if (evaluated == 0.0)
+    {
+        return {};
+    }
+    const auto mean = outcomes.return_sum_[horizon] / evaluated;
+    const auto variance = outcomes.return_sq_sum_[horizon] / evaluated - mean * mean;
+    return {.mean_ = mean,
+            .std_dev_ = std::sqrt(std::max(0.0, variance)),
+            .win_rate_ = static_cast<double>(outcomes.wins_[horizon]) / evaluated};
+}
+} // namespace
+
+// =====================================================================================
+//        Class:  PF_BacktestApp
+//  Description:  parameter sweep over historical prices
+// =====================================================================================
+
+PF_BacktestApp::PF_BacktestApp(int argc, char *argv[]) : PF_AppBase{argc, argv}
+{
+    app_.description("Point & Figure backtester: scores the signals from a grid of chart parameters.");
+    SetupProgramOptions();
+}
+
+PF_BacktestApp::PF_BacktestApp(const std::vector<std::string> &tokens) : PF_AppBase{tokens}
+{
+    app_.description("Point & Figure backtester: scores the signals from a grid of chart parameters.");
+    SetupProgramOptions();
+}
+
+bool PF_BacktestApp::Startup()
+{
+    spdlog::info(std::format("\n\n*** Starting run {} ***\n",
+                             std::chrono::current_zone()->to_local(std::chrono::system_clock::now())));
+    bool result{true};
+    try
+    {
+        ParseProgramOptions(tokens_);
+        ConfigureLogging();
+        result = CheckArgs();
+    }
+    catch (const std::exception &e)
+    {
+        spdlog::error(std::format("Problem in startup: {}\n", e.what()));
+        result = false;
+    }
+    catch (...)
+    {
+        spdlog::error("Unexpected problem during Startup processing\n");
+        result = false;
+    }
+    return result;
+}
+
+void PF_BacktestApp::Shutdown()
+{
+    // nothing to clean up for backtester
+}
+
+void PF_BacktestApp::SetupProgramOptions()
+{
+    app_.preparse_callback([](size_t argCount) {
+        if (argCount == 0)
+        {
+            throw CLI::CallForHelp();
+        }
+    });
+
+    app_.failure_message(CLI::FailureMessage::help);
+
+    auto check_date = [](const std::string &str) -> std::string {
+        std::istringstream in{str};
+        std::chrono::sys_days tp;
+        std::chrono::from_stream(in, "%F", tp);
+        if (in.fail())
+        {
+            in.clear();
+            in.rdbuf()->pubseekpos(0);
+            std::chrono::from_stream(in, "%Y-%b-%d", tp);
+        }
+        if (in.fail() || in.bad())
+        {
+            return std::format("Error: Unable to parse supplied date: {}", str);
+        }
+
+        auto ymd = static_cast<std::chrono::year_month_day>(tp);
+        if (!ymd.ok())
+        {
+            return std::format("Invalid supplied date: {}", str);
+        }
+        return {};
+    };
+
+    // DB connection parameters
+
+    app_.add_option("--db-host", db_params_.host_name_, "Database host name.")->default_val("localhost");
+
+    app_.add_option("--db-port", db_params_.port_number_, "Database port number.")->default_val(5432);
+
+    app_.add_option("--db-user", db_params_.user_name_, "Database user name.");
+
+    app_.add_option("--db-name", db_params_.db_name_, "Database name.");
+
+    app_.add_option("--db-mode", db_params_.PF_db_mode_, "Database mode: 'test' or 'live'.")
+        ->default_val("test")
+        ->check(CLI::IsMember({"test", "live"}));
+
+    app_.add_option("--stock-db-data-source", db_params_.stock_db_data_source_,
+                    "Stock data source in DB (e.g., 'new_stock_data.current_data').");
+
+    // Logging
+
+    app_.add_option("--log-path", log_file_path_name_, "Path to log file.")->default_val("");
+
+    app_.add_option("--logging-level", logging_level_, "Logging level: 'none', 'error', 'information', 'debug'.")
+        ->default_val("information")
+        ->check(CLI::IsMember({"none", "error", "information", "debug"}));
+
+    // Universe
+
+    auto symbols_source_group =
+        app_.add_option_group("Symbols source", "Backtest symbols from exchanges or a list of symbols. Use 1.");
+    symbols_source_group->require_option(1);
+
+    symbols_source_group->add_option("--exchange-list", exchange_list_, "Symbols from specified exchange(s).")
+        ->delimiter(',')
+        ->transform([](std::string s) {
+            std::transform(s.begin(), s.end(), s.begin(),
+                           [](unsigned char c) { return (c != '/' ? ::toupper(c) : '_'); });
+            return s;
+        });
+
+    symbols_source_group
+        ->add_option("-s,--symbol", symbol_list_, "Symbol to backtest. Repeat (or comma-separate) for more.")
+        ->delimiter(',')
+        ->transform([](std::string s) {
+            std::transform(s.begin(), s.end(), s.begin(), ::toupper);
+            return s;
+        });
+
+    app_.add_option("--min-dollar-volume", min_dollar_volume_,
+                    "Minimum dollar volume to filter stocks on an exchange. Default is $100000")
+        ->default_val("100000");
+
+    app_.add_option("--begin-date", begin_date_, "Start date for extracting data from database.")
+        ->required()
+        ->check(check_date);
+
+    app_.add_option("--end-date", end_date_, "Stop date for extracting data from database.")->check(check_date);
+
+    app_.add_option("--price-fld-name", price_fld_name_, "Data field to use for price value.")
+        ->default_val("split_adj_close");
+
+    // Parameter grid. Every combination is tried.
+
+    app_.add_option("-b,--boxsize", box_size_i_list_, "Box size value. Repeat for multiple values.")->required();
+
+    app_.add_option("-r,--reversal", reversal_boxes_list_, "Reversal boxes count. Repeat for multiple values.")
+        ->required()
+        ->check(CLI::PositiveNumber);
+
+    app_.add_option("--scale", scale_i_list_, "Chart scale: 'linear' or 'percent'. Repeat for multiple scales.")
+        ->default_val("linear")
+        ->check(CLI::IsMember({"linear", "percent"}));
+
+    app_.add_flag("--use-MinMax", use_min_max_,
+                  "Box sizes are modifiers of each symbol's price range over the backtest (like the loader's).");
+
+    // Scoring
+
+    app_.add_option("--horizon", horizons_,
+                    "Number of prices after a signal at which to measure its return. Repeat for multiple values.")
+        ->capture_default_str()
+        ->check(CLI::PositiveNumber);
+
+    app_.add_option("--output", output_file_name_,
+                    "Write results per parameter set and signal type to this CSV file.")
+        ->default_val("");
+
+    // Box size optimizer
+
+    app_.add_option("--optimize-boxsize", optimize_file_name_,
+                    "Instead of backtesting, choose the best box size for each symbol and reversal and scale and write "
+                    "the choices to this file for the loader's --boxsize-file. Box sizes are modifiers of each "
+                    "symbol's price range.")
+        ->default_val("");
+
+    app_.add_option("--boxsize-steps", box_size_steps_,
+                    "Try this many box sizes spaced evenly, in ratio, from the 1st to the 2nd --boxsize. 0 means just "
+                    "the given box sizes.")
+        ->default_val(0)
+        ->check(CLI::NonNegativeNumber);
+
+    app_.add_option("--score", score_i_,
+                    "How to choose a box size: 'columns' (closest to --target-columns), 'column-length' (prices per "
+                    "column closest to --target-column-length) or 'signals' (best signal returns at the shortest "
+                    "--horizon).")
+        ->default_val("columns")
+        ->check(CLI::IsMember({"columns", "column-length", "signals"}));
+
+    app_.add_option("--target-columns", optimizer_settings_.target_columns_, "Number of columns to aim for.")
+        ->default_val(60)
+        ->check(CLI::PositiveNumber);
+
+    app_.add_option("--target-column-length", optimizer_settings_.target_column_length_,
+                    "Average number of prices per column to aim for.")
+        ->default_val(5.0)
+        ->check(CLI::PositiveNumber);
+
+    app_.add_option("--min-signals", optimizer_settings_.min_signals_,
+                    "Fewest measurable signals a box size must have to be chosen by 'signals'.")
+        ->default_val(5)
+        ->check(CLI::PositiveNumber);
+
+    app_.add_option("--backtest-threads", backtest_threads_,
+                    "Number of workers replaying prices through charts. 0 means use default.")
+        ->default_val(0)
+        ->check(CLI::NonNegativeNumber);
+}
+
+bool PF_BacktestApp::CheckArgs()
+{
+    BOOST_ASSERT_MSG(!db_params_.user_name_.empty(), "\nMust provide 'db-user' for backtest.");
+    BOOST_ASSERT_MSG(!db_params_.db_name_.empty(), "\nMust provide 'db-name' for backtest.");
+    BOOST_ASSERT_MSG(!db_params_.stock_db_data_source_.empty(),
+                     "\n'stock-db-data-source' must be specified for backtest.");
+
+    if (!exchange_list_.empty())
+    {
+        rng::sort(exchange_list_);
+        const auto [first, last] = rng::unique(exchange_list_);
+        exchange_list_.erase(first, last);
+
+        PF_DB pf_db{db_params_};
+        auto exchanges = pf_db.ListExchanges();
+
+        rng::for_each(exchange_list_, [&exchanges](const auto &xchng) {
+            BOOST_ASSERT_MSG(rng::find(exchanges, xchng) != exchanges.end(),
+                             std::format("Exchange '{}' not found in database.", xchng).c_str());
+        });
+    }
+
+    if (scale_i_list_.empty())
+    {
+        scale_i_list_.emplace_back("linear");
+    }
+
+    std::vector<decimal::Decimal> box_size_list;
+    for (const auto &b : box_size_i_list_)
+    {
+        box_size_list.emplace_back(b);
+        BOOST_ASSERT_MSG(box_size_list.back() > decimal::Decimal{0},
+                         std::format("\nBox size must be > 0: {}", b).c_str());
+    }
+
+    if (box_size_steps_ > 0)
+    {
+        BOOST_ASSERT_MSG(box_size_list.size() == 2 && box_size_steps_ > 1,
+                         "\n'boxsize-steps' needs 2 box sizes (the ends of the range) and at least 2 steps.");
+
+        // 4 significant digits is plenty and keeps chart names readable.
+
+        const auto low = dec2dbl(box_size_list[0]);
+        const auto ratio = dec2dbl(box_size_list[1]) / low;
+        box_size_list.clear();
+        for (int32_t step = 0; step < box_size_steps_; ++step)
+        {
+            box_size_list.emplace_back(std::format(
+                "{:.4g}", low * std::pow(ratio, static_cast<double>(step) / static_cast<double>(box_size_steps_ - 1))));
+        }
+    }
+    rng::sort(box_size_list);
+    const auto [first_box, last_box] = rng::unique(box_size_list);
+    box_size_list.erase(first_box, last_box);
+
+    for (const auto &[box_size, reversal, scale_i] :
+         vws::cartesian_product(box_size_list, reversal_boxes_list_, scale_i_list_))
+    {
+        grid_.push_back({.box_size_ = box_size,
+                         .reversal_boxes_ = reversal,
+                         .box_scale_ = scale_i == "linear" ? BoxScale::e_Linear : BoxScale::e_Percent});
+    }
+
+    rng::sort(horizons_);
+    const auto [first, last] = rng::unique(horizons_);
+    horizons_.erase(first, last);
+
+    const int32_t cores = std::max(1U, std::thread::hardware_concurrency());
+    backtest_threads_ = backtest_threads_ > 0 ? backtest_threads_ : cores;
+
+    if (end_date_.empty())
+    {
+        auto now = std::chrono::system_clock::now();
+        auto today = std::chrono::year_month_day{std::chrono::floor<std::chrono::days>(now)};
+        end_date_ = std::format("{:%F}", today);
+    }
+
+    if (!optimize_file_name_.empty())
+    {
+        // the same modifiers have to suit symbols priced in cents and in thousands.
+
+        use_min_max_ = true;
+
+        optimizer_settings_.modifiers_ = box_size_list;
+        optimizer_settings_.reversals_ = reversal_boxes_list_;
+        for (const auto &scale_i : scale_i_list_)
+        {
+            optimizer_settings_.scales_.push_back(scale_i == "linear" ? BoxScale::e_Linear : BoxScale::e_Percent);
+        }
+        optimizer_settings_.score_ = score_i_ == "columns"         ? BoxSizeScore::e_columns
+                                     : score_i_ == "column-length" ? BoxSizeScore::e_column_length
+                                                                   : BoxSizeScore::e_signals;
+        optimizer_settings_.horizon_ = horizons_.front();
+
+        spdlog::info(std::format("Choosing from {} box sizes for each symbol, reversal and scale by: {} from: {} to: "
+                                 "{} using {} workers.",
+                                 box_size_list.size(), score_i_, begin_date_, end_date_, backtest_threads_));
+        return true;
+    }
+
+    spdlog::info(std::format("Backtesting {} parameter sets from: {} to: {} using {} workers.", grid_.size(),
+                             begin_date_, end_date_, backtest_threads_));
+
+    return true;
+}
+
+void PF_BacktestApp::Run()
+{
+    PF_DB pf_db{db_params_};
+
+    if (!optimize_file_name_.empty())
+    {
+        RunOptimizer(pf_db);
+        return;
+    }
+
+    Backtester backtester{grid_, horizons_, use_min_max_};
+
+    const auto started = std::chrono::steady_clock::now();
+    int64_t total_symbols = 0;
+    int64_t total_prices = 0;
+
+    // an empty exchange means the symbol list
+
+    const auto universes = exchange_list_.empty() ? std::vector<std::string>{""} : exchange_list_;
+
+    for (const auto &xchng : universes)
+    {
+        const auto universe = LoadPrices(pf_db, xchng);
+        const auto prices = rng::fold_left(universe | vws::transform([](const auto &p) { return p.closes_.size(); }),
+                                           std::size_t{0}, std::plus<>{});
+
+        const auto universe_started = std::chrono::steady_clock::now();
+        backtester.Run(universe, backtest_threads_);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - universe_started;
+
+        spdlog::info(std::format("{}: {} symbols, {} prices replayed through {} parameter sets in {:.1f} seconds.",
+                                 xchng.empty() ? "Symbols" : xchng, universe.size(), prices, grid_.size(),
+                                 elapsed.count()));
+
+        total_symbols += static_cast<int64_t>(universe.size());
+        total_prices += static_cast<int64_t>(prices);
+    }
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - started;
+    spdlog::info(std::format("Backtested {} symbols ({} prices) in {:.1f} seconds.", total_symbols, total_prices,
+                             elapsed.count()));
+
+    ReportResults(backtester);
+}
+
+void PF_BacktestApp::RunOptimizer(const PF_DB &pf_db) const
+{
+    BoxSizeOptimizer optimizer{optimizer_settings_};
+
+    const auto started = std::chrono::steady_clock::now();
+    int64_t total_symbols = 0;
+    std::vector<ChosenBoxSize> chosen;
+
+    const auto universes = exchange_list_.empty() ? std::vector<std::string>{""} : exchange_list_;
+
+    for (const auto &xchng : universes)
+    {
+        const auto universe = LoadPrices(pf_db, xchng);
+
+        const auto universe_started = std::chrono::steady_clock::now();
+        auto chosen_for_universe = optimizer.Run(universe, backtest_threads_);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - universe_started;
+
+        spdlog::info(std::format("{}: {} symbols, {} box sizes chosen in {:.1f} seconds.",
+                                 xchng.empty() ? "Symbols" : xchng, universe.size(), chosen_for_universe.size(),
+                                 elapsed.count()));
+
+        total_symbols += static_cast<int64_t>(universe.size());
+        rng::move(chosen_for_universe, std::back_inserter(chosen));
+    }
+
+    for (const auto &choice : chosen)
+    {
+        spdlog::debug(std::format("{}: reversal: {} scale: {} box size modifier: {} score: {:.4f}.", choice.symbol_,
+                                  choice.reversal_boxes_, choice.box_scale_, choice.box_size_modifier_.format("f"),
+                                  choice.score_));
+    }
+
+    WriteChosenBoxSizes(optimize_file_name_, chosen);
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - started;
+    spdlog::info(std::format("Chose {} box sizes for {} symbols in {:.1f} seconds. Wrote them to: {}.", chosen.size(),
+                             total_symbols, elapsed.count(), optimize_file_name_));
+}
+
+std::vector<BacktestPrices> PF_BacktestApp::LoadPrices(const PF_DB &pf_db, const std::string &exchange) const
+{
+    const auto *dt_format = "%F";
+
+    const auto db_data = exchange.empty() ? pf_db.GetPriceDataForSymbolsInList(symbol_list_, begin_date_, end_date_,
+                                                                                price_fld_name_, dt_format)
+                                          : pf_db.GetPriceDataForSymbolsOnExchange(
+                                                exchange, begin_date_, end_date_, price_fld_name_, dt_format,
+                                                min_dollar_volume_);
+
+    std::vector<BacktestPrices> universe;
+
+    auto data_for_symbol = vws::chunk_by([](const auto &a, const auto &b) { return a.symbol_ == b.symbol_; });
+
+    for (const auto &symbol_rng : db_data | data_for_symbol)
+    {
+        BacktestPrices prices{.symbol_ = symbol_rng[0].symbol_};
+        prices.dates_.reserve(symbol_rng.size());
+        prices.closes_.reserve(symbol_rng.size());
+        prices.closes_dbl_.reserve(symbol_rng.size());
+        for (const auto &row : symbol_rng)
+        {
+            prices.dates_.push_back(row.date_);
+            prices.closes_.push_back(row.close_);
+            prices.closes_dbl_.push_back(dec2dbl(row.close_));
+        }
+        const auto [min_close, max_close] = rng::minmax(prices.closes_);
+        prices.range_ = max_close - min_close;
+        universe.push_back(std::move(prices));
+    }
+    return universe;
+}
+
+void PF_BacktestApp::ReportResults(const Backtester &backtester) const
+{
+    const auto &horizons = backtester.GetHorizons();
+
+    // 1 line per parameter set for all its signals together
+
+    for (const auto &result : backtester.GetResults())
+    {
+        SignalOutcomes all_signals;
+        all_signals.evaluated_.resize(horizons.size());
+        all_signals.wins_.resize(horizons.size());
+        all_signals.return_sum_.resize(horizons.size());
+        all_signals.return_sq_sum_.resize(horizons.size());
+        for (const auto &outcomes : result.by_signal_type_)
+        {
+            all_signals += outcomes;
+        }
+
+        std::string by_horizon;
+        for (std::size_t horizon = 0; horizon < horizons.size(); ++horizon)
+        {
+            const auto stats = StatsForHorizon(all_signals, horizon);
+            std::format_to(std::back_inserter(by_horizon), " {}: {:.2f}% avg, {:.1f}% wins.", horizons[horizon],
+                           stats.mean_ * 100.0, stats.win_rate_ * 100.0);
+        }
+        spdlog::info(std::format("Box size: {} reversal: {} scale: {}. Charts: {} ({} failed). Signals: {}.{}",
+                                 result.params_.box_size_.format("f"), result.params_.reversal_boxes_,
+                                 result.params_.box_scale_, result.charts_, result.charts_failed_, all_signals.signals_,
+                                 by_horizon));
+    }
+
+    if (output_file_name_.empty())
+    {
+        return;
+    }
+
+    std::ofstream output{output_file_name_, std::ios::out | std::ios::trunc};
+    BOOST_ASSERT_MSG(output.is_open(),
+                     std::format("Unable to open file: {} for backtest results.", output_file_name_).c_str());
+
+    output << "box_size,reversal,scale,signal_type,signals,horizon,evaluated,mean_return,std_dev,win_rate\n";
+    for (const auto &result : backtester.GetResults())
+    {
+        for (std::size_t which = 1; which < result.by_signal_type_.size(); ++which)
+        {
+            const auto &outcomes = result.by_signal_type_[which];
+            for (std::size_t horizon = 0; horizon < horizons.size(); ++horizon)
+            {
+                const auto stats = StatsForHorizon(outcomes, horizon);
+                output << std::format("{},{},{},{},{},{},{},{:.6f},{:.6f},{:.4f}\n",
+                                      result.params_.box_size_.format("f"), result.params_.reversal_boxes_,
+                                      result.params_.box_scale_, static_cast<PF_SignalType>(which), outcomes.signals_,
+                                      horizons[horizon], outcomes.evaluated_[horizon], stats.mean_, stats.std_dev_,
+                                      stats.win_rate_);
+            }
+        }
+    }
+}
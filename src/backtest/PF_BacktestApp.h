@@ -0,0 +1,78 @@
+#ifndef PF_BACKTESTAPP_INC
+#define PF_BACKTESTAPP_INC
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "backtest/Backtest.h"
+#include "backtest/BoxSizeOptimizer.h"
+#include "common/PF_AppBase.h"
+
+// =====================================================================================
+//        Class:  PF_BacktestApp
+//  Description:  sweeps a grid of box sizes, reversals and scales over the price
+//                history of a universe of symbols and reports how the signals each
+//                combination sets off worked out. See Backtester.
+//
+//  Prices are read from the DB an exchange (or symbol list) at a time and shared by
+//  all the parameter sets. Results are logged per parameter set and, with --output,
+//  written per parameter set and signal type as CSV.
+//
+//  With --optimize-boxsize it picks a box size for each symbol instead (see
+//  BoxSizeOptimizer) and writes the choices where the loader's --boxsize-file can
+//  read them.
+// =====================================================================================
+
+class PF_BacktestApp : public PF_AppBase
+{
+public:
+    PF_BacktestApp(int argc, char *argv[]);
+    explicit PF_BacktestApp(const std::vector<std::string> &tokens);
+
+    PF_BacktestApp() = delete;
+    PF_BacktestApp(const PF_BacktestApp &) = delete;
+    PF_BacktestApp(PF_BacktestApp &&) = delete;
+
+    bool Startup();
+    void Run();
+    void Shutdown();
+
+    PF_BacktestApp &operator=(const PF_BacktestApp &) = delete;
+    PF_BacktestApp &operator=(PF_BacktestApp &&) = delete;
+
+private:
+    void SetupProgramOptions();
+    bool CheckArgs();
+
+    [[nodiscard]] std::vector<BacktestPrices> LoadPrices(const PF_DB &pf_db, const std::string &exchange) const;
+    void ReportResults(const Backtester &backtester) const;
+    void RunOptimizer(const PF_DB &pf_db) const;
+
+    std::vector<std::string> exchange_list_;
+    std::vector<std::string> symbol_list_;
+    std::string min_dollar_volume_;
+    std::string begin_date_;
+    std::string end_date_;
+    std::string price_fld_name_;
+
+    std::vector<std::string> box_size_i_list_;
+    std::vector<std::string> scale_i_list_;
+    std::vector<int32_t> reversal_boxes_list_;
+    std::vector<BacktestParams> grid_;
+    std::vector<int32_t> horizons_{5, 20, 60};
+
+    fs::path output_file_name_;
+
+    // box size optimizer
+
+    fs::path optimize_file_name_;
+    std::string score_i_;
+    BoxSizeOptimizerSettings optimizer_settings_;
+
+    int32_t backtest_threads_ = 0;
+    int32_t box_size_steps_ = 0;
+    bool use_min_max_ = false;
+};
+
+#endif
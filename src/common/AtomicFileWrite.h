@@ -0,0 +1,44 @@
+#ifndef PF_ATOMICFILEWRITE_INC
+#define PF_ATOMICFILEWRITE_INC
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <system_error>
+
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+// replaces 'output_filename' all at once. write(temp_file) makes the whole file under a
+// temporary name in the same directory which is then renamed over the real one so
+// anybody looking at the directory sees the old file or the new one, never part of one.
+// A write which fails (or throws) leaves the old file alone.
+//
+// The temporary keeps the real file's extension since ChartDirector picks the graphic
+// format from it. It starts with a '.' so it doesn't look like output while it's being
+// written.
+
+template <typename Write> void WriteFileAtomically(const fs::path &output_filename, Write write)
+{
+    static std::atomic<uint64_t> temp_file_counter{0};
+
+    const fs::path temp_file =
+        output_filename.parent_path() / std::format(".{}.{}-{}.tmp{}", output_filename.stem().string(), ::getpid(),
+                                                    temp_file_counter++, output_filename.extension().string());
+    try
+    {
+        write(temp_file);
+        fs::rename(temp_file, output_filename);
+    }
+    catch (...)
+    {
+        std::error_code ec;
+        fs::remove(temp_file, ec);
+        throw;
+    }
+}
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef PF_BOUNDEDQUEUE_INC
+#define PF_BOUNDEDQUEUE_INC
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+// a simple multi-producer/multi-consumer FIFO with a fixed capacity.
+// Push blocks while the queue is full which gives us backpressure between
+// pipeline stages so a fast producer can't run away from a slow consumer.
+// Close wakes everybody up. Once closed, Push is refused and Pop drains
+// whatever is left then returns an empty optional.
+
+template <typename T> class BoundedQueue
+{
+public:
+    explicit BoundedQueue(std::size_t capacity) : capacity_{capacity > 0 ? capacity : 1} {}
+
+    BoundedQueue() = delete;
+    BoundedQueue(const BoundedQueue &) = delete;
+    BoundedQueue(BoundedQueue &&) = delete;
+    ~BoundedQueue() = default;
+
+    BoundedQueue &operator=(const BoundedQueue &) = delete;
+    BoundedQueue &operator=(BoundedQueue &&) = delete;
+
+    bool Push(T value)
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        not_full_.wait(lock, [this] { return closed_ || items_.size() < capacity_; });
+        if (closed_)
+        {
+            return false;
+        }
+        items_.push_back(std::move(value));
+        lock.unlock();
+        not_empty_.notify_one();
+        return true;
+    }
+
+    std::optional<T> Pop()
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        not_empty_.wait(lock, [this] { return closed_ || !items_.empty(); });
+        if (items_.empty())
+        {
+            return {};
+        }
+        std::optional<T> result{std::move(items_.front())};
+        items_.pop_front();
+        lock.unlock();
+        not_full_.notify_one();
+        return result;
+    }
+
+    void Close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            closed_ = true;
+        }
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+
+    [[nodiscard]] std::size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return items_.size();
+    }
+
+    [[nodiscard]] std::size_t capacity() const { return capacity_; }
+
+private:
+    mutable std::mutex mtx_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::deque<T> items_;
+    const std::size_t capacity_;
+    bool closed_ = false;
+};
+
+#endif
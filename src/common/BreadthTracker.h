@@ -0,0 +1,152 @@
+#ifndef PF_BREADTHTRACKER_INC
+#define PF_BREADTHTRACKER_INC
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <utility>
+
+#include "PF_Chart.h"
+#include "PF_Column.h"
+#include "PF_Signals.h"
+
+// =====================================================================================
+//        Class:  BreadthTracker
+//  Description:  P&F market breadth for groups of charts (exchanges, usually) kept up
+//                to date as the charts change instead of by looking at all of them
+//                again:
+//
+//      bullish percent: charts whose most recent signal is a buy.
+//      percent in X:    charts whose current column is X's.
+//
+//  A chart's part in this is its ChartBreadthState. Whoever changes a chart takes
+//  its state before and after and, if AddValue did anything, hands both to Update
+//  which moves the chart between the counters. That is a few adds no matter how
+//  many charts there are.
+//
+//  Add all the groups before more than 1 thread starts using the tracker. After that
+//  Update and GetTally can be called from any number of threads. A tally taken while others are updating may be
+//  off by the updates in flight, which is fine for something sampled now and then.
+// =====================================================================================
+
+struct ChartBreadthState
+{
+    bool counted_ = false; // empty charts aren't
+    bool in_x_column_ = false;
+    bool on_buy_signal_ = false;
+
+    [[nodiscard]] static ChartBreadthState ForChart(const PF_Chart &chart)
+    {
+        const auto &signals = chart.GetSignals();
+        return {.counted_ = !chart.empty(),
+                .in_x_column_ = chart.GetCurrentDirection() == PF_Column::Direction::e_Up,
+                .on_buy_signal_ = !signals.empty() && signals.back().signal_category_ == PF_SignalCategory::e_PF_Buy};
+    }
+
+    bool operator==(const ChartBreadthState &rhs) const = default;
+};
+
+struct BreadthTally
+{
+    int64_t charts_ = 0;
+    int64_t in_x_columns_ = 0;
+    int64_t on_buy_signal_ = 0;
+
+    [[nodiscard]] double PercentInXColumns() const
+    {
+        return charts_ == 0 ? 0.0 : 100.0 * static_cast<double>(in_x_columns_) / static_cast<double>(charts_);
+    }
+    [[nodiscard]] double BullishPercent() const
+    {
+        return charts_ == 0 ? 0.0 : 100.0 * static_cast<double>(on_buy_signal_) / static_cast<double>(charts_);
+    }
+
+    BreadthTally &operator+=(const BreadthTally &rhs)
+    {
+        charts_ += rhs.charts_;
+        in_x_columns_ += rhs.in_x_columns_;
+        on_buy_signal_ += rhs.on_buy_signal_;
+        return *this;
+    }
+};
+
+class BreadthTracker
+{
+public:
+    // returns the group's ID for AddChart and Update.
+
+    std::size_t AddGroup(std::string name)
+    {
+        groups_.emplace_back(std::move(name));
+        return groups_.size() - 1;
+    }
+
+    [[nodiscard]] std::size_t GroupCount() const
+    {
+        return groups_.size();
+    }
+    [[nodiscard]] const std::string &GroupName(std::size_t group) const
+    {
+        return groups_[group].name_;
+    }
+
+    void AddChart(std::size_t group, const ChartBreadthState &state)
+    {
+        Update(group, ChartBreadthState{}, state);
+    }
+
+    void Update(std::size_t group, const ChartBreadthState &before, const ChartBreadthState &after)
+    {
+        if (before == after)
+        {
+            return;
+        }
+        auto change = [](bool was, bool is) { return static_cast<int64_t>(is) - static_cast<int64_t>(was); };
+
+        auto &counters = groups_[group];
+        counters.charts_.fetch_add(change(before.counted_, after.counted_), std::memory_order_relaxed);
+        counters.in_x_columns_.fetch_add(
+            change(before.counted_ && before.in_x_column_, after.counted_ && after.in_x_column_),
+            std::memory_order_relaxed);
+        counters.on_buy_signal_.fetch_add(
+            change(before.counted_ && before.on_buy_signal_, after.counted_ && after.on_buy_signal_),
+            std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] BreadthTally GetTally(std::size_t group) const
+    {
+        const auto &counters = groups_[group];
+        return {.charts_ = counters.charts_.load(std::memory_order_relaxed),
+                .in_x_columns_ = counters.in_x_columns_.load(std::memory_order_relaxed),
+                .on_buy_signal_ = counters.on_buy_signal_.load(std::memory_order_relaxed)};
+    }
+
+    [[nodiscard]] BreadthTally GetTotal() const
+    {
+        BreadthTally total;
+        for (std::size_t group = 0; group < groups_.size(); ++group)
+        {
+            total += GetTally(group);
+        }
+        return total;
+    }
+
+private:
+    // deque so the atomics never move as groups are added.
+
+    struct Counters
+    {
+        explicit Counters(std::string name) : name_{std::move(name)} {}
+
+        std::string name_;
+        std::atomic<int64_t> charts_ = 0;
+        std::atomic<int64_t> in_x_columns_ = 0;
+        std::atomic<int64_t> on_buy_signal_ = 0;
+    };
+
+    std::deque<Counters> groups_;
+};
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef PF_CHOSENBOXSIZES_INC
+#define PF_CHOSENBOXSIZES_INC
+
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <decimal.hh>
+
+#include "Boxes.h"
+#include "common/AtomicFileWrite.h"
+
+namespace fs = std::filesystem;
+
+// the chart parameters picked for each symbol by 'pf_backtest --optimize-boxsize' and
+// read back by the loader (--boxsize-file). The file is CSV, 1 line per chart:
+//
+//      symbol,scale,reversal,base_box_size,box_size_modifier,score
+//
+// and each line becomes PF_Chart{symbol, base_box_size, reversal, box_size_modifier, scale}.
+// The score is only there so a person can see how clear the choice was.
+
+struct ChosenBoxSize
+{
+    std::string symbol_;
+    decimal::Decimal base_box_size_;
+    decimal::Decimal box_size_modifier_;
+    int32_t reversal_boxes_ = 0;
+    BoxScale box_scale_ = BoxScale::e_Linear;
+    double score_ = 0.0;
+};
+
+using ChosenBoxSizesForSymbols = std::map<std::string, std::vector<ChosenBoxSize>>;
+
+inline void WriteChosenBoxSizes(const fs::path &file_name, const std::vector<ChosenBoxSize> &chosen)
+{
+    // the loader may be reading last night's file while we make tonight's.
+
+    WriteFileAtomically(file_name, [&chosen](const fs::path &temp_file) {
+        std::ofstream output{temp_file, std::ios::out | std::ios::trunc};
+        if (!output.is_open())
+        {
+            throw std::runtime_error(std::format("Unable to open file: {} for chosen box sizes.", temp_file));
+        }
+        output << "symbol,scale,reversal,base_box_size,box_size_modifier,score\n";
+        for (const auto &choice : chosen)
+        {
+            output << std::format("{},{},{},{},{},{:.6f}\n", choice.symbol_, choice.box_scale_,
+                                  choice.reversal_boxes_, choice.base_box_size_.format("f"),
+                                  choice.box_size_modifier_.format("f"), choice.score_);
+        }
+        output.close();
+        if (output.fail())
+        {
+            throw std::runtime_error(std::format("Unable to write chosen box sizes to file: {}.", temp_file));
+        }
+    });
+}
+
+inline ChosenBoxSizesForSymbols ReadChosenBoxSizes(const fs::path &file_name)
+{
+    std::ifstream input{file_name};
+    if (!input.is_open())
+    {
+        throw std::runtime_error(std::format("Unable to open chosen box sizes file: {}.", file_name));
+    }
+
+    ChosenBoxSizesForSymbols chosen;
+
+    std::string line;
+    int32_t line_number = 0;
+    while (std::getline(input, line))
+    {
+        ++line_number;
+        if (line.empty() || line.starts_with("symbol,"))
+        {
+            continue;
+        }
+
+        std::vector<std::string> fields;
+        std::istringstream line_stream{line};
+        for (std::string field; std::getline(line_stream, field, ',');)
+        {
+            fields.push_back(field);
+        }
+        if (fields.size() != 6 || (fields[1] != "linear" && fields[1] != "percent"))
+        {
+            throw std::runtime_error(
+                std::format("Bad chosen box size at line: {} of file: {}: '{}'.", line_number, file_name, line));
+        }
+
+        ChosenBoxSize choice{.symbol_ = fields[0],
+                             .base_box_size_ = decimal::Decimal{fields[3]},
+                             .box_size_modifier_ = decimal::Decimal{fields[4]},
+                             .reversal_boxes_ = std::stoi(fields[2]),
+                             .box_scale_ = fields[1] == "linear" ? BoxScale::e_Linear : BoxScale::e_Percent,
+                             .score_ = std::stod(fields[5])};
+        chosen[choice.symbol_].push_back(std::move(choice));
+    }
+    return chosen;
+}
+
+#endif
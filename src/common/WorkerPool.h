@@ -0,0 +1,79 @@
+#ifndef PF_WORKERPOOL_INC
+#define PF_WORKERPOOL_INC
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <ranges>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "common/BoundedQueue.h"
+
+// calls work(item) for each item in 'items' on 'how_many' threads.
+//
+// Items are handed out through a BoundedQueue a couple of items deep per thread so
+// a thread which gets a big one doesn't hold up the rest and nothing is handed out
+// far ahead of the threads. work gets a reference to the item itself, not a copy.
+//
+// work runs concurrently with itself so it must only touch its own item (and things
+// which are safe to share). It should catch what it can live without. Anything which
+// gets out stops more items from being handed out and is rethrown here once all the
+// threads are done.
+
+template <typename Items, typename Work> void ForEachOnWorkerPool(Items &items, int32_t how_many, Work work)
+{
+    using Item = std::remove_reference_t<std::ranges::range_reference_t<Items>>;
+
+    const auto thread_count = static_cast<std::size_t>(std::max(1, how_many));
+    BoundedQueue<Item *> queue{thread_count * 2};
+
+    std::mutex problem_mtx;
+    std::exception_ptr problem;
+
+    auto worker = [&]() {
+        while (auto item = queue.Pop())
+        {
+            try
+            {
+                work(**item);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(problem_mtx);
+                if (!problem)
+                {
+                    problem = std::current_exception();
+                }
+                queue.Close();
+            }
+        }
+    };
+
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve(thread_count);
+        for (std::size_t ndx = 0; ndx < thread_count; ++ndx)
+        {
+            workers.emplace_back(worker);
+        }
+        for (auto &item : items)
+        {
+            if (!queue.Push(&item))
+            {
+                break;
+            }
+        }
+        queue.Close();
+    }
+
+    if (problem)
+    {
+        std::rethrow_exception(problem);
+    }
+}
+
+#endif
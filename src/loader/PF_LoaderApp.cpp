@@ -1,13 +1,17 @@
 #include "loader/PF_LoaderApp.h"
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <format>
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <ranges>
 #include <sstream>
+#include <stdexcept>
 #include <string_view>
+#include <thread>
 
 namespace rng = std::ranges;
 namespace vws = std::ranges::views;
@@ -19,12 +23,19 @@ namespace vws = std::ranges::views;
 #include "PF_Chart.h"
 #include "PF_Column.h"
 #include "PointAndFigureDB.h"
+#include "common/AtomicFileWrite.h"
+#include "common/BoundedQueue.h"
+#include "common/WorkerPool.h"
 #include "utilities.h"
 
 using decimal::Decimal;
 using namespace std::string_literals;
 using namespace std::string_view_literals;
 
+// used in the progress journal for symbols given on the command line
+
+constexpr auto kNoExchange = "-"sv;
+
 // =====================================================================================
 //        Class:  PF_LoaderApp
 //  Description:  Load mode — builds charts from file or database source
@@ -84,13 +95,19 @@ std::tuple<int, int, int> PF_LoaderApp::Run()
 
 void PF_LoaderApp::Shutdown()
 {
-    if (destination_ == Destination::e_file)
-    {
-        ShutdownAndStoreOutputInFiles();
-    }
-    else
+    // when the load pipeline is used, charts are stored as they are built
+    // so there may be nothing left to do here.
+
+    if (!charts_.empty())
     {
-        ShutdownAndStoreOutputInDB();
+        if (destination_ == Destination::e_file)
+        {
+            ShutdownAndStoreOutputInFiles();
+        }
+        else
+        {
+            ShutdownAndStoreOutputInDB();
+        }
     }
 
     spdlog::info(std::format("\n\n*** End run {}  ***\n",
@@ -219,16 +236,23 @@ void PF_LoaderApp::SetupProgramOptions()
 
     // Box size and reversal
 
-    app_.add_option("-b,--boxsize", box_size_i_list_, "Box size value. Repeat for multiple values.")->required();
+    app_.add_option("-b,--boxsize", box_size_i_list_, "Box size value. Repeat for multiple values.");
+
+    app_.add_option("-r,--reversal", reversal_boxes_list_, "Reversal boxes count. Repeat for multiple values.");
 
-    app_.add_option("-r,--reversal", reversal_boxes_list_, "Reversal boxes count. Repeat for multiple values.")
-        ->required();
+    app_.add_option("--boxsize-file", boxsize_file_name_,
+                    "Build the charts chosen for each symbol by 'pf_backtest --optimize-boxsize' instead of using "
+                    "'boxsize', 'reversal' and 'scale'. Symbols not in the file are skipped.");
 
     // Graphics and ATR options
 
     app_.add_option("--graphics-format", graphics_format_i_, "Graphics format: 'svg' or 'csv'.")
         ->default_val("svg")
         ->check(CLI::IsMember({"svg", "csv"}));
+    app_.add_option("--renderer", renderer_i_,
+                    "What draws 'svg' graphics: 'chartdirector' or 'native' (built in, no ChartDirector).")
+        ->default_val("chartdirector")
+        ->check(CLI::IsMember({"chartdirector", "native"}));
 
     app_.add_flag("--use-ATR", use_ATR_, "Use ATR-based box size calculation.");
 
@@ -278,6 +302,34 @@ void PF_LoaderApp::SetupProgramOptions()
     app_.add_option("--chart-data-source", chart_data_source_, "Chart data source: 'file' or 'database'.")
         ->default_val("file")
         ->check(CLI::IsMember({"file", "database"}));
+
+    // DB load pipeline options
+
+    app_.add_option("--pipeline-queue-depth", pipeline_queue_depth_,
+                    "Max items waiting between DB load pipeline stages. 0 builds all charts in memory and stores them "
+                    "at shutdown.")
+        ->default_val(32)
+        ->check(CLI::NonNegativeNumber);
+
+    app_.add_option("--fetch-threads", fetch_threads_, "Number of DB price fetch workers. 0 means use default.")
+        ->default_val(0)
+        ->check(CLI::NonNegativeNumber);
+
+    app_.add_option("--build-threads", build_threads_, "Number of chart build workers. 0 means use default.")
+        ->default_val(0)
+        ->check(CLI::NonNegativeNumber);
+
+    app_.add_flag("--resume", resume_mode_,
+                  "Skip symbols recorded as completed in the progress journal by an earlier, interrupted DB load.");
+
+    app_.add_option("--progress-journal", progress_journal_path_,
+                    "Path to DB load progress journal. Default is 'PF_Loader_progress.txt' in output chart dir or "
+                    "config dir.");
+
+    app_.add_option("--serialize-threads", serialize_threads_,
+                    "Number of chart serialize/graphics workers. 0 means use default.")
+        ->default_val(0)
+        ->check(CLI::NonNegativeNumber);
 }
 
 bool PF_LoaderApp::CheckArgs()
@@ -290,9 +342,23 @@ bool PF_LoaderApp::CheckArgs()
         PF_CollectDataConfigDir_ = env_var == nullptr ? "" : env_var;
     }
 
-    boxsize_source_ = (use_min_max_ ? BoxsizeSource::e_from_MinMax
-                       : use_ATR_   ? BoxsizeSource::e_from_ATR
-                                    : BoxsizeSource::e_from_args);
+    boxsize_source_ = (!boxsize_file_name_.empty() ? BoxsizeSource::e_from_optimizer
+                       : use_min_max_              ? BoxsizeSource::e_from_MinMax
+                       : use_ATR_                  ? BoxsizeSource::e_from_ATR
+                                                   : BoxsizeSource::e_from_args);
+
+    if (boxsize_source_ == BoxsizeSource::e_from_optimizer)
+    {
+        BOOST_ASSERT_MSG(!use_ATR_ && !use_min_max_, "\n'boxsize-file' can't be used with 'use-ATR' or 'use-MinMax'.");
+        chosen_box_sizes_ = ReadChosenBoxSizes(boxsize_file_name_);
+        spdlog::info(std::format("Using box sizes chosen for {} symbols from: {}.", chosen_box_sizes_.size(),
+                                 boxsize_file_name_));
+    }
+    else
+    {
+        BOOST_ASSERT_MSG(!box_size_i_list_.empty() && !reversal_boxes_list_.empty(),
+                         "\nMust provide 'boxsize' and 'reversal' values (or a 'boxsize-file').");
+    }
 
     // MinMax requires specific symbols (can't compute for ALL)
     if (use_min_max_ && symbol_list_i_ == "ALL")
@@ -334,6 +400,7 @@ bool PF_LoaderApp::CheckArgs()
     }
 
     graphics_format_ = graphics_format_i_ == "svg" ? GraphicsFormat::e_svg : GraphicsFormat::e_csv;
+    renderer_ = renderer_i_ == "native" ? GraphicsRenderer::e_native : GraphicsRenderer::e_chartdirector;
 
     if (destination_ == Destination::e_file)
     {
@@ -397,6 +464,25 @@ bool PF_LoaderApp::CheckArgs()
 
     BOOST_ASSERT_MSG(max_columns_for_graph_ >= -1, "\nmax-graphic-cols must be >= -1.");
 
+    // keep the DB side modest by default. Chart building is CPU bound so it gets the cores.
+
+    const int32_t cores = std::max(1U, std::thread::hardware_concurrency());
+    fetch_threads_ = fetch_threads_ > 0 ? fetch_threads_ : std::min(4, cores);
+    build_threads_ = build_threads_ > 0 ? build_threads_ : cores;
+    serialize_threads_ = serialize_threads_ > 0 ? serialize_threads_ : std::max(1, cores / 2);
+
+    if (new_data_source_ == Source::e_DB)
+    {
+        BOOST_ASSERT_MSG(!resume_mode_ || pipeline_queue_depth_ > 0,
+                         "\n'resume' requires 'pipeline-queue-depth' > 0 so charts are stored as they are built.");
+        if (progress_journal_path_.empty())
+        {
+            progress_journal_path_ =
+                (destination_ == Destination::e_file ? output_chart_directory_ : PF_CollectDataConfigDir_) /
+                "PF_Loader_progress.txt";
+        }
+    }
+
     const std::map<std::string, Interval> possible_intervals = {{"eod", Interval::e_eod},   {"live", Interval::e_live},
                                                                 {"sec1", Interval::e_sec1}, {"sec5", Interval::e_sec5},
                                                                 {"min1", Interval::e_min1}, {"min5", Interval::e_min5}};
@@ -437,11 +523,7 @@ bool PF_LoaderApp::CheckArgs()
 
 void PF_LoaderApp::Run_Load()
 {
-    auto params = vws::cartesian_product(symbol_list_, box_size_list_, reversal_boxes_list_, scale_list_);
-
-    for (const auto &val : params)
-    {
-        const auto &symbol = std::get<PF_Chart::e_symbol>(val);
+    auto load_from_file = [this](const std::string &symbol, PF_Chart &&new_chart) {
         try
         {
             fs::path symbol_file_name =
@@ -451,6 +533,34 @@ void PF_LoaderApp::Run_Load()
                 std::format("\nCan't find data file: {} for symbol: {}.", symbol_file_name, symbol).c_str());
             BOOST_ASSERT_MSG(source_format_ == SourceFormat::e_csv,
                              "\nJSON files are not yet supported for loading symbol data.");
+            AddPriceDataToExistingChartCSV(new_chart, symbol_file_name);
+            charts_.emplace_back(std::make_pair(symbol, std::move(new_chart)));
+        }
+        catch (const std::exception &e)
+        {
+            spdlog::error(std::format("Unable to load data for symbol: {} from file because: {}.", symbol, e.what()));
+        }
+    };
+
+    if (boxsize_source_ == BoxsizeSource::e_from_optimizer)
+    {
+        for (const auto &symbol : RemoveSymbolsWithoutChosenBoxSizes(symbol_list_))
+        {
+            for (auto &new_chart : MakeChartsFromChosenBoxSizes(symbol))
+            {
+                load_from_file(symbol, std::move(new_chart));
+            }
+        }
+        return;
+    }
+
+    auto params = vws::cartesian_product(symbol_list_, box_size_list_, reversal_boxes_list_, scale_list_);
+
+    for (const auto &val : params)
+    {
+        const auto &symbol = std::get<PF_Chart::e_symbol>(val);
+        try
+        {
             auto atr = use_ATR_ ? ComputeATRForChart(symbol) : 0;
             PF_Chart new_chart;
             if (use_ATR_)
@@ -461,8 +571,7 @@ void PF_LoaderApp::Run_Load()
             {
                 new_chart = PF_Chart{val, atr, max_columns_for_graph_ < 1 ? -1 : max_columns_for_graph_};
             }
-            AddPriceDataToExistingChartCSV(new_chart, symbol_file_name);
-            charts_.emplace_back(std::make_pair(symbol, new_chart));
+            load_from_file(symbol, std::move(new_chart));
         }
         catch (const std::exception &e)
         {
@@ -477,6 +586,11 @@ std::tuple<int, int, int> PF_LoaderApp::Run_LoadFromDB()
     int32_t total_charts_processed = 0;
     int32_t total_charts_updated = 0;
 
+    if (pipeline_queue_depth_ > 0)
+    {
+        OpenProgressJournal();
+    }
+
     if (symbol_list_i_ == "ALL")
     {
         PF_DB pf_db{db_params_};
@@ -519,7 +633,12 @@ std::tuple<int, int, int> PF_LoaderApp::Run_LoadFromDB()
                                      xchng, min_dollar_volume_));
 
             auto symbol_list = pf_db.ListSymbolsOnExchange(xchng, min_dollar_volume_);
-            const auto counts = ProcessSymbolsFromDB(symbol_list);
+            if (boxsize_source_ == BoxsizeSource::e_from_optimizer)
+            {
+                symbol_list = RemoveSymbolsWithoutChosenBoxSizes(symbol_list);
+            }
+            const auto counts = pipeline_queue_depth_ > 0 ? ProcessSymbolsFromDBPipeline(xchng, symbol_list)
+                                                          : ProcessSymbolsFromDB(symbol_list);
             total_symbols_processed += std::get<0>(counts);
             total_charts_processed += std::get<1>(counts);
             total_charts_updated += std::get<2>(counts);
@@ -530,7 +649,11 @@ std::tuple<int, int, int> PF_LoaderApp::Run_LoadFromDB()
     }
     else
     {
-        const auto counts = ProcessSymbolsFromDB(symbol_list_);
+        const auto symbol_list = boxsize_source_ == BoxsizeSource::e_from_optimizer
+                                     ? RemoveSymbolsWithoutChosenBoxSizes(symbol_list_)
+                                     : symbol_list_;
+        const auto counts = pipeline_queue_depth_ > 0 ? ProcessSymbolsFromDBPipeline(kNoExchange, symbol_list)
+                                                      : ProcessSymbolsFromDB(symbol_list);
         total_symbols_processed += std::get<0>(counts);
         total_charts_processed += std::get<1>(counts);
         total_charts_updated += std::get<2>(counts);
@@ -553,6 +676,206 @@ std::tuple<int, int, int> PF_LoaderApp::ProcessSymbolsFromDB(const std::vector<s
 
     pqxx::connection c{std::format("dbname={} user={}", db_params_.db_name_, db_params_.user_name_)};
 
+    for (const auto &symbol : symbol_list)
+    {
+        ++total_symbols_processed;
+
+        try
+        {
+            const auto price_series = FetchPriceSeriesFromDB(pf_db, c, symbol);
+            for (auto &new_chart : BuildChartsForPriceSeries(price_series))
+            {
+                charts_.emplace_back(std::make_pair(symbol, std::move(new_chart)));
+                ++total_charts_processed;
+            }
+        }
+        catch (const std::exception &e)
+        {
+            spdlog::error(std::format("Unable to retrieve data for symbol: {} from DB because: {}.", symbol, e.what()));
+        }
+    }
+    return {total_symbols_processed, total_charts_processed, total_charts_updated};
+}
+
+std::tuple<int, int, int> PF_LoaderApp::ProcessSymbolsFromDBPipeline(std::string_view exchange,
+                                                                      const std::vector<std::string> &all_symbols)
+{
+    // same work as ProcessSymbolsFromDB but run as 4 bounded stages:
+    //
+    //  fetch (DB reads) -> build (charts) -> serialize (json/graphics) -> store (files or DB)
+    //
+    // Each hand-off is a BoundedQueue so a fast stage blocks instead of piling up
+    // charts in memory. Peak memory depends on the queue depth, not on how many
+    // symbols we load, and DB reads, chart computation and writes all overlap.
+
+    std::atomic<int32_t> total_symbols_processed = 0;
+    std::atomic<int32_t> total_charts_processed = 0;
+    int32_t total_charts_updated = 0;
+
+    const auto symbol_list = RemoveCompletedSymbols(exchange, all_symbols);
+    if (symbol_list.size() < all_symbols.size())
+    {
+        spdlog::info(std::format("Resuming load for: {}. Skipping {} symbols already completed.", exchange,
+                                 all_symbols.size() - symbol_list.size()));
+    }
+
+    // charts travel with the number of charts requested for their symbol so the
+    // store step knows when a symbol is done and can checkpoint it. A chart which
+    // fails to build, serialize or store never gets counted so its symbol is
+    // never checkpointed and is redone on resume.
+
+    BoundedQueue<PriceSeries> price_queue{static_cast<size_t>(pipeline_queue_depth_)};
+    BoundedQueue<std::pair<PF_Chart, int32_t>> chart_queue{static_cast<size_t>(pipeline_queue_depth_)};
+    BoundedQueue<SerializedChart> output_queue{static_cast<size_t>(pipeline_queue_depth_)};
+
+    std::atomic<size_t> next_symbol = 0;
+
+    auto fetch_prices = [&]() {
+        try
+        {
+            PF_DB pf_db{db_params_};
+            pqxx::connection c{std::format("dbname={} user={}", db_params_.db_name_, db_params_.user_name_)};
+
+            for (auto ndx = next_symbol++; ndx < symbol_list.size() && !PF_AppBase::SignalReceived();
+                 ndx = next_symbol++)
+            {
+                const auto &symbol = symbol_list[ndx];
+                ++total_symbols_processed;
+                try
+                {
+                    if (!price_queue.Push(FetchPriceSeriesFromDB(pf_db, c, symbol)))
+                    {
+                        break;
+                    }
+                }
+                catch (const std::exception &e)
+                {
+                    spdlog::error(
+                        std::format("Unable to retrieve data for symbol: {} from DB because: {}.", symbol, e.what()));
+                }
+            }
+        }
+        catch (const std::exception &e)
+        {
+            spdlog::error(std::format("Problem in DB price fetch stage: {}.", e.what()));
+        }
+    };
+
+    auto build_charts = [&]() {
+        while (auto price_series = price_queue.Pop())
+        {
+            auto new_charts = BuildChartsForPriceSeries(*price_series);
+            const auto charts_for_symbol = CountChartsRequestedForSymbol(price_series->symbol_);
+            if (static_cast<int32_t>(new_charts.size()) < charts_for_symbol)
+            {
+                spdlog::error(std::format("Built only {} of {} charts for symbol: {}. It will be retried on resume.",
+                                          new_charts.size(), charts_for_symbol, price_series->symbol_));
+            }
+            for (auto &new_chart : new_charts)
+            {
+                ++total_charts_processed;
+                chart_queue.Push({std::move(new_chart), charts_for_symbol});
+            }
+        }
+    };
+
+    auto serialize_charts = [&]() {
+        while (auto chart_and_count = chart_queue.Pop())
+        {
+            auto &[chart, charts_for_symbol] = *chart_and_count;
+            if (chart.empty())
+            {
+                // nothing to store but the store step still needs to count it.
+
+                output_queue.Push({.symbol_ = chart.GetSymbol(), .charts_for_symbol_ = charts_for_symbol});
+                continue;
+            }
+            const auto chart_name = chart.MakeChartFileName(interval_i_, "");
+            try
+            {
+                output_queue.Push(SerializeChart(std::move(chart), charts_for_symbol));
+            }
+            catch (const std::exception &e)
+            {
+                spdlog::error(std::format("Problem serializing chart: {} because: {}.", chart_name, e.what()));
+            }
+        }
+    };
+
+    auto start_stage = [](int32_t how_many, auto &stage) {
+        std::vector<std::jthread> workers;
+        workers.reserve(how_many);
+        for (int32_t i = 0; i < how_many; ++i)
+        {
+            workers.emplace_back(stage);
+        }
+        return workers;
+    };
+
+    // each stage closes its output queue once all of its workers are done so
+    // the next stage can drain and finish.
+
+    std::jthread fetch_stage{[&]() {
+        {
+            auto workers = start_stage(fetch_threads_, fetch_prices);
+        }
+        price_queue.Close();
+    }};
+    std::jthread build_stage{[&]() {
+        {
+            auto workers = start_stage(build_threads_, build_charts);
+        }
+        chart_queue.Close();
+    }};
+    std::jthread serialize_stage{[&]() {
+        {
+            auto workers = start_stage(serialize_threads_, serialize_charts);
+        }
+        output_queue.Close();
+    }};
+
+    // storage happens right here. One writer keeps DB inserts and file creation simple.
+    // A symbol is checkpointed only after every one of its charts is stored so
+    // anything lost to a failure gets redone on resume.
+
+    int32_t chart_count = 0;
+    std::map<std::string, int32_t> stored_charts_for_symbol;
+    std::set<std::string> failed_symbols;
+    PF_DB pf_db{db_params_};
+    while (auto serialized_chart = output_queue.Pop())
+    {
+        const auto &symbol = serialized_chart->symbol_;
+        try
+        {
+            if (!serialized_chart->chart_name_.empty())
+            {
+                StoreSerializedChart(pf_db, *serialized_chart);
+                ++chart_count;
+            }
+            if (!failed_symbols.contains(symbol) &&
+                ++stored_charts_for_symbol[symbol] == serialized_chart->charts_for_symbol_)
+            {
+                RecordCompletedSymbol(exchange, symbol);
+                stored_charts_for_symbol.erase(symbol);
+            }
+        }
+        catch (const std::exception &e)
+        {
+            spdlog::error(
+                std::format("Problem storing chart: {} because: {}.", serialized_chart->chart_name_, e.what()));
+            failed_symbols.insert(symbol);
+            stored_charts_for_symbol.erase(symbol);
+        }
+    }
+    spdlog::info(std::format("Stored {} charts in {}.", chart_count,
+                             destination_ == Destination::e_file ? output_chart_directory_.string() : "DB"));
+
+    return {total_symbols_processed.load(), total_charts_processed.load(), total_charts_updated};
+}
+
+PF_LoaderApp::PriceSeries PF_LoaderApp::FetchPriceSeriesFromDB(const PF_DB &pf_db, pqxx::connection &c,
+                                                               const std::string &symbol) const
+{
     const auto *dt_format = interval_ == Interval::e_eod ? "%F" : "%F %T%z";
 
     std::istringstream time_stream;
@@ -567,62 +890,319 @@ std::tuple<int, int, int> PF_LoaderApp::ProcessSymbolsFromDB(const std::vector<s
         return new_data;
     };
 
-    for (const auto &symbol : symbol_list)
+    std::string get_symbol_prices_cmd =
+        std::format("SELECT date, {} FROM {} WHERE symbol = {} AND date >= "
+                    "{} ORDER BY date ASC",
+                    price_fld_name_, db_params_.stock_db_data_source_, c.quote(symbol), c.quote(begin_date_));
+
+    PriceSeries price_series{.symbol_ = symbol};
+    price_series.closing_prices_ =
+        pf_db.RunSQLQueryUsingStream<DateCloseRecord, std::string_view, std::string_view>(get_symbol_prices_cmd,
+                                                                                          Row2Closing);
+
+    price_series.atr_or_range_ = use_ATR_       ? ComputeATRForChartFromDB(symbol)
+                                 : use_min_max_ ? pf_db.ComputePriceRangeForSymbolFromDB(symbol, begin_date_, end_date_)
+                                                : 0;
+    return price_series;
+}
+
+std::vector<PF_Chart> PF_LoaderApp::BuildChartsForPriceSeries(const PriceSeries &price_series) const
+{
+    std::vector<PF_Chart> new_charts;
+
+    if (boxsize_source_ == BoxsizeSource::e_from_optimizer)
     {
-        ++total_symbols_processed;
+        new_charts = MakeChartsFromChosenBoxSizes(price_series.symbol_);
+    }
+    else
+    {
+        std::vector<std::string> the_symbol{price_series.symbol_};
+        auto params = vws::cartesian_product(the_symbol, box_size_list_, reversal_boxes_list_, scale_list_);
+
+        for (const auto &val : params)
+        {
+            if (use_ATR_ || use_min_max_)
+            {
+                new_charts.emplace_back(price_series.atr_or_range_, val,
+                                        max_columns_for_graph_ < 1 ? -1 : max_columns_for_graph_);
+            }
+            else
+            {
+                new_charts.emplace_back(val, price_series.atr_or_range_,
+                                        max_columns_for_graph_ < 1 ? -1 : max_columns_for_graph_);
+            }
+        }
+    }
+
+    std::vector<PF_Chart> charts;
 
+    for (auto &new_chart : new_charts)
+    {
         try
         {
-            std::string get_symbol_prices_cmd =
-                std::format("SELECT date, {} FROM {} WHERE symbol = {} AND date >= "
-                            "{} ORDER BY date ASC",
-                            price_fld_name_, db_params_.stock_db_data_source_, c.quote(symbol), c.quote(begin_date_));
+            for (const auto &[new_date, new_price] : price_series.closing_prices_)
+            {
+                new_chart.AddValue(new_price, std::chrono::clock_cast<std::chrono::utc_clock>(new_date));
+            }
+            charts.push_back(std::move(new_chart));
+        }
+        catch (const std::exception &e)
+        {
+            spdlog::error(std::format("Unable to load data for symbol chart: {} from DB "
+                                      "because: {}.",
+                                      new_chart.MakeChartFileName(interval_i_, ""), e.what()));
+        }
+    }
+    return charts;
+}
 
-            const auto closing_prices =
-                pf_db.RunSQLQueryUsingStream<DateCloseRecord, std::string_view, std::string_view>(get_symbol_prices_cmd,
-                                                                                                  Row2Closing);
+int32_t PF_LoaderApp::CountChartsRequestedForSymbol(const std::string &symbol) const
+{
+    // must agree with what BuildChartsForPriceSeries tries to build.
+
+    if (boxsize_source_ == BoxsizeSource::e_from_optimizer)
+    {
+        const auto chosen = chosen_box_sizes_.find(symbol);
+        return chosen == chosen_box_sizes_.end() ? 0 : static_cast<int32_t>(chosen->second.size());
+    }
+    return static_cast<int32_t>(box_size_list_.size() * reversal_boxes_list_.size() * scale_list_.size());
+}
 
-            auto atr_or_range = use_ATR_       ? ComputeATRForChartFromDB(symbol)
-                                : use_min_max_ ? pf_db.ComputePriceRangeForSymbolFromDB(symbol, begin_date_, end_date_)
-                                               : 0;
+std::vector<PF_Chart> PF_LoaderApp::MakeChartsFromChosenBoxSizes(const std::string &symbol) const
+{
+    std::vector<PF_Chart> charts;
+
+    const auto chosen = chosen_box_sizes_.find(symbol);
+    if (chosen == chosen_box_sizes_.end())
+    {
+        return charts;
+    }
+    for (const auto &choice : chosen->second)
+    {
+        charts.emplace_back(symbol, choice.base_box_size_, choice.reversal_boxes_, choice.box_size_modifier_,
+                            choice.box_scale_, max_columns_for_graph_ < 1 ? -1 : max_columns_for_graph_);
+    }
+    return charts;
+}
+
+std::vector<std::string> PF_LoaderApp::RemoveSymbolsWithoutChosenBoxSizes(
+    const std::vector<std::string> &symbol_list) const
+{
+    // skip these up front so no time goes into fetching their prices and an
+    // interrupted load doesn't keep coming back for them.
+
+    std::vector<std::string> result;
+    rng::copy_if(symbol_list, std::back_inserter(result),
+                 [this](const auto &symbol) { return chosen_box_sizes_.contains(symbol); });
+    if (result.size() < symbol_list.size())
+    {
+        spdlog::info(std::format("Skipping {} symbols with no chosen box sizes.", symbol_list.size() - result.size()));
+    }
+    return result;
+}
+
+PF_LoaderApp::SerializedChart PF_LoaderApp::SerializeChart(PF_Chart &&chart, int32_t charts_for_symbol) const
+{
+    // everything expensive about storing a chart happens here so it can be done
+    // in parallel. What is left for the store step is just writing bytes.
 
-            std::vector<std::string> the_symbol{symbol};
-            auto params = vws::cartesian_product(the_symbol, box_size_list_, reversal_boxes_list_, scale_list_);
+    const auto interval = new_data_source_ == Source::e_streaming ? "" : interval_i_;
+    const auto date_or_time = interval_ != Interval::e_eod ? X_AxisFormat::e_show_time : X_AxisFormat::e_show_date;
 
-            for (const auto &val : params)
+    SerializedChart result{.symbol_ = chart.GetSymbol(),
+                           .chart_name_ = chart.MakeChartFileName(interval, ""),
+                           .charts_for_symbol_ = charts_for_symbol};
+
+    if (graphics_format_ == GraphicsFormat::e_svg)
+    {
+        WriteFileAtomically(output_graphs_directory_ / (chart.MakeChartFileName(interval, "svg")),
+                            [&](const fs::path &temp_file) {
+                                ConstructPFChartGraphicAndWriteToFile(chart, temp_file, StreamedPrices{}, trend_lines_,
+                                                                      date_or_time, renderer_);
+                            });
+    }
+    else
+    {
+        std::ostringstream oss{};
+        chart.ConvertChartToTableAndWriteToStream(oss, date_or_time);
+        result.graphics_table_ = oss.str();
+    }
+
+    if (destination_ == Destination::e_file)
+    {
+        std::ostringstream oss{};
+        chart.ConvertChartToJsonAndWriteToStream(oss);
+        result.chart_json_ = oss.str();
+    }
+    else
+    {
+        result.chart_ = std::move(chart);
+    }
+    return result;
+}
+
+void PF_LoaderApp::StoreSerializedChart(const PF_DB &pf_db, const SerializedChart &serialized_chart) const
+{
+    if (destination_ == Destination::e_DB)
+    {
+        pf_db.StorePFChartDataIntoDB(serialized_chart.chart_.value(), interval_i_, serialized_chart.graphics_table_);
+        return;
+    }
+
+    // a short write must not count as stored or the symbol would be checkpointed with
+    // a truncated chart that --resume never redoes.
+
+    auto write_file = [](const fs::path &output_filename, const std::string &data) {
+        WriteFileAtomically(output_filename, [&data](const fs::path &temp_file) {
+            std::ofstream out{temp_file, std::ios::out | std::ios::binary | std::ios::trunc};
+            if (!out.is_open())
             {
-                PF_Chart new_chart;
-                if (use_ATR_ || use_min_max_)
-                {
-                    new_chart = PF_Chart{atr_or_range, val, max_columns_for_graph_ < 1 ? -1 : max_columns_for_graph_};
-                }
-                else
-                {
-                    new_chart = PF_Chart{val, atr_or_range, max_columns_for_graph_ < 1 ? -1 : max_columns_for_graph_};
-                }
-                try
-                {
-                    for (const auto &[new_date, new_price] : closing_prices)
-                    {
-                        new_chart.AddValue(new_price, std::chrono::clock_cast<std::chrono::utc_clock>(new_date));
-                    }
-                    charts_.emplace_back(std::make_pair(symbol, new_chart));
-                    ++total_charts_processed;
-                }
-                catch (const std::exception &e)
-                {
-                    spdlog::error(std::format("Unable to load data for symbol chart: {} from DB "
-                                              "because: {}.",
-                                              new_chart.MakeChartFileName(interval_i_, ""), e.what()));
-                }
+                throw std::runtime_error(std::format("Unable to open file: {} for chart output.", temp_file));
+            }
+            out.write(data.data(), static_cast<std::streamsize>(data.size()));
+            out.close();
+            if (out.fail())
+            {
+                throw std::runtime_error(std::format("Unable to write chart output to: {}.", temp_file));
+            }
+        });
+    };
+
+    write_file(output_chart_directory_ / (serialized_chart.chart_name_ + "json"), serialized_chart.chart_json_);
+
+    if (graphics_format_ == GraphicsFormat::e_csv)
+    {
+        write_file(output_graphs_directory_ / (serialized_chart.chart_name_ + "csv"), serialized_chart.graphics_table_);
+    }
+}
+
+std::string PF_LoaderApp::ChartParametersFingerprint() const
+{
+    // everything that decides which charts get built and where they end up. A symbol
+    // completed under other settings has to be done again.
+
+    std::string result = std::format(
+        "interval={};destination={};graphics={}:{}:{};max-graphic-cols={};trend-lines={};dates={}:{};price-source={}",
+        interval_i_,
+        destination_ == Destination::e_file
+            ? output_chart_directory_.string()
+            : std::format("DB:{}:{}:{}", db_params_.host_name_, db_params_.db_name_, db_params_.PF_db_mode_),
+        graphics_format_i_, renderer_i_, output_graphs_directory_.string(), max_columns_for_graph_, trend_lines_,
+        begin_date_, end_date_, db_params_.stock_db_data_source_);
+
+    if (boxsize_source_ == BoxsizeSource::e_from_optimizer)
+    {
+        // the file can be remade under the same name so go by what is in it. It can
+        // have thousands of lines so just keep a hash (FNV-1a) of them.
+
+        uint64_t hash = 14'695'981'039'346'656'037ULL;
+        auto add_to_hash = [&hash](std::string_view text) {
+            for (const unsigned char c : text)
+            {
+                hash = (hash ^ c) * 1'099'511'628'211ULL;
+            }
+        };
+        for (const auto &[symbol, choices] : chosen_box_sizes_)
+        {
+            for (const auto &choice : choices)
+            {
+                add_to_hash(std::format("{},{},{},{},{}\n", symbol, choice.box_scale_, choice.reversal_boxes_,
+                                        choice.base_box_size_.format("f"), choice.box_size_modifier_.format("f")));
             }
         }
-        catch (const std::exception &e)
+        result += std::format(";boxsize-file={}:{:016x}", boxsize_file_name_.string(), hash);
+        return result;
+    }
+
+    // the order given doesn't change the charts.
+
+    auto box_sizes = box_size_list_ | vws::transform([](const auto &box_size) { return box_size.format("f"); }) |
+                     rng::to<std::vector>();
+    rng::sort(box_sizes);
+    auto reversals = reversal_boxes_list_;
+    rng::sort(reversals);
+    auto scales = scale_i_list_;
+    rng::sort(scales);
+
+    result += std::format(";boxsize={};reversal={};scale={};box-size-from={}", box_sizes, reversals, scales,
+                          use_min_max_ ? "MinMax" : use_ATR_ ? "ATR" : "args");
+    return result;
+}
+
+void PF_LoaderApp::OpenProgressJournal()
+{
+    // without --resume we are starting over so whatever was recorded before no longer applies.
+    // The first line records the chart parameters the journal was written under.
+
+    static constexpr std::string_view kParametersHeader{"#parameters\t"};
+    const auto fingerprint = ChartParametersFingerprint();
+
+    completed_symbols_.clear();
+    bool have_header{false};
+    if (resume_mode_ && fs::exists(progress_journal_path_) && !fs::is_empty(progress_journal_path_))
+    {
+        std::ifstream journal{progress_journal_path_};
+        std::string line;
+        std::getline(journal, line);
+        BOOST_ASSERT_MSG(line.starts_with(kParametersHeader) && line.substr(kParametersHeader.size()) == fingerprint,
+                         std::format("\nProgress journal: {} was written for other chart parameters.\n"
+                                     "    journal: {}\n    now:     {}\nRun without 'resume' to start over.",
+                                     progress_journal_path_,
+                                     line.starts_with(kParametersHeader) ? line.substr(kParametersHeader.size())
+                                                                         : "(none)",
+                                     fingerprint)
+                             .c_str());
+        have_header = true;
+
+        while (std::getline(journal, line))
         {
-            spdlog::error(std::format("Unable to retrieve data for symbol: {} from DB because: {}.", symbol, e.what()));
+            // a crash can leave a partial last line. Those have no tab and are ignored.
+
+            const auto tab = line.find('\t');
+            if (tab == std::string::npos || tab + 1 == line.size())
+            {
+                continue;
+            }
+            completed_symbols_.emplace(line.substr(0, tab), line.substr(tab + 1));
         }
+        spdlog::info(std::format("Resuming load. Found {} completed symbols in progress journal: {}.",
+                                 completed_symbols_.size(), progress_journal_path_));
+    }
+
+    progress_journal_.open(progress_journal_path_,
+                           std::ios::out | std::ios::binary | (have_header ? std::ios::app : std::ios::trunc));
+    BOOST_ASSERT_MSG(progress_journal_.is_open(),
+                     std::format("Unable to open progress journal: {}.", progress_journal_path_).c_str());
+    if (!have_header)
+    {
+        progress_journal_ << kParametersHeader << fingerprint << '\n' << std::flush;
     }
-    return {total_symbols_processed, total_charts_processed, total_charts_updated};
+}
+
+void PF_LoaderApp::RecordCompletedSymbol(std::string_view exchange, std::string_view symbol)
+{
+    if (!progress_journal_.is_open())
+    {
+        return;
+    }
+    // flush each entry. This is once per symbol so the cost is nothing compared
+    // to building and storing its charts.
+
+    progress_journal_ << exchange << '\t' << symbol << '\n' << std::flush;
+}
+
+std::vector<std::string> PF_LoaderApp::RemoveCompletedSymbols(std::string_view exchange,
+                                                              const std::vector<std::string> &symbol_list) const
+{
+    if (completed_symbols_.empty())
+    {
+        return symbol_list;
+    }
+    std::vector<std::string> remaining;
+    rng::copy_if(symbol_list, std::back_inserter(remaining), [this, &exchange](const auto &symbol) {
+        return !completed_symbols_.contains({std::string{exchange}, symbol});
+    });
+    return remaining;
 }
 
 void PF_LoaderApp::AddPriceDataToExistingChartCSV(PF_Chart &new_chart, const fs::path &update_file_name) const
@@ -725,75 +1305,134 @@ Decimal PF_LoaderApp::ComputeATRForChartFromDB(const std::string &symbol) const
 
 void PF_LoaderApp::ShutdownAndStoreOutputInFiles()
 {
-    for (const auto &[symbol, chart] : charts_)
-    {
+    // drawing is most of the work here so charts are written on a pool of workers.
+    // Each file is written under a temporary name then renamed so nobody reading the
+    // output directories ever sees half a file.
+
+    const std::string interval = new_data_source_ == Source::e_streaming ? "" : interval_i_;
+    const auto date_or_time = interval_ != Interval::e_eod ? X_AxisFormat::e_show_time : X_AxisFormat::e_show_date;
+
+    std::atomic<int32_t> chart_count = 0;
+    const auto started = std::chrono::steady_clock::now();
+
+    ForEachOnWorkerPool(charts_, serialize_threads_, [&](const auto &symbol_and_chart) {
+        const auto &chart = symbol_and_chart.second;
         if (chart.empty())
-            continue;
+        {
+            return;
+        }
         try
         {
-            fs::path output_file_name =
-                output_chart_directory_ /
-                chart.MakeChartFileName((new_data_source_ == Source::e_streaming ? "" : interval_i_), "json");
-            chart.ConvertChartToJsonAndWriteToFile(output_file_name);
+            WriteFileAtomically(
+                output_chart_directory_ / chart.MakeChartFileName(interval, "json"),
+                [&chart](const fs::path &temp_file) { chart.ConvertChartToJsonAndWriteToFile(temp_file); });
 
             if (graphics_format_ == GraphicsFormat::e_svg)
             {
-                fs::path graph_file_path =
-                    output_graphs_directory_ /
-                    (chart.MakeChartFileName((new_data_source_ == Source::e_streaming ? "" : interval_i_), "svg"));
-                ConstructCDPFChartGraphicAndWriteToFile(chart, graph_file_path, StreamedPrices{}, trend_lines_,
-                                                        interval_ != Interval::e_eod ? X_AxisFormat::e_show_time
-                                                                                     : X_AxisFormat::e_show_date);
+                WriteFileAtomically(output_graphs_directory_ / chart.MakeChartFileName(interval, "svg"),
+                                    [&](const fs::path &temp_file) {
+                                        ConstructPFChartGraphicAndWriteToFile(chart, temp_file, StreamedPrices{},
+                                                                              trend_lines_, date_or_time, renderer_);
+                                    });
             }
             else
             {
-                fs::path graph_file_path =
-                    output_graphs_directory_ /
-                    (chart.MakeChartFileName((new_data_source_ == Source::e_streaming ? "" : interval_i_), "csv"));
-                chart.ConvertChartToTableAndWriteToFile(graph_file_path, interval_ != Interval::e_eod
-                                                                             ? X_AxisFormat::e_show_time
-                                                                             : X_AxisFormat::e_show_date);
+                WriteFileAtomically(output_graphs_directory_ / chart.MakeChartFileName(interval, "csv"),
+                                    [&](const fs::path &temp_file) {
+                                        chart.ConvertChartToTableAndWriteToFile(temp_file, date_or_time);
+                                    });
             }
+            ++chart_count;
         }
         catch (const std::exception &e)
         {
-            spdlog::error(
-                std::format("Problem in shutdown: {} for chart: {}.\nTrying to "
-                            "complete shutdown.",
-                            e.what(),
-                            chart.MakeChartFileName((new_data_source_ == Source::e_streaming ? "" : interval_i_), "")));
+            spdlog::error(std::format("Problem in shutdown: {} for chart: {}.\nTrying to "
+                                      "complete shutdown.",
+                                      e.what(), chart.MakeChartFileName(interval, "")));
         }
-    }
+    });
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - started;
+    spdlog::info(std::format("Wrote {} charts using {} workers in {:.1f} seconds.", chart_count.load(),
+                             serialize_threads_, elapsed.count()));
 }
 
 void PF_LoaderApp::ShutdownAndStoreOutputInDB()
 {
-    int32_t chart_count = 0;
+    // graphics (and csv tables) are made on a pool of workers. Storing stays on this
+    // thread, 1 writer like the load pipeline. Charts ready to store wait in a bounded
+    // queue so the workers can't get far ahead of the DB.
+
+    const auto date_or_time = interval_ != Interval::e_eod ? X_AxisFormat::e_show_time : X_AxisFormat::e_show_date;
+
+    struct ChartReadyToStore
+    {
+        const PF_Chart *chart_ = nullptr;
+        std::string graphics_table_;
+    };
+
+    // open the DB first. If we can't, there is nobody to empty the queue.
+
     PF_DB pf_db{db_params_};
-    for (const auto &[symbol, chart] : charts_)
+    BoundedQueue<ChartReadyToStore> ready_queue{static_cast<size_t>(std::max(1, serialize_threads_)) * 2};
+
+    std::jthread graphics_stage{[&]() {
+        try
+        {
+            ForEachOnWorkerPool(charts_, serialize_threads_, [&](const auto &symbol_and_chart) {
+                const auto &chart = symbol_and_chart.second;
+                if (chart.empty())
+                {
+                    return;
+                }
+                try
+                {
+                    ChartReadyToStore ready{.chart_ = &chart};
+                    if (graphics_format_ == GraphicsFormat::e_svg)
+                    {
+                        WriteFileAtomically(output_graphs_directory_ / chart.MakeChartFileName(interval_i_, "svg"),
+                                            [&](const fs::path &temp_file) {
+                                                ConstructPFChartGraphicAndWriteToFile(chart, temp_file,
+                                                                                      StreamedPrices{}, trend_lines_,
+                                                                                      date_or_time, renderer_);
+                                            });
+                    }
+                    else
+                    {
+                        std::ostringstream oss{};
+                        chart.ConvertChartToTableAndWriteToStream(oss, date_or_time);
+                        ready.graphics_table_ = oss.str();
+                    }
+                    ready_queue.Push(std::move(ready));
+                }
+                catch (const std::exception &e)
+                {
+                    spdlog::error(std::format("Problem storing data in DB in shutdown: {} for chart: "
+                                              "{}.\nTrying to complete shutdown.",
+                                              e.what(), chart.MakeChartFileName(interval_i_, "")));
+                }
+            });
+        }
+        catch (const std::exception &e)
+        {
+            spdlog::error(std::format("Problem making graphics in shutdown: {}.", e.what()));
+        }
+        ready_queue.Close();
+    }};
+
+    int32_t chart_count = 0;
+    while (auto ready = ready_queue.Pop())
     {
-        if (chart.empty())
-            continue;
         try
         {
-            if (graphics_format_ == GraphicsFormat::e_svg)
-            {
-                fs::path graph_file_path = output_graphs_directory_ / (chart.MakeChartFileName(interval_i_, "svg"));
-                ConstructCDPFChartGraphicAndWriteToFile(chart, graph_file_path, StreamedPrices{}, trend_lines_,
-                                                        interval_ != Interval::e_eod ? X_AxisFormat::e_show_time
-                                                                                     : X_AxisFormat::e_show_date);
-            }
-            chart.StoreChartInChartsDB(pf_db, interval_i_,
-                                       interval_ != Interval::e_eod ? X_AxisFormat::e_show_time
-                                                                    : X_AxisFormat::e_show_date,
-                                       graphics_format_ == GraphicsFormat::e_csv);
+            pf_db.StorePFChartDataIntoDB(*ready->chart_, interval_i_, ready->graphics_table_);
             ++chart_count;
         }
         catch (const std::exception &e)
         {
             spdlog::error(std::format("Problem storing data in DB in shutdown: {} for chart: "
                                       "{}.\nTrying to complete shutdown.",
-                                      e.what(), chart.MakeChartFileName(interval_i_, "")));
+                                      e.what(), ready->chart_->MakeChartFileName(interval_i_, "")));
         }
     }
     spdlog::info(std::format("Stored {} charts in DB.", chart_count));
@@ -3,8 +3,11 @@
 
 #include <chrono>
 #include <filesystem>
+#include <fstream>
 #include <optional>
+#include <set>
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -15,7 +18,9 @@
 #include "PF_Chart.h"
 #include "PointAndFigureDB.h"
 #include "Tiingo.h"
+#include "common/ChosenBoxSizes.h"
 #include "common/PF_AppBase.h"
+#include "utilities.h"
 
 namespace fs = std::filesystem;
 
@@ -50,6 +55,48 @@ private:
     void Run_Load();
     std::tuple<int, int, int> Run_LoadFromDB();
     std::tuple<int, int, int> ProcessSymbolsFromDB(const std::vector<std::string> &symbol_list);
+    std::tuple<int, int, int> ProcessSymbolsFromDBPipeline(std::string_view exchange,
+                                                           const std::vector<std::string> &symbol_list);
+
+    // progress journal lets an interrupted DB load pick up where it left off.
+    // A header line with the chart parameters then one line per (exchange, symbol)
+    // whose charts have all been stored. --resume refuses a journal from other parameters.
+
+    [[nodiscard]] std::string ChartParametersFingerprint() const;
+    void OpenProgressJournal();
+    void RecordCompletedSymbol(std::string_view exchange, std::string_view symbol);
+    [[nodiscard]] std::vector<std::string> RemoveCompletedSymbols(std::string_view exchange,
+                                                                  const std::vector<std::string> &symbol_list) const;
+
+    // the pieces of a DB load. These are used both by the in-memory load and by
+    // the staged fetch -> build -> serialize -> store pipeline.
+
+    struct PriceSeries
+    {
+        std::string symbol_;
+        std::vector<DateCloseRecord> closing_prices_;
+        decimal::Decimal atr_or_range_;
+    };
+
+    struct SerializedChart
+    {
+        std::optional<PF_Chart> chart_; // only kept when destination is DB
+        std::string symbol_;
+        std::string chart_name_; // empty if nothing to store
+        std::string chart_json_;
+        std::string graphics_table_;
+        int32_t charts_for_symbol_ = 0;
+    };
+
+    [[nodiscard]] PriceSeries FetchPriceSeriesFromDB(const PF_DB &pf_db, pqxx::connection &c,
+                                                     const std::string &symbol) const;
+    [[nodiscard]] std::vector<PF_Chart> BuildChartsForPriceSeries(const PriceSeries &price_series) const;
+    [[nodiscard]] int32_t CountChartsRequestedForSymbol(const std::string &symbol) const;
+    [[nodiscard]] std::vector<PF_Chart> MakeChartsFromChosenBoxSizes(const std::string &symbol) const;
+    [[nodiscard]] std::vector<std::string> RemoveSymbolsWithoutChosenBoxSizes(
+        const std::vector<std::string> &symbol_list) const;
+    [[nodiscard]] SerializedChart SerializeChart(PF_Chart &&chart, int32_t charts_for_symbol) const;
+    void StoreSerializedChart(const PF_DB &pf_db, const SerializedChart &serialized_chart) const;
 
     [[nodiscard]] static PF_Chart LoadAndParsePriceDataJSON(const fs::path &symbol_file_name);
     void AddPriceDataToExistingChartCSV(PF_Chart &new_chart, const fs::path &update_file_name) const;
@@ -66,6 +113,10 @@ private:
 
     PF_Charts charts_;
 
+    std::set<std::pair<std::string, std::string>> completed_symbols_;
+    std::ofstream progress_journal_;
+    fs::path progress_journal_path_;
+
     fs::path new_data_input_directory_;
     fs::path input_chart_directory_;
     fs::path output_chart_directory_;
@@ -128,11 +179,13 @@ private:
         e_unknown,
         e_from_args,
         e_from_ATR,
-        e_from_MinMax
+        e_from_MinMax,
+        e_from_optimizer
     };
 
     std::string quote_data_source_i_;
     std::string graphics_format_i_;
+    std::string renderer_i_;
     std::string destination_i_;
     std::string interval_i_;
     std::string source_format_i_;
@@ -145,6 +198,7 @@ private:
     SourceFormat source_format_ = SourceFormat::e_csv;
     Destination destination_ = Destination::e_unknown;
     GraphicsFormat graphics_format_ = GraphicsFormat::e_unknown;
+    GraphicsRenderer renderer_ = GraphicsRenderer::e_chartdirector;
     BoxsizeSource boxsize_source_ = BoxsizeSource::e_unknown;
     QuoteDataSource quote_data_source_ = QuoteDataSource::e_unknown;
     Interval interval_ = Interval::e_unknown;
@@ -157,6 +211,11 @@ private:
     std::vector<decimal::Decimal> box_size_list_;
     std::vector<int32_t> reversal_boxes_list_;
 
+    // per symbol chart parameters from 'pf_backtest --optimize-boxsize'
+
+    fs::path boxsize_file_name_;
+    ChosenBoxSizesForSymbols chosen_box_sizes_;
+
     std::string price_fld_name_;
     std::string trend_lines_;
     std::string begin_date_;
@@ -165,9 +224,14 @@ private:
 
     int64_t min_close_volume_ = 100'000;
     int32_t max_columns_for_graph_ = -1;
+    int32_t pipeline_queue_depth_ = 0;
+    int32_t fetch_threads_ = 0;
+    int32_t build_threads_ = 0;
+    int32_t serialize_threads_ = 0;
     int32_t number_of_days_history_for_ATR_ = 0;
     bool use_ATR_ = false;
     bool use_min_max_ = false;
+    bool resume_mode_ = false;
     std::vector<std::string> exchange_list_;
     std::string chart_data_source_;
 };
@@ -0,0 +1,657 @@
+#include "PF_ReplayApp.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+#include <boost/asio/connect.hpp>
+#include <boost/asio/ip/address.hpp>
+#include <boost/assert.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/ssl.hpp>
+#include <boost/beast/websocket.hpp>
+#include <boost/beast/websocket/ssl.hpp>
+
+namespace beast = boost::beast;
+namespace websocket = beast::websocket;
+namespace net = boost::asio;
+namespace ssl = boost::asio::ssl;
+using tcp = boost::asio::ip::tcp;
+
+#include <json/json.h>
+
+#include "StreamedData.h"
+
+namespace
+{
+std::string UpperCase(std::string_view text)
+{
+    std::string result{text};
+    std::ranges::transform(result, result.begin(), [](unsigned char c) { return std::toupper(c); });
+    return result;
+}
+
+// empty for frames that aren't trades (heartbeats, status messages). Those go to every connection.
+// Tiingo: {"messageType":"A","service":"iex","data":["2024-04-12T10:23:45.123456789-04:00","spy",512.34]}
+// Eodhd: {"s":"TGT","p":141,"c":[14,37,41],"v":1,"dp":false,"ms":"open","t":1706109542329}
+
+std::string FrameTicker(std::string_view frame, bool tiingo)
+{
+    StreamedDataScanner scanner{frame};
+    std::string_view key;
+    std::string_view value;
+    while (scanner.NextField(key, value))
+    {
+        if (tiingo && key == "data" && value.starts_with('['))
+        {
+            StreamedDataScanner elements{value};
+            std::string_view time_stamp;
+            std::string_view ticker;
+            if (elements.NextElement(time_stamp) && elements.NextElement(ticker))
+            {
+                return UpperCase(StreamedString(ticker));
+            }
+        }
+        else if (!tiingo && key == "s")
+        {
+            return UpperCase(StreamedString(value));
+        }
+    }
+    return {};
+}
+
+// Tiingo: {"eventName":"subscribe", ..., "eventData":{"thresholdLevel":6,"tickers":["spy","qqq"]}}
+// Eodhd: {"action": "subscribe", "symbols": "SPY,QQQ"}
+
+std::unordered_set<std::string> SubscribedTickers(std::string_view request, bool tiingo)
+{
+    std::unordered_set<std::string> result;
+
+    StreamedDataScanner scanner{request};
+    std::string_view key;
+    std::string_view value;
+    while (scanner.NextField(key, value))
+    {
+        if (tiingo && key == "eventData")
+        {
+            StreamedDataScanner event_data{value};
+            while (event_data.NextField(key, value))
+            {
+                if (key == "tickers")
+                {
+                    StreamedDataScanner tickers{value};
+                    std::string_view ticker;
+                    while (tickers.NextElement(ticker))
+                    {
+                        result.insert(UpperCase(StreamedString(ticker)));
+                    }
+                }
+            }
+        }
+        else if (!tiingo && key == "symbols")
+        {
+            for (const auto ticker : value | std::views::split(','))
+            {
+                result.insert(UpperCase(std::string_view{ticker}));
+            }
+        }
+    }
+    return result;
+}
+
+// the characters jsoncpp read 'json' from.
+
+std::string_view JsonCppText(std::string_view frame, const Json::Value &json)
+{
+    return frame.substr(static_cast<std::size_t>(json.getOffsetStart()),
+                        static_cast<std::size_t>(json.getOffsetLimit() - json.getOffsetStart()));
+}
+
+// does the scanner see the same thing jsoncpp does? 'value' is what the scanner gave us for
+// 'json'. jsoncpp records where each value starts and ends in the frame (quotes included) so
+// the views must cover exactly the same characters. A missed escape throws everything after
+// it out of line.
+
+bool ScannedAsJsonCpp(std::string_view frame, std::string_view value, const Json::Value &json)
+{
+    auto start = json.getOffsetStart();
+    auto limit = json.getOffsetLimit();
+    if (json.isString())
+    {
+        ++start;
+        --limit;
+    }
+    if (value.data() != frame.data() + start || std::cmp_not_equal(value.size(), limit - start))
+    {
+        return false;
+    }
+
+    if (json.isString())
+    {
+        return StreamedString(value) == json.asString();
+    }
+    if (json.isObject())
+    {
+        StreamedDataScanner scanner{value};
+        std::string_view key;
+        std::string_view member;
+        Json::ArrayIndex fields = 0;
+        while (scanner.NextField(key, member))
+        {
+            ++fields;
+            const auto name = StreamedString(key);
+            if (!json.isMember(name) || !ScannedAsJsonCpp(frame, member, json[name]))
+            {
+                return false;
+            }
+        }
+        return !scanner.Failed() && fields == json.size();
+    }
+    if (json.isArray())
+    {
+        StreamedDataScanner scanner{value};
+        std::string_view element;
+        Json::ArrayIndex ndx = 0;
+        while (scanner.NextElement(element))
+        {
+            if (ndx >= json.size() || !ScannedAsJsonCpp(frame, element, json[ndx++]))
+            {
+                return false;
+            }
+        }
+        return !scanner.Failed() && ndx == json.size();
+    }
+    return true;
+}
+
+// a Tiingo trade as Tiingo::ExtractStreamedData gets it and as it used to: jsoncpp for the
+// fields and chrono::parse for the time stamp. Same (empty) result for frames that aren't trades.
+
+using TiingoTrade = std::tuple<std::optional<std::chrono::utc_time<std::chrono::nanoseconds>>, std::string,
+                               std::optional<decimal::Decimal>>;
+
+TiingoTrade ScannedTiingoTrade(std::string_view frame)
+{
+    std::string_view message_type;
+    std::string_view data;
+
+    StreamedDataScanner scanner{frame};
+    std::string_view key;
+    std::string_view value;
+    while (scanner.NextField(key, value))
+    {
+        if (key == "messageType")
+        {
+            message_type = value;
+        }
+        else if (key == "data")
+        {
+            data = value;
+        }
+    }
+    if (message_type != "A")
+    {
+        return {};
+    }
+
+    std::string_view time_stamp;
+    std::string_view ticker;
+    std::string_view price;
+
+    StreamedDataScanner elements{data};
+    if (!elements.NextElement(time_stamp) || !elements.NextElement(ticker) || !elements.NextElement(price))
+    {
+        return {};
+    }
+    return {StreamedISOTimestamp(time_stamp), StreamedString(ticker), StreamedDecimal(price)};
+}
+
+TiingoTrade JsonCppTiingoTrade(std::string_view frame, const Json::Value &response)
+{
+    if (!response.isObject() || response["messageType"] != "A")
+    {
+        return {};
+    }
+    const auto &data = response["data"];
+    if (!data.isArray() || data.size() < 3)
+    {
+        return {};
+    }
+
+    TiingoTrade result;
+
+    if (data[0].isString())
+    {
+        std::chrono::utc_time<std::chrono::nanoseconds> time_stamp;
+        std::istringstream time_stamp_text{data[0].asString()};
+        time_stamp_text >> std::chrono::parse("%FT%T%Ez", time_stamp);
+        if (!time_stamp_text.fail())
+        {
+            std::get<0>(result) = time_stamp;
+        }
+    }
+    std::get<1>(result) = data[1].asString();
+
+    // prices come both quoted and not. Take the digits as sent, not as a double.
+
+    const auto &price = data[2];
+    const auto price_text = price.isString() ? price.asString() : std::string{JsonCppText(frame, price)};
+    try
+    {
+        std::get<2>(result) = decimal::Decimal{price_text};
+    }
+    catch (const std::exception &)
+    {
+        // no price
+    }
+    return result;
+}
+} // namespace
+
+// =====================================================================================
+//        Class:  PF_ReplayApp
+//  Description:  application specific stuff for replaying recorded streaming data
+// =====================================================================================
+
+PF_ReplayApp::PF_ReplayApp(int argc, char *argv[]) : PF_AppBase{argc, argv}
+{
+    app_.description("Point & Figure feed replay: serve recorded streaming data to pf_streamer for benchmarking.");
+    SetupProgramOptions();
+}
+
+PF_ReplayApp::PF_ReplayApp(const std::vector<std::string> &tokens) : PF_AppBase{tokens}
+{
+    app_.description("Point & Figure feed replay: serve recorded streaming data to pf_streamer for benchmarking.");
+    SetupProgramOptions();
+}
+
+void PF_ReplayApp::SetupProgramOptions()
+{
+    app_.add_option("--frames-file", frames_file_, "Frames recorded by 'pf_streamer --record-frames'.")
+        ->required()
+        ->check(CLI::ExistingFile);
+    app_.add_option("--streaming-data-source", streaming_data_source_i_, "Service the frames were recorded from.")
+        ->required()
+        ->check(CLI::IsMember({"Eodhd", "Tiingo"}));
+
+    // a self-signed certificate is fine. The streamer doesn't verify its peer. e.g.
+    // openssl req -x509 -newkey rsa:2048 -nodes -keyout key.pem -out cert.pem -days 365 -subj /CN=localhost
+
+    app_.add_option("--cert", certificate_file_, "PEM file with the server's certificate.")->check(CLI::ExistingFile);
+    app_.add_option("--key", private_key_file_, "PEM file with the server's private key.")->check(CLI::ExistingFile);
+
+    app_.add_option("--address", listen_address_, "Address to listen on.")->default_val("127.0.0.1");
+    app_.add_option("--port", listen_port_, "Port to listen on.")->default_val(8443)->check(CLI::Range(1, 65535));
+    app_.add_option("--connections", connection_count_,
+                    "Number of connections to expect. Must match the streamer's --streaming-connections.")
+        ->default_val(1)
+        ->check(CLI::Range(1, 64));
+
+    // Pacing
+    app_.add_option("--speed", speed_, "Playback speed. 1 is as recorded, 10 is 10x faster, 0 is as fast as possible.")
+        ->default_val(1.0)
+        ->check(CLI::NonNegativeNumber);
+    app_.add_option("--max-gap-ms", max_gap_ms_,
+                    "Longest pause between frames (before speed up). Keeps quiet spells from idling out the "
+                    "connection.")
+        ->default_val(10'000)
+        ->check(CLI::Range(0, 20'000));
+    app_.add_option("--repeat", repeat_count_, "Number of times to play the frames.")
+        ->default_val(1)
+        ->check(CLI::Range(1, 1'000));
+
+    app_.add_flag("--check-parser", check_parser_,
+                  "Don't serve the frames. Check that the streamed data scanner reads each one the same as jsoncpp.");
+
+    // Logging options
+    app_.add_option("--log-path", log_file_path_name_, "Path name for log file.");
+    app_.add_option("-l,--log-level", logging_level_, "Logging level: 'none|error|information|debug'.")
+        ->default_val("information")
+        ->check(CLI::IsMember({"none", "error", "information", "debug"}));
+
+    app_.failure_message(CLI::FailureMessage::help);
+}
+
+bool PF_ReplayApp::Startup()
+{
+    spdlog::info(std::format("\n\n*** Starting run {} ***\n",
+                             std::chrono::current_zone()->to_local(std::chrono::system_clock::now())));
+    bool result{true};
+    try
+    {
+        if (tokens_.empty() && argc_ <= 1)
+        {
+            std::cout << app_.help();
+            return false;
+        }
+        ParseProgramOptions(tokens_);
+        ConfigureLogging();
+
+        streaming_data_source_ =
+            streaming_data_source_i_ == "Tiingo" ? StreamingSource::e_Tiingo : StreamingSource::e_Eodhd;
+
+        BOOST_ASSERT_MSG(check_parser_ || (!certificate_file_.empty() && !private_key_file_.empty()),
+                         "\nMust specify --cert and --key to serve frames.");
+
+        LoadRecordedFrames();
+        BOOST_ASSERT_MSG(!frames_.empty(), std::format("\nNo frames found in: {}", frames_file_.string()).c_str());
+    }
+    catch (const std::exception &e)
+    {
+        spdlog::error(std::format("Problem in startup: {}\n", e.what()));
+        result = false;
+    }
+    catch (...)
+    {
+        spdlog::error("Unexpected problem during Startup processing\n");
+        result = false;
+    }
+    return result;
+}
+
+void PF_ReplayApp::LoadRecordedFrames()
+{
+    // 1 frame per line: receive time (nanoseconds since epoch) <tab> frame.
+
+    std::ifstream frames_file{frames_file_};
+    BOOST_ASSERT_MSG(frames_file.is_open(),
+                     std::format("\nUnable to open frames file: {}", frames_file_.string()).c_str());
+
+    int32_t bad_lines = 0;
+    std::string line;
+    while (std::getline(frames_file, line))
+    {
+        const auto tab = line.find('\t');
+        int64_t received{0};
+        if (tab == std::string::npos ||
+            std::from_chars(line.data(), line.data() + tab, received).ec != std::errc() || tab + 1 == line.size())
+        {
+            ++bad_lines;
+            continue;
+        }
+        frames_.emplace_back(received, line.substr(tab + 1));
+        frame_tickers_.push_back(
+            FrameTicker(frames_.back().second, streaming_data_source_ == StreamingSource::e_Tiingo));
+    }
+    if (bad_lines > 0)
+    {
+        spdlog::error(std::format("Skipped {} badly formed lines in: {}", bad_lines, frames_file_.string()));
+    }
+
+    const auto recorded_for =
+        frames_.empty() ? 0.0 : static_cast<double>(frames_.back().first - frames_.front().first) / 1e9;
+    spdlog::info(std::format("Loaded {} frames covering {:.3f} seconds from: {}", frames_.size(), recorded_for,
+                             frames_file_.string()));
+}
+
+void PF_ReplayApp::Run()
+{
+    if (check_parser_)
+    {
+        CheckParser();
+        return;
+    }
+
+    ssl::context ctx{ssl::context::tlsv12_server};
+    ctx.use_certificate_chain_file(certificate_file_.string());
+    ctx.use_private_key_file(private_key_file_.string(), ssl::context::pem);
+
+    net::io_context ioc;
+    tcp::acceptor acceptor{ioc, tcp::endpoint{net::ip::make_address(listen_address_),
+                                              static_cast<unsigned short>(listen_port_)}};
+
+    std::cout << std::format("Waiting for streamer to make {} connections on: {}:{}", connection_count_,
+                             listen_address_, listen_port_)
+              << std::endl;
+
+    // the streamer opens all its connections at startup. Each one gets only the frames
+    // for the symbols it subscribed to, played from its own thread.
+
+    std::vector<tcp::socket> sockets;
+    for (int32_t connection = 0; connection < connection_count_; ++connection)
+    {
+        sockets.emplace_back(ioc);
+        acceptor.accept(sockets.back());
+    }
+
+    std::vector<std::thread> players;
+    for (auto &socket : sockets)
+    {
+        players.emplace_back(
+            [this, &ctx](tcp::socket socket)
+            {
+                try
+                {
+                    PlayFrames(std::move(socket), ctx);
+                }
+                catch (const std::exception &e)
+                {
+                    spdlog::error(std::format("Problem playing frames: {}", e.what()));
+                }
+            },
+            std::move(socket));
+    }
+    for (auto &player : players)
+    {
+        player.join();
+    }
+
+    // both services are sent an unsubscribe on a new connection when the stream ends.
+
+    for (int32_t connection = 0; connection < connection_count_; ++connection)
+    {
+        AnswerUnsubscribe(ioc, acceptor, ctx);
+    }
+}
+
+void PF_ReplayApp::CheckParser()
+{
+    // jsoncpp is what we used before the scanner. Every frame must come out the same from both.
+
+    Json::CharReaderBuilder builder;
+    const std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+
+    for (const auto &[received, frame] : frames_)
+    {
+        ++frames_checked_;
+
+        JSONCPP_STRING err;
+        Json::Value response;
+        if (!reader->parse(frame.data(), frame.data() + frame.size(), &response, &err))
+        {
+            spdlog::error(std::format("jsoncpp can't parse frame: {}\n->{}<-", err, frame));
+            ++frames_differing_;
+            continue;
+        }
+
+        bool same = (response.isObject() || response.isArray()) &&
+                    ScannedAsJsonCpp(frame, JsonCppText(frame, response), response);
+        if (same && streaming_data_source_ == StreamingSource::e_Tiingo)
+        {
+            same = ScannedTiingoTrade(frame) == JsonCppTiingoTrade(frame, response);
+        }
+        if (!same)
+        {
+            spdlog::error(std::format("scanner and jsoncpp differ on frame: ->{}<-", frame));
+            ++frames_differing_;
+        }
+    }
+}
+
+void PF_ReplayApp::PlayFrames(tcp::socket socket, ssl::context &ctx)
+{
+    websocket::stream<beast::ssl_stream<tcp::socket>> ws{std::move(socket), ctx};
+    ws.next_layer().handshake(ssl::stream_base::server);
+    ws.accept();
+
+    beast::flat_buffer buffer;
+    ws.read(buffer);
+    const auto request = beast::buffers_to_string(buffer.cdata());
+    spdlog::info(std::format("Subscribe request: {}", request));
+
+    const auto subscribed = SubscribedTickers(request, streaming_data_source_ == StreamingSource::e_Tiingo);
+
+    ws.text(true);
+    ws.write(net::buffer(SubscribeReply()));
+
+    using Clock = std::chrono::steady_clock;
+    const auto max_gap = std::chrono::nanoseconds{std::chrono::milliseconds{max_gap_ms_}};
+
+    // frame times are relative to the start so a late frame doesn't delay the ones after it.
+    // Every connection keeps time over all the frames so they stay in step with each other.
+
+    const auto started = Clock::now();
+    std::chrono::nanoseconds due_after{0};
+
+    int64_t frames_sent = 0;
+    int64_t bytes_sent = 0;
+    std::chrono::nanoseconds max_behind_schedule{0};
+
+    for (int32_t pass = 0; pass < repeat_count_ && !had_signal_; ++pass)
+    {
+        for (std::size_t ndx = 0; ndx < frames_.size() && !had_signal_; ++ndx)
+        {
+            if (speed_ > 0 && ndx > 0)
+            {
+                const auto gap = std::clamp(std::chrono::nanoseconds{frames_[ndx].first - frames_[ndx - 1].first},
+                                            std::chrono::nanoseconds{0}, max_gap);
+                due_after += std::chrono::duration_cast<std::chrono::nanoseconds>(gap / speed_);
+            }
+            if (!subscribed.empty() && !frame_tickers_[ndx].empty() && !subscribed.contains(frame_tickers_[ndx]))
+            {
+                continue;
+            }
+            if (speed_ > 0 && ndx > 0)
+            {
+                const auto due = started + due_after;
+                const auto now = Clock::now();
+                if (now < due)
+                {
+                    std::this_thread::sleep_until(due);
+                }
+                else
+                {
+                    max_behind_schedule = std::max(max_behind_schedule, std::chrono::nanoseconds{now - due});
+                }
+            }
+            const auto &frame = frames_[ndx].second;
+            ws.write(net::buffer(frame));
+            ++frames_sent;
+            bytes_sent += static_cast<int64_t>(frame.size());
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(results_mtx_);
+        frames_sent_ += frames_sent;
+        bytes_sent_ += bytes_sent;
+        elapsed_ = std::max(elapsed_, std::chrono::nanoseconds{Clock::now() - started});
+        max_behind_schedule_ = std::max(max_behind_schedule_, max_behind_schedule);
+    }
+
+    // the streamer takes a normal close as the end of the trading day.
+
+    ws.close(websocket::close_code::normal);
+}
+
+void PF_ReplayApp::AnswerUnsubscribe(net::io_context &ioc, tcp::acceptor &acceptor, ssl::context &ctx)
+{
+    // the streamer may not get this far (e.g. it was interrupted) so don't wait long.
+
+    tcp::socket socket{ioc};
+    beast::error_code accept_ec = net::error::timed_out;
+    acceptor.async_accept(socket, [&accept_ec](beast::error_code ec) { accept_ec = ec; });
+    ioc.restart();
+    ioc.run_for(5s);
+    if (!ioc.stopped())
+    {
+        acceptor.cancel();
+        ioc.run();
+    }
+    if (accept_ec)
+    {
+        spdlog::info("No unsubscribe request from streamer.");
+        return;
+    }
+
+    try
+    {
+        websocket::stream<beast::ssl_stream<tcp::socket>> ws{std::move(socket), ctx};
+        ws.next_layer().handshake(ssl::stream_base::server);
+        ws.accept();
+
+        beast::flat_buffer buffer;
+        ws.read(buffer);
+        spdlog::info(std::format("Unsubscribe request: {}", beast::buffers_to_string(buffer.cdata())));
+
+        ws.text(true);
+        ws.write(net::buffer(SubscribeReply()));
+
+        // wait for the streamer to close.
+
+        buffer.clear();
+        ws.read(buffer);
+    }
+    catch (const beast::system_error &e)
+    {
+        if (e.code() != websocket::error::closed)
+        {
+            spdlog::error(std::format("Problem answering unsubscribe request: {}", e.what()));
+        }
+    }
+}
+
+std::string PF_ReplayApp::SubscribeReply() const
+{
+    // just enough for the streamer to accept the subscription.
+
+    if (streaming_data_source_ == StreamingSource::e_Tiingo)
+    {
+        return R"({"messageType":"I","data":{"subscriptionId":1},"response":{"code":200,"message":"Success"}})";
+    }
+    return R"({"status_code":200,"message":"Authorized"})";
+}
+
+void PF_ReplayApp::Shutdown()
+{
+    if (check_parser_)
+    {
+        std::cout << std::format("\nChecked {} frames. Scanner and jsoncpp differ on {}.\n", frames_checked_,
+                                 frames_differing_);
+        spdlog::info(std::format("\n\n*** End run {} ***\n",
+                                 std::chrono::current_zone()->to_local(std::chrono::system_clock::now())));
+        return;
+    }
+
+    const auto elapsed_seconds = static_cast<double>(elapsed_.count()) / 1e9;
+    std::cout << std::format("\nSent {} frames ({} bytes) in {:.3f} s = {:.0f} msgs/sec.\n", frames_sent_,
+                             bytes_sent_, elapsed_seconds,
+                             elapsed_seconds > 0 ? static_cast<double>(frames_sent_) / elapsed_seconds : 0.0);
+    if (speed_ > 0)
+    {
+        std::cout << std::format("Fell at most {:.3f} ms behind schedule at {}x.\n",
+                                 static_cast<double>(max_behind_schedule_.count()) / 1e6, speed_);
+    }
+
+    spdlog::info(std::format("\n\n*** End run {} ***\n",
+                             std::chrono::current_zone()->to_local(std::chrono::system_clock::now())));
+}
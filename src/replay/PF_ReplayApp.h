@@ -0,0 +1,104 @@
+#ifndef PF_REPLAYAPP_INC
+#define PF_REPLAYAPP_INC
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/ssl.hpp>
+
+#include "common/PF_AppBase.h"
+
+// =====================================================================================
+//        Class:  PF_ReplayApp
+//  Description:  local stand-in for the Tiingo and Eodhd streaming services.
+//
+//  Plays back frames recorded by 'pf_streamer --record-frames' over a TLS websocket so
+//  the streamer can be run (and measured) outside market hours. Point the streamer at it
+//  with --streaming-host/--streaming-port and give it --simulated-clock.
+//
+//  Frames are sent at the recorded pace, some multiple of it, or as fast as the
+//  streamer will take them. Since websocket writes block when the streamer falls
+//  behind, how far we fall behind schedule shows whether it kept up.
+//
+//  With --connections each of the streamer's connections is sent just the frames for
+//  the symbols it subscribed to.
+//
+//  With --check-parser nothing is served. Instead each frame is read by the streamed data
+//  scanner and by jsoncpp and any frame they don't agree on is logged.
+// =====================================================================================
+
+class PF_ReplayApp : public PF_AppBase
+{
+public:
+    PF_ReplayApp(int argc, char *argv[]);
+    explicit PF_ReplayApp(const std::vector<std::string> &tokens);
+
+    PF_ReplayApp() = delete;
+    PF_ReplayApp(const PF_ReplayApp &) = delete;
+    PF_ReplayApp(PF_ReplayApp &&) = delete;
+    PF_ReplayApp &operator=(const PF_ReplayApp &) = delete;
+    PF_ReplayApp &operator=(PF_ReplayApp &&) = delete;
+
+    bool Startup();
+    void Run();
+    void Shutdown();
+
+protected:
+    void SetupProgramOptions();
+
+private:
+    // receive time (nanoseconds since epoch) and the frame as received.
+
+    using RecordedFrame = std::pair<int64_t, std::string>;
+
+    void LoadRecordedFrames();
+    void CheckParser();
+    void PlayFrames(boost::asio::ip::tcp::socket socket, boost::asio::ssl::context &ctx);
+    void AnswerUnsubscribe(boost::asio::io_context &ioc, boost::asio::ip::tcp::acceptor &acceptor,
+                           boost::asio::ssl::context &ctx);
+    [[nodiscard]] std::string SubscribeReply() const;
+
+    std::vector<RecordedFrame> frames_;
+    std::vector<std::string> frame_tickers_; // upper case. Empty if not a trade.
+
+    fs::path frames_file_;
+    fs::path certificate_file_;
+    fs::path private_key_file_;
+    std::string listen_address_;
+    std::string streaming_data_source_i_;
+
+    enum class StreamingSource : int32_t
+    {
+        e_unknown,
+        e_Eodhd,
+        e_Tiingo
+    };
+
+    StreamingSource streaming_data_source_ = StreamingSource::e_unknown;
+
+    int32_t listen_port_ = 0;
+    int32_t connection_count_ = 0;
+    int32_t max_gap_ms_ = 0;
+    int32_t repeat_count_ = 0;
+    double speed_ = 1.0;
+    bool check_parser_ = false;
+
+    // results. Summed over all connections.
+
+    std::mutex results_mtx_;
+    int64_t frames_sent_ = 0;
+    int64_t bytes_sent_ = 0;
+    std::chrono::nanoseconds elapsed_{0};
+    std::chrono::nanoseconds max_behind_schedule_{0};
+
+    int64_t frames_checked_ = 0;
+    int64_t frames_differing_ = 0;
+};
+
+#endif
@@ -0,0 +1,257 @@
+#include "scanner/ChartSnapshot.h"
+
+#include <algorithm>
+#include <ranges>
+#include <utility>
+
+namespace rng = std::ranges;
+namespace vws = std::ranges::views;
+
+#include "common/WorkerPool.h"
+#include "utilities.h"
+
+void ChartSnapshot::StartExchange(std::string exchange)
+{
+    exchanges_.push_back(std::move(exchange));
+    exchange_first_symbol_.push_back(symbols_.size());
+}
+
+void ChartSnapshot::StartSymbol(std::string symbol)
+{
+    symbols_.push_back(std::move(symbol));
+    symbol_first_row_.push_back(size());
+}
+
+void ChartSnapshot::AddChart(const PF_Chart &chart, int32_t columns_before, bool moved)
+{
+    moved = moved && !chart.empty();
+    const auto current_signal = chart.GetCurrentSignal();
+    const auto &current_column = chart.back();
+
+    chart_name_.push_back(chart.MakeChartFileName("eod", ""));
+    direction_.push_back(chart.GetCurrentDirection());
+    reversal_boxes_.push_back(chart.GetReversalboxes());
+    box_scale_.push_back(chart.GetBoxScale());
+    box_size_.push_back(dec2dbl(chart.GetChartBoxSize()));
+    columns_.push_back(static_cast<int32_t>(chart.size()));
+    new_columns_.push_back(static_cast<int32_t>(chart.size()) - columns_before);
+    moved_.push_back(moved ? 1 : 0);
+    reversed_.push_back(moved && chart.LastChangeWasReversal() ? 1 : 0);
+    current_signal_.push_back(current_signal ? current_signal->signal_type_ : PF_SignalType::e_unknown);
+    current_signal_category_.push_back(current_signal ? current_signal->signal_category_
+                                                      : PF_SignalCategory::e_unknown);
+    new_signal_.push_back(moved && current_signal && current_signal->tpt_ == chart.GetLastChangeTime() ? 1 : 0);
+
+    // box list is in ascending order and column tops, bottoms and the y limits are all boxes
+    // so distances are just differences in position. Works for percent charts too.
+
+    const auto &box_list = chart.GetBoxes().GetBoxList();
+    auto box_ndx = [&box_list](const decimal::Decimal &value) {
+        return static_cast<int32_t>(rng::distance(box_list.begin(), rng::lower_bound(box_list, value)));
+    };
+
+    const auto [y_min, y_max] = chart.GetYLimits();
+    y_min_.push_back(chart.empty() ? 0.0 : dec2dbl(y_min));
+    y_max_.push_back(chart.empty() ? 0.0 : dec2dbl(y_max));
+    column_top_.push_back(chart.empty() ? 0.0 : current_column.GetTopAsDbl());
+    column_bottom_.push_back(chart.empty() ? 0.0 : current_column.GetBottomAsDbl());
+    boxes_from_high_.push_back(box_list.empty() ? 0 : box_ndx(y_max) - box_ndx(current_column.GetTop()));
+    boxes_from_low_.push_back(box_list.empty() ? 0 : box_ndx(current_column.GetBottom()) - box_ndx(y_min));
+
+    for (std::size_t back = 0; back < kRecentColumns; ++back)
+    {
+        recent_directions_.push_back(back < chart.size() ? chart[chart.size() - 1 - back].GetDirection()
+                                                          : PF_Column::Direction::e_Unknown);
+    }
+
+    std::array<int32_t, kSignalTypes> ages;
+    ages.fill(kNoSignalAge);
+    const auto current_column_number = current_column.GetColumnNumber();
+    for (const auto &sig : chart.GetSignals() | vws::reverse)
+    {
+        auto &age = ages[std::to_underlying(sig.signal_type_)];
+        if (age == kNoSignalAge)
+        {
+            age = current_column_number - sig.column_number_;
+        }
+    }
+    for (std::size_t which = 0; which < kSignalTypes; ++which)
+    {
+        signal_age_[which].push_back(ages[which]);
+    }
+
+    const auto trend_line = chart.GetCurrentTrendLine();
+    trend_line_.push_back(trend_line ? trend_line->kind_ : PF_TrendLineKind::e_none);
+    boxes_from_trend_line_.push_back(static_cast<int32_t>(chart.BoxesFromTrendLine().value_or(0)));
+    trend_line_age_.push_back(trend_line ? current_column_number - trend_line->start_column_ : 0);
+    trend_line_breached_.push_back(moved && chart.LastChangeBreachedTrendLine() ? 1 : 0);
+
+    const auto last_signal = chart.GetMostRecentSignal();
+    decimal::Decimal objective = -1;
+    if (last_signal)
+    {
+        objective = last_signal->vertical_objective_ > 0 ? last_signal->vertical_objective_
+                                                         : last_signal->horizontal_objective_;
+    }
+    if (chart.empty() || objective <= 0)
+    {
+        objective_category_.push_back(PF_SignalCategory::e_unknown);
+        objective_.push_back(0.0);
+        pct_to_objective_.push_back(0.0);
+        return;
+    }
+    const auto price = current_column.GetDirection() == PF_Column::Direction::e_Down
+                           ? current_column.GetBottomAsDbl()
+                           : current_column.GetTopAsDbl();
+    const auto to_go = last_signal->signal_category_ == PF_SignalCategory::e_PF_Sell ? price - dec2dbl(objective)
+                                                                                     : dec2dbl(objective) - price;
+    objective_category_.push_back(last_signal->signal_category_);
+    objective_.push_back(dec2dbl(objective));
+    pct_to_objective_.push_back(price > 0.0 ? 100.0 * to_go / price : 0.0);
+}
+
+std::vector<std::size_t> RankByObjective(const ChartSnapshot &snapshot, PF_SignalCategory category,
+                                         std::size_t how_many)
+{
+    std::vector<std::size_t> rows;
+    for (std::size_t row = 0; row < snapshot.size(); ++row)
+    {
+        if (snapshot.objective_category_[row] == category)
+        {
+            rows.push_back(row);
+        }
+    }
+    const auto ranked = std::min(how_many, rows.size());
+    rng::partial_sort(rows, rows.begin() + static_cast<std::ptrdiff_t>(ranked), [&snapshot](auto lhs, auto rhs) {
+        return snapshot.pct_to_objective_[lhs] > snapshot.pct_to_objective_[rhs];
+    });
+    rows.resize(ranked);
+    return rows;
+}
+
+BreadthMeasure ChartBreadthMeasure(std::string name, std::string net_name,
+                                   std::function<PF_Column::Direction(const ChartSnapshot &, std::size_t)> which_way)
+{
+    return {.name_ = std::move(name),
+            .net_name_ = std::move(net_name),
+            .count_ = [which_way = std::move(which_way)](const ChartSnapshot &snapshot, ChartSnapshot::RowRange rows) {
+                BreadthCounts result;
+                for (auto row = rows.first_; row < rows.end_; ++row)
+                {
+                    const auto way = which_way(snapshot, row);
+                    result.up_ += way == PF_Column::Direction::e_Up ? 1 : 0;
+                    result.down_ += way == PF_Column::Direction::e_Down ? 1 : 0;
+                }
+                return result;
+            }};
+}
+
+std::vector<BreadthMeasure> StandardBreadthMeasures()
+{
+    using enum PF_Column::Direction;
+
+    auto by_signal_category = [](PF_SignalCategory category) {
+        return category == PF_SignalCategory::e_PF_Buy    ? e_Up
+               : category == PF_SignalCategory::e_PF_Sell ? e_Down
+                                                          : e_Unknown;
+    };
+
+    std::vector<BreadthMeasure> measures;
+
+    measures.push_back(ChartBreadthMeasure("Reversals", "reversals", [](const auto &snapshot, auto row) {
+        return snapshot.reversed_[row] != 0 ? snapshot.direction_[row] : e_Unknown;
+    }));
+
+    measures.push_back(ChartBreadthMeasure("Trends continued", "continues", [](const auto &snapshot, auto row) {
+        return snapshot.moved_[row] != 0 && snapshot.reversed_[row] == 0 ? snapshot.direction_[row] : e_Unknown;
+    }));
+
+    measures.push_back({.name_ = "Unanimous trends",
+                        .net_name_ = "unanimous",
+                        .count_ = [](const ChartSnapshot &snapshot, ChartSnapshot::RowRange rows) {
+                            BreadthCounts result;
+                            if (rows.first_ == rows.end_)
+                            {
+                                return result;
+                            }
+                            const auto first_direction = snapshot.direction_[rows.first_];
+                            const auto all_same = rng::all_of(
+                                snapshot.direction_.begin() + rows.first_, snapshot.direction_.begin() + rows.end_,
+                                [first_direction](auto direction) { return direction == first_direction; });
+                            if (all_same)
+                            {
+                                result.up_ += first_direction == e_Up ? 1 : 0;
+                                result.down_ += first_direction == e_Down ? 1 : 0;
+                            }
+                            return result;
+                        }});
+
+    measures.push_back(ChartBreadthMeasure(
+        "On buy (up) or sell (down) signal", "signals", [by_signal_category](const auto &snapshot, auto row) {
+            return by_signal_category(snapshot.current_signal_category_[row]);
+        }));
+
+    measures.push_back(ChartBreadthMeasure(
+        "New buy (up) or sell (down) signal", "new signals", [by_signal_category](const auto &snapshot, auto row) {
+            return snapshot.new_signal_[row] != 0 ? by_signal_category(snapshot.current_signal_category_[row])
+                                                  : e_Unknown;
+        }));
+
+    // the line in force after a breach is the opposite of the 1 breached.
+
+    measures.push_back(ChartBreadthMeasure(
+        "Resistance (up) or support (down) line breached", "breaches", [](const auto &snapshot, auto row) {
+            return snapshot.trend_line_breached_[row] == 0                             ? e_Unknown
+                   : snapshot.trend_line_[row] == PF_TrendLineKind::e_bullish_support ? e_Up
+                                                                                       : e_Down;
+        }));
+
+    return measures;
+}
+
+std::vector<BreadthCounts> EvaluateBreadth(const ChartSnapshot &snapshot, const std::vector<BreadthMeasure> &measures,
+                                           int32_t thread_count)
+{
+    // a few chunks of symbols per thread so nobody waits long on a slow one.
+    // Each chunk keeps its own counts which are added up at the end.
+
+    struct Chunk
+    {
+        std::size_t first_symbol_ = 0;
+        std::size_t end_symbol_ = 0;
+        std::vector<BreadthCounts> counts_;
+    };
+
+    const auto symbol_count = snapshot.SymbolCount();
+    const auto chunk_size =
+        std::max<std::size_t>(1, symbol_count / (static_cast<std::size_t>(std::max(1, thread_count)) * 4));
+
+    std::vector<Chunk> chunks;
+    for (std::size_t first = 0; first < symbol_count; first += chunk_size)
+    {
+        chunks.push_back(
+            {.first_symbol_ = first, .end_symbol_ = std::min(first + chunk_size, symbol_count), .counts_ = {}});
+    }
+
+    ForEachOnWorkerPool(chunks, thread_count, [&snapshot, &measures](Chunk &chunk) {
+        chunk.counts_.resize(measures.size());
+        for (auto symbol_ndx = chunk.first_symbol_; symbol_ndx < chunk.end_symbol_; ++symbol_ndx)
+        {
+            const auto rows = snapshot.RowsForSymbol(symbol_ndx);
+            for (std::size_t which = 0; which < measures.size(); ++which)
+            {
+                chunk.counts_[which] += measures[which].count_(snapshot, rows);
+            }
+        }
+    });
+
+    std::vector<BreadthCounts> results(measures.size());
+    for (const auto &chunk : chunks)
+    {
+        for (std::size_t which = 0; which < chunk.counts_.size(); ++which)
+        {
+            results[which] += chunk.counts_[which];
+        }
+    }
+    return results;
+}
@@ -0,0 +1,183 @@
+#ifndef PF_CHARTSNAPSHOT_INC
+#define PF_CHARTSNAPSHOT_INC
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "PF_Chart.h"
+#include "PF_Column.h"
+#include "PF_Signals.h"
+
+// =====================================================================================
+//        Class:  ChartSnapshot
+//  Description:  the state of every chart the daily scan looked at, kept in memory
+//                as columns (1 vector per feature, 1 row per chart) so questions about
+//                the whole universe are a quick pass over a few small arrays instead of
+//                another trip through the pf_charts table.
+//
+//  Rows are added a symbol at a time and a symbol's rows are contiguous so anything
+//  about a symbol's charts taken together is a look at 1 range of rows.
+//  Symbols are likewise grouped by exchange.
+// =====================================================================================
+
+class ChartSnapshot
+{
+public:
+    struct RowRange
+    {
+        std::size_t first_ = 0;
+        std::size_t end_ = 0;
+    };
+
+    // how far back recent_directions_ goes (0 is the current column) and the
+    // signal age of a chart which has never had that signal.
+
+    static constexpr std::size_t kRecentColumns = 8;
+    static constexpr int32_t kNoSignalAge = std::numeric_limits<int32_t>::max();
+    static constexpr std::size_t kSignalTypes = kSignalTypeCount;
+
+    void StartExchange(std::string exchange);
+    void StartSymbol(std::string symbol);
+
+    // call after the chart has seen all of today's prices. 'columns_before' is how
+    // many columns it had before it saw them and 'moved' is whether the last of them
+    // this scan gave it changed it. The chart's own times can't say since prices it
+    // has already seen (a rerun) leave them as they were.
+
+    void AddChart(const PF_Chart &chart, int32_t columns_before, bool moved);
+
+    [[nodiscard]] std::size_t size() const { return direction_.size(); }
+    [[nodiscard]] bool empty() const { return direction_.empty(); }
+    [[nodiscard]] std::size_t SymbolCount() const { return symbols_.size(); }
+    [[nodiscard]] RowRange RowsForSymbol(std::size_t symbol_ndx) const
+    {
+        return {symbol_first_row_[symbol_ndx],
+                symbol_ndx + 1 < symbols_.size() ? symbol_first_row_[symbol_ndx + 1] : size()};
+    }
+
+    // per exchange. Each owns the symbols [first, next exchange's first).
+
+    std::vector<std::string> exchanges_;
+    std::vector<std::size_t> exchange_first_symbol_;
+
+    // per symbol
+
+    std::vector<std::string> symbols_;
+    std::vector<std::size_t> symbol_first_row_;
+
+    // per chart
+
+    std::vector<std::string> chart_name_; // MakeChartFileName("eod", "")
+    std::vector<PF_Column::Direction> direction_; // of the current column
+    std::vector<int32_t> reversal_boxes_;
+    std::vector<BoxScale> box_scale_;
+    std::vector<double> box_size_;
+    std::vector<int32_t> columns_;
+    std::vector<int32_t> new_columns_;
+
+    // where the current column is relative to the chart's whole range, in boxes
+    // from its top to the chart high and from its bottom to the chart low.
+
+    std::vector<double> y_min_;
+    std::vector<double> y_max_;
+    std::vector<double> column_top_;
+    std::vector<double> column_bottom_;
+    std::vector<int32_t> boxes_from_high_;
+    std::vector<int32_t> boxes_from_low_;
+
+    // kRecentColumns per chart, newest first. e_Unknown past the first column.
+
+    std::vector<PF_Column::Direction> recent_directions_;
+
+    // the last price checked this scan moved the chart and, if so, whether it started a new column.
+
+    std::vector<uint8_t> moved_;
+    std::vector<uint8_t> reversed_;
+
+    // signal for the current column, if any, and whether the last move set it off.
+
+    std::vector<PF_SignalType> current_signal_;
+    std::vector<PF_SignalCategory> current_signal_category_;
+    std::vector<uint8_t> new_signal_;
+
+    // columns since the chart's most recent signal of each type (indexed by
+    // PF_SignalType), 0 for the current column, kNoSignalAge if never.
+
+    std::array<std::vector<int32_t>, kSignalTypes> signal_age_;
+
+    // the 45 degree trend line in force (e_none if none yet), boxes from the current column
+    // to it, columns since it was started and whether the last move breached the one before it.
+
+    std::vector<PF_TrendLineKind> trend_line_;
+    std::vector<int32_t> boxes_from_trend_line_;
+    std::vector<int32_t> trend_line_age_;
+    std::vector<uint8_t> trend_line_breached_;
+
+    // the most recent signal's price objective (vertical count if it has one, else horizontal),
+    // 0 if none, and how far the price has to go to reach it in percent of the current column's
+    // last box: up for a buy, down for a sell. Negative once it has gone past.
+
+    std::vector<PF_SignalCategory> objective_category_;
+    std::vector<double> objective_;
+    std::vector<double> pct_to_objective_;
+};
+
+// how many charts (or symbols) a breadth measure counts as up and as down.
+
+struct BreadthCounts
+{
+    int32_t up_ = 0;
+    int32_t down_ = 0;
+
+    BreadthCounts &operator+=(const BreadthCounts &rhs)
+    {
+        up_ += rhs.up_;
+        down_ += rhs.down_;
+        return *this;
+    }
+};
+
+// a measure is asked about each symbol (its range of rows) in turn and says what it
+// counts there. It must only read the snapshot since symbols are done in parallel.
+
+struct BreadthMeasure
+{
+    std::string name_;     // 'Reversals'
+    std::string net_name_; // 'reversals' as in 'Net reversals UP: 12'
+    std::function<BreadthCounts(const ChartSnapshot &, ChartSnapshot::RowRange)> count_;
+};
+
+// for measures of individual charts. 'which_way' says how a row counts: e_Up, e_Down or
+// e_Unknown for not at all.
+
+BreadthMeasure ChartBreadthMeasure(std::string name, std::string net_name,
+                                   std::function<PF_Column::Direction(const ChartSnapshot &, std::size_t)> which_way);
+
+// what the scanner reports:
+//
+//  reversals:  the last price started a new column, counted by its direction.
+//  continues:  the last price extended the current column.
+//  unanimous:  symbols whose charts are all in up (down) columns.
+//  on signal:  charts whose current column has a buy (sell) signal.
+//  new signal: charts whose last price set off a buy (sell) signal.
+//  breaches:   charts whose last price breached a 45 degree resistance (support) line.
+
+std::vector<BreadthMeasure> StandardBreadthMeasures();
+
+// 1 result per measure. Symbols are split over 'thread_count' threads.
+
+std::vector<BreadthCounts> EvaluateBreadth(const ChartSnapshot &snapshot, const std::vector<BreadthMeasure> &measures,
+                                           int32_t thread_count);
+
+// rows of the charts with a buy (sell) objective which have the furthest left to go to it,
+// furthest first, at most 'how_many'. Only those rows are sorted.
+
+std::vector<std::size_t> RankByObjective(const ChartSnapshot &snapshot, PF_SignalCategory category,
+                                         std::size_t how_many);
+
+#endif
@@ -3,9 +3,11 @@
 #include <algorithm>
 #include <chrono>
 #include <format>
+#include <fstream>
 #include <iostream>
 #include <ranges>
 #include <sstream>
+#include <thread>
 
 namespace rng = std::ranges;
 namespace vws = std::ranges::views;
@@ -15,6 +17,8 @@ namespace vws = std::ranges::views;
 
 #include "PF_Chart.h"
 #include "PointAndFigureDB.h"
+#include "common/BreadthTracker.h"
+#include "scanner/ChartSnapshot.h"
 #include "utilities.h"
 
 // =====================================================================================
@@ -151,6 +155,32 @@ void PF_ScannerApp::SetupProgramOptions()
 
     app_.add_option("--price-fld-name", price_fld_name_, "Data field to use for price value.")
         ->default_val("split_adj_close");
+
+    app_.add_option("--breadth-threads", breadth_threads_,
+                    "Number of workers computing market breadth from scanned charts. 0 means use default.")
+        ->default_val(0)
+        ->check(CLI::NonNegativeNumber);
+
+    app_.add_flag("--sql-breadth", sql_breadth_,
+                  "Also report breadth from the DB's find_trend_* functions (another pass over all charts in DB).");
+
+    app_.add_flag("--store-breadth", store_breadth_,
+                  "Store each exchange's bullish percent and percent in X columns as of 'end-date' in the DB's "
+                  "pf_breadth table.");
+
+    app_.add_option("--screen", screen_texts_,
+                    "Screen scanned charts, e.g. 'reversal == 1 and signal_age(tt_buy) < 3'. See ScanPredicate.h. "
+                    "Can be repeated.");
+
+    app_.add_option("--screen-output", screen_output_file_name_,
+                    "Write charts matching each screen to this file. Otherwise they are only logged at debug level.")
+        ->default_val("");
+
+    app_.add_option("--rank-by-objective", rank_by_objective_,
+                    "Report this many charts on a buy (sell) signal with the furthest to go to its price objective. "
+                    "0 means don't.")
+        ->default_val(0)
+        ->check(CLI::NonNegativeNumber);
 }
 
 bool PF_ScannerApp::CheckArgs()
@@ -182,6 +212,16 @@ bool PF_ScannerApp::CheckArgs()
         });
     }
 
+    // find mistakes in screens now rather than after the whole scan.
+
+    for (const auto &screen : screen_texts_)
+    {
+        screens_.emplace_back(screen);
+    }
+
+    const int32_t cores = std::max(1U, std::thread::hardware_concurrency());
+    breadth_threads_ = breadth_threads_ > 0 ? breadth_threads_ : cores;
+
     spdlog::debug("begin-date: {}\n", begin_date_);
     if (!end_date_.empty())
     {
@@ -219,6 +259,16 @@ std::tuple<int, int, int> PF_ScannerApp::Run_DailyScan()
 
     auto data_for_symbol = vws::chunk_by([](const auto &a, const auto &b) { return a.symbol_ == b.symbol_; });
 
+    // what each chart looks like once it's up to date. Breadth is computed from this
+    // instead of going back to the DB for all the charts we just had in hand.
+
+    ChartSnapshot snapshot;
+
+    // bullish percent and percent in X columns. Each chart is counted as it comes out of
+    // the DB and then moved if today's prices changed its state.
+
+    BreadthTracker breadth_tracker;
+
     for (const auto &xchng : exchange_list_)
     {
         spdlog::info(std::format("Scanning charts for symbols on xchng: {} with adjusted dollar volume >= "
@@ -229,6 +279,9 @@ std::tuple<int, int, int> PF_ScannerApp::Run_DailyScan()
         int32_t exchange_charts_processed = 0;
         int32_t exchange_charts_updated = 0;
 
+        snapshot.StartExchange(xchng);
+        const auto breadth_group = breadth_tracker.AddGroup(xchng);
+
         auto db_data = pf_db.GetPriceDataForSymbolsOnExchange(xchng, begin_date_, end_date_, price_fld_name_, dt_format,
                                                               min_dollar_volume_);
 
@@ -238,22 +291,31 @@ std::tuple<int, int, int> PF_ScannerApp::Run_DailyScan()
             exchange_symbols_processed += 1;
 
             auto charts_for_symbol = pf_db.RetrieveAllEODChartsForSymbol(symbol);
+            snapshot.StartSymbol(symbol);
 
             for (auto &chart : charts_for_symbol)
             {
                 exchange_charts_processed += 1;
                 bool chart_needs_update = false;
+                bool moved = false; // by the last price this scan
+                const auto columns_before = static_cast<int32_t>(chart.size());
+                const auto breadth_before = ChartBreadthState::ForChart(chart);
+                breadth_tracker.AddChart(breadth_group, breadth_before);
                 try
                 {
-                    rng::for_each(symbol_rng, [&chart, &chart_needs_update](const auto &row) {
+                    rng::for_each(symbol_rng, [&chart, &chart_needs_update, &moved](const auto &row) {
                         auto status = chart.AddValue(row.close_, row.date_);
-                        chart_needs_update |= status == PF_Column::Status::e_Accepted ? 1 : 0;
+                        moved = status == PF_Column::Status::e_Accepted ||
+                                status == PF_Column::Status::e_AcceptedWithSignal;
+                        chart_needs_update |= moved;
                     });
                     if (chart_needs_update)
                     {
                         chart.UpdateChartInChartsDB(pf_db, "eod", X_AxisFormat::e_show_date, false);
                         exchange_charts_updated += 1;
+                        breadth_tracker.Update(breadth_group, breadth_before, ChartBreadthState::ForChart(chart));
                     }
+                    snapshot.AddChart(chart, columns_before, moved);
                 }
                 catch (const std::exception &e)
                 {
@@ -273,22 +335,41 @@ std::tuple<int, int, int> PF_ScannerApp::Run_DailyScan()
                                  exchange_charts_updated));
 
         pf_db.UpdateLastCheckedDateInChartsDB(xchng, end_date_);
-    }
 
-    const auto [ups1, downs1] = CountChartReversalsUpAndDown();
-    const auto [ups2, downs2] = CountChartTrendsContinueUpAndDown();
-    const auto [ups3, downs3] = CountChartTrendsUnanimousUpAndDown();
+        ReportBreadth(pf_db, xchng, breadth_tracker.GetTally(breadth_group));
+    }
 
     spdlog::info(std::format("Total symbols: {}. Total charts scanned: {}. Total charts updated: "
                              "{}.",
                              total_symbols_processed, total_charts_processed, total_charts_updated));
 
-    spdlog::info(std::format("Reversals. Up: {}. Down: {}. Net reversals {}: {}.", ups1, downs1,
-                             (ups1 - downs1 > 0 ? "UP" : "DOWN"), std::abs(ups1 - downs1)));
-    spdlog::info(std::format("Trends continued. Up: {}. Down: {}. Net continues {}: {}.", ups2, downs2,
-                             (ups2 - downs2 > 0 ? "UP" : "DOWN"), std::abs(ups2 - downs2)));
-    spdlog::info(std::format("Unanimous trends. Up: {}. Down: {}. Net unanimous {}: {}.", ups3, downs3,
-                             (ups3 - downs3 > 0 ? "UP" : "DOWN"), std::abs(ups3 - downs3)));
+    ReportBreadth(pf_db, "ALL", breadth_tracker.GetTotal());
+
+    const auto measures = StandardBreadthMeasures();
+    const auto breadth = EvaluateBreadth(snapshot, measures, breadth_threads_);
+    for (const auto &[measure, counts] : vws::zip(measures, breadth))
+    {
+        spdlog::info(std::format("{}. Up: {}. Down: {}. Net {} {}: {}.", measure.name_, counts.up_, counts.down_,
+                                 measure.net_name_, (counts.up_ - counts.down_ > 0 ? "UP" : "DOWN"),
+                                 std::abs(counts.up_ - counts.down_)));
+    }
+
+    RunScreens(snapshot);
+    ReportObjectives(snapshot);
+
+    if (sql_breadth_)
+    {
+        const auto [ups1, downs1] = CountChartReversalsUpAndDown();
+        const auto [ups2, downs2] = CountChartTrendsContinueUpAndDown();
+        const auto [ups3, downs3] = CountChartTrendsUnanimousUpAndDown();
+
+        spdlog::info(std::format("DB reversals. Up: {}. Down: {}. Net reversals {}: {}.", ups1, downs1,
+                                 (ups1 - downs1 > 0 ? "UP" : "DOWN"), std::abs(ups1 - downs1)));
+        spdlog::info(std::format("DB trends continued. Up: {}. Down: {}. Net continues {}: {}.", ups2, downs2,
+                                 (ups2 - downs2 > 0 ? "UP" : "DOWN"), std::abs(ups2 - downs2)));
+        spdlog::info(std::format("DB unanimous trends. Up: {}. Down: {}. Net unanimous {}: {}.", ups3, downs3,
+                                 (ups3 - downs3 > 0 ? "UP" : "DOWN"), std::abs(ups3 - downs3)));
+    }
 
     return {total_symbols_processed, total_charts_processed, total_charts_updated};
 }
@@ -337,3 +418,83 @@ std::pair<int, int> PF_ScannerApp::CountChartTrendsUnanimousUpAndDown() const
     auto charts_down = trxn.query_value<int>(query_down);
     return std::make_pair(charts_up, charts_down);
 }
+
+void PF_ScannerApp::ReportBreadth(const PF_DB &pf_db, const std::string &group, const BreadthTally &tally) const
+{
+    spdlog::info(std::format("{}: bullish percent: {:.1f}% ({} of {} charts on a buy signal). In X columns: {:.1f}%.",
+                             group, tally.BullishPercent(), tally.on_buy_signal_, tally.charts_,
+                             tally.PercentInXColumns()));
+
+    if (!store_breadth_)
+    {
+        return;
+    }
+    try
+    {
+        pf_db.StoreBreadthInDB(group, end_date_, tally.charts_, tally.in_x_columns_, tally.on_buy_signal_);
+    }
+    catch (const std::exception &e)
+    {
+        spdlog::error(std::format("Unable to store breadth for: {} in DB because: {}.", group, e.what()));
+    }
+}
+
+void PF_ScannerApp::RunScreens(const ChartSnapshot &snapshot) const
+{
+    if (screens_.empty())
+    {
+        return;
+    }
+
+    std::ofstream screen_output;
+    if (!screen_output_file_name_.empty())
+    {
+        screen_output.open(screen_output_file_name_, std::ios::out | std::ios::trunc);
+        BOOST_ASSERT_MSG(screen_output.is_open(),
+                         std::format("Unable to open file: {} for screen output.", screen_output_file_name_).c_str());
+    }
+
+    for (const auto &screen : screens_)
+    {
+        const auto started = std::chrono::steady_clock::now();
+        const auto matched = screen.Evaluate(snapshot);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - started;
+
+        const auto matches = rng::count(matched, 1);
+        spdlog::info(std::format("Screen: '{}' matched {} of {} charts in {:.3f} seconds.", screen.GetText(), matches,
+                                 snapshot.size(), elapsed.count()));
+
+        for (std::size_t row = 0; row < matched.size(); ++row)
+        {
+            if (matched[row] == 0)
+            {
+                continue;
+            }
+            spdlog::debug(std::format("Screen: '{}' matched: {}", screen.GetText(), snapshot.chart_name_[row]));
+            if (screen_output.is_open())
+            {
+                screen_output << std::format("{}\t{}\n", screen.GetText(), snapshot.chart_name_[row]);
+            }
+        }
+    }
+}
+
+void PF_ScannerApp::ReportObjectives(const ChartSnapshot &snapshot) const
+{
+    if (rank_by_objective_ == 0)
+    {
+        return;
+    }
+
+    for (const auto category : {PF_SignalCategory::e_PF_Buy, PF_SignalCategory::e_PF_Sell})
+    {
+        const auto ranked = RankByObjective(snapshot, category, static_cast<std::size_t>(rank_by_objective_));
+        spdlog::info(std::format("Furthest from {} objective:",
+                                 category == PF_SignalCategory::e_PF_Buy ? "buy" : "sell"));
+        for (const auto row : ranked)
+        {
+            spdlog::info(std::format("    {}: objective: {:.2f}. to go: {:.1f}%.", snapshot.chart_name_[row],
+                                     snapshot.objective_[row], snapshot.pct_to_objective_[row]));
+        }
+    }
+}
@@ -1,12 +1,15 @@
 #ifndef PF_SCANNERAPP_INC
 #define PF_SCANNERAPP_INC
 
+#include <cstdint>
 #include <string>
 #include <tuple>
 #include <utility>
 #include <vector>
 
+#include "common/BreadthTracker.h"
 #include "common/PF_AppBase.h"
+#include "scanner/ScanPredicate.h"
 
 class PF_ScannerApp : public PF_AppBase
 {
@@ -33,12 +36,25 @@ private:
     std::pair<int, int> CountChartReversalsUpAndDown() const;
     std::pair<int, int> CountChartTrendsContinueUpAndDown() const;
     std::pair<int, int> CountChartTrendsUnanimousUpAndDown() const;
+    void ReportBreadth(const PF_DB &pf_db, const std::string &group, const BreadthTally &tally) const;
+    void RunScreens(const ChartSnapshot &snapshot) const;
+    void ReportObjectives(const ChartSnapshot &snapshot) const;
 
     std::vector<std::string> exchange_list_;
     std::string min_dollar_volume_;
     std::string begin_date_;
     std::string end_date_;
     std::string price_fld_name_;
+
+    int32_t breadth_threads_ = 0;
+    bool sql_breadth_ = false;
+    bool store_breadth_ = false;
+
+    std::vector<std::string> screen_texts_;
+    std::vector<ScanPredicate> screens_;
+    fs::path screen_output_file_name_;
+
+    int32_t rank_by_objective_ = 0;
 };
 
 #endif
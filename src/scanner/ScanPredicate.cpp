@@ -0,0 +1,598 @@
+#include "scanner/ScanPredicate.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <format>
+#include <functional>
+#include <initializer_list>
+#include <map>
+#include <ranges>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace rng = std::ranges;
+
+namespace
+{
+
+// both the formatted names and the ones used in the DB's JSON.
+
+const std::map<std::string, PF_SignalType, std::less<>> &SignalTypeNames()
+{
+    static const auto names = [] {
+        std::map<std::string, PF_SignalType, std::less<>> result;
+        for (std::size_t which = 1; which < ChartSnapshot::kSignalTypes; ++which)
+        {
+            const auto signal_type = static_cast<PF_SignalType>(which);
+            result.emplace(std::format("{}", signal_type), signal_type);
+            result.emplace(PF_SignalToJSON(PF_Signal{.signal_type_ = signal_type})["type"].asString(), signal_type);
+        }
+        return result;
+    }();
+    return names;
+}
+
+template <typename T> std::vector<double> AsDoubles(const std::vector<T> &values)
+{
+    std::vector<double> result(values.size());
+    rng::transform(values, result.begin(), [](T value) {
+        if constexpr (std::is_enum_v<T>)
+        {
+            return static_cast<double>(std::to_underlying(value));
+        }
+        else
+        {
+            return static_cast<double>(value);
+        }
+    });
+    return result;
+}
+
+// the filter kernels. 1 pass over a column (or 2) with no branches in the loop so
+// the compiler can vectorize it.
+
+template <typename Cmp> ScanPredicate::Mask CompareKernel(const std::vector<double> &lhs, double rhs, Cmp cmp)
+{
+    ScanPredicate::Mask result(lhs.size());
+    for (std::size_t row = 0; row < lhs.size(); ++row)
+    {
+        result[row] = cmp(lhs[row], rhs) ? 1 : 0;
+    }
+    return result;
+}
+
+template <typename Cmp>
+ScanPredicate::Mask CompareKernel(const std::vector<double> &lhs, const std::vector<double> &rhs, Cmp cmp)
+{
+    ScanPredicate::Mask result(lhs.size());
+    for (std::size_t row = 0; row < lhs.size(); ++row)
+    {
+        result[row] = cmp(lhs[row], rhs[row]) ? 1 : 0;
+    }
+    return result;
+}
+
+} // namespace
+
+// =====================================================================================
+//        Class:  ScanPredicate::Parser
+//  Description:  recursive descent over the tokens of the text, appending steps to
+//                the program as each piece is recognized.
+//
+//      or_expr    := and_expr ( ('or' | '||') and_expr )*
+//      and_expr   := unary ( ('and' | '&&') unary )*
+//      unary      := ('not' | '!') unary | '(' or_expr ')' | comparison
+//      comparison := operand ( ('<' | '<=' | '>' | '>=' | '==' | '=' | '!=') operand )?
+//      operand    := number | name | name '(' name-or-number ')'
+// =====================================================================================
+
+class ScanPredicate::Parser
+{
+public:
+    Parser(const std::string &text, std::vector<Step> &program) : text_{text}, program_{program}
+    {
+        Tokenize();
+    }
+
+    void Parse()
+    {
+        ParseOr();
+        if (Current().kind_ != Token::Kind::e_End)
+        {
+            Fail("expected 'and', 'or' or the end of the screen");
+        }
+    }
+
+private:
+    struct Token
+    {
+        enum class Kind : int32_t
+        {
+            e_Name,
+            e_Number,
+            e_Symbol,
+            e_End
+        };
+        Kind kind_ = Kind::e_End;
+        std::string text_;
+        double value_ = 0.0;
+        std::size_t pos_ = 0;
+    };
+
+    [[noreturn]] void Fail(std::string_view problem, std::size_t pos) const
+    {
+        throw std::invalid_argument{std::format("Screen '{}': {} at position {}.", text_, problem, pos)};
+    }
+    [[noreturn]] void Fail(std::string_view problem) const
+    {
+        Fail(problem, Current().pos_);
+    }
+
+    void Tokenize()
+    {
+        std::size_t pos = 0;
+        while (pos < text_.size())
+        {
+            const char c = text_[pos];
+            if (std::isspace(static_cast<unsigned char>(c)) != 0)
+            {
+                ++pos;
+            }
+            else if (std::isalpha(static_cast<unsigned char>(c)) != 0 || c == '_')
+            {
+                const auto start = pos;
+                while (pos < text_.size() &&
+                       (std::isalnum(static_cast<unsigned char>(text_[pos])) != 0 || text_[pos] == '_'))
+                {
+                    ++pos;
+                }
+                tokens_.push_back({.kind_ = Token::Kind::e_Name,
+                                   .text_ = text_.substr(start, pos - start),
+                                   .value_ = 0.0,
+                                   .pos_ = start});
+            }
+            else if (std::isdigit(static_cast<unsigned char>(c)) != 0 || c == '.' || c == '-')
+            {
+                double value = 0.0;
+                const auto [end, ec] = std::from_chars(text_.data() + pos, text_.data() + text_.size(), value);
+                if (ec != std::errc{})
+                {
+                    Fail("bad number", pos);
+                }
+                const auto start = pos;
+                pos = static_cast<std::size_t>(end - text_.data());
+                tokens_.push_back({.kind_ = Token::Kind::e_Number,
+                                   .text_ = text_.substr(start, pos - start),
+                                   .value_ = value,
+                                   .pos_ = start});
+            }
+            else
+            {
+                static constexpr std::string_view symbols[] = {"<=", ">=", "==", "!=", "&&", "||",
+                                                               "<",  ">",  "=",  "!",  "(",  ")"};
+                const auto rest = std::string_view{text_}.substr(pos);
+                const auto *symbol = rng::find_if(symbols, [rest](auto s) { return rest.starts_with(s); });
+                if (symbol == rng::end(symbols))
+                {
+                    Fail(std::format("unexpected '{}'", c), pos);
+                }
+                tokens_.push_back(
+                    {.kind_ = Token::Kind::e_Symbol, .text_ = std::string{*symbol}, .value_ = 0.0, .pos_ = pos});
+                pos += symbol->size();
+            }
+        }
+        tokens_.push_back({.kind_ = Token::Kind::e_End, .text_ = {}, .value_ = 0.0, .pos_ = text_.size()});
+    }
+
+    [[nodiscard]] const Token &Current() const
+    {
+        return tokens_[next_];
+    }
+
+    // takes the current token if it's one of 'choices' (a keyword or a symbol).
+
+    bool Accept(std::initializer_list<std::string_view> choices)
+    {
+        const auto &token = Current();
+        if ((token.kind_ == Token::Kind::e_Name || token.kind_ == Token::Kind::e_Symbol) &&
+            rng::find(choices, token.text_) != choices.end())
+        {
+            ++next_;
+            return true;
+        }
+        return false;
+    }
+
+    void Expect(std::string_view symbol)
+    {
+        if (!Accept({symbol}))
+        {
+            Fail(std::format("expected '{}'", symbol));
+        }
+    }
+
+    void ParseOr()
+    {
+        ParseAnd();
+        while (Accept({"or", "||"}))
+        {
+            ParseAnd();
+            program_.push_back({.op_ = Op::e_Or, .lhs_ = {}, .rhs_ = {}});
+        }
+    }
+
+    void ParseAnd()
+    {
+        ParseUnary();
+        while (Accept({"and", "&&"}))
+        {
+            ParseUnary();
+            program_.push_back({.op_ = Op::e_And, .lhs_ = {}, .rhs_ = {}});
+        }
+    }
+
+    void ParseUnary()
+    {
+        if (Accept({"not", "!"}))
+        {
+            ParseUnary();
+            program_.push_back({.op_ = Op::e_Not, .lhs_ = {}, .rhs_ = {}});
+        }
+        else if (Accept({"("}))
+        {
+            ParseOr();
+            Expect(")");
+        }
+        else
+        {
+            ParseComparison();
+        }
+    }
+
+    void ParseComparison()
+    {
+        static const std::map<std::string, Op, std::less<>> comparisons = {
+            {"<", Op::e_Less},     {"<=", Op::e_LessEqual}, {">", Op::e_Greater},  {">=", Op::e_GreaterEqual},
+            {"==", Op::e_Equal},   {"=", Op::e_Equal},      {"!=", Op::e_NotEqual}};
+
+        // with a constant on the left, turn it around so the kernels only need to handle
+        // constants on the right.
+
+        static const std::map<Op, Op> reversed = {
+            {Op::e_Less, Op::e_Greater},       {Op::e_LessEqual, Op::e_GreaterEqual},
+            {Op::e_Greater, Op::e_Less},       {Op::e_GreaterEqual, Op::e_LessEqual},
+            {Op::e_Equal, Op::e_Equal},        {Op::e_NotEqual, Op::e_NotEqual}};
+
+        auto lhs = ParseOperand();
+
+        const auto &token = Current();
+        const auto found = token.kind_ == Token::Kind::e_Symbol ? comparisons.find(token.text_) : comparisons.end();
+        if (found == comparisons.end())
+        {
+            // a feature by itself
+
+            program_.push_back({.op_ = Op::e_NotEqual, .lhs_ = lhs, .rhs_ = {}});
+            return;
+        }
+        ++next_;
+
+        auto rhs = ParseOperand();
+        auto op = found->second;
+        if (lhs.feature_ == Feature::e_Constant && rhs.feature_ != Feature::e_Constant)
+        {
+            std::swap(lhs, rhs);
+            op = reversed.at(op);
+        }
+        program_.push_back({.op_ = op, .lhs_ = lhs, .rhs_ = rhs});
+    }
+
+    Operand ParseOperand()
+    {
+        static const std::map<std::string, Feature, std::less<>> features = {
+            {"columns", Feature::e_Columns},
+            {"new_columns", Feature::e_NewColumns},
+            {"reversal", Feature::e_Reversal},
+            {"box_size", Feature::e_BoxSize},
+            {"percent", Feature::e_Percent},
+            {"y_min", Feature::e_YMin},
+            {"y_max", Feature::e_YMax},
+            {"top", Feature::e_Top},
+            {"bottom", Feature::e_Bottom},
+            {"boxes_from_high", Feature::e_BoxesFromHigh},
+            {"boxes_from_low", Feature::e_BoxesFromLow},
+            {"direction", Feature::e_Direction},
+            {"signal", Feature::e_Signal},
+            {"moved", Feature::e_Moved},
+            {"reversed", Feature::e_Reversed},
+            {"new_signal", Feature::e_NewSignal},
+            {"trend_line", Feature::e_TrendLine},
+            {"boxes_from_trend_line", Feature::e_BoxesFromTrendLine},
+            {"trend_line_age", Feature::e_TrendLineAge},
+            {"trend_line_breached", Feature::e_TrendLineBreached},
+            {"objective", Feature::e_Objective},
+            {"pct_to_objective", Feature::e_PctToObjective}};
+
+        const auto token = Current();
+        if (token.kind_ == Token::Kind::e_Number)
+        {
+            ++next_;
+            return {.feature_ = Feature::e_Constant, .arg_ = 0, .value_ = token.value_};
+        }
+        if (token.kind_ != Token::Kind::e_Name || token.text_ == "and" || token.text_ == "or" || token.text_ == "not")
+        {
+            Fail("expected a feature, name or number");
+        }
+        ++next_;
+
+        if (Accept({"("}))
+        {
+            Operand result;
+            if (token.text_ == "col")
+            {
+                const auto back = Current();
+                if (back.kind_ != Token::Kind::e_Number || back.value_ < 0 ||
+                    back.value_ >= static_cast<double>(ChartSnapshot::kRecentColumns) ||
+                    back.value_ != static_cast<int32_t>(back.value_))
+                {
+                    Fail(std::format("col() wants a whole number from 0 to {}", ChartSnapshot::kRecentColumns - 1));
+                }
+                ++next_;
+                result = {
+                    .feature_ = Feature::e_RecentDirection, .arg_ = static_cast<int32_t>(back.value_), .value_ = 0};
+            }
+            else if (token.text_ == "signal_age")
+            {
+                const auto which = Current();
+                static const std::map<std::string, PF_SignalCategory, std::less<>> categories = {
+                    {"buy", PF_SignalCategory::e_PF_Buy},
+                    {"sell", PF_SignalCategory::e_PF_Sell},
+                    {"any", PF_SignalCategory::e_unknown}};
+                if (const auto category = categories.find(which.text_); category != categories.end())
+                {
+                    result = {.feature_ = Feature::e_CategorySignalAge,
+                              .arg_ = std::to_underlying(category->second),
+                              .value_ = 0};
+                }
+                else if (const auto signal_type = SignalTypeNames().find(which.text_);
+                         signal_type != SignalTypeNames().end())
+                {
+                    result = {.feature_ = Feature::e_SignalAge,
+                              .arg_ = std::to_underlying(signal_type->second),
+                              .value_ = 0};
+                }
+                else
+                {
+                    Fail("signal_age() wants a signal type, 'buy', 'sell' or 'any'");
+                }
+                ++next_;
+            }
+            else
+            {
+                Fail(std::format("unknown function '{}'", token.text_), token.pos_);
+            }
+            Expect(")");
+            return result;
+        }
+
+        if (const auto feature = features.find(token.text_); feature != features.end())
+        {
+            return {.feature_ = feature->second, .arg_ = 0, .value_ = 0};
+        }
+        if (token.text_ == "up" || token.text_ == "down")
+        {
+            const auto direction = token.text_ == "up" ? PF_Column::Direction::e_Up : PF_Column::Direction::e_Down;
+            return {.feature_ = Feature::e_Constant,
+                    .arg_ = 0,
+                    .value_ = static_cast<double>(std::to_underlying(direction))};
+        }
+        if (token.text_ == "support" || token.text_ == "resistance")
+        {
+            const auto kind = token.text_ == "support" ? PF_TrendLineKind::e_bullish_support
+                                                       : PF_TrendLineKind::e_bearish_resistance;
+            return {
+                .feature_ = Feature::e_Constant, .arg_ = 0, .value_ = static_cast<double>(std::to_underlying(kind))};
+        }
+        if (const auto signal_type = SignalTypeNames().find(token.text_); signal_type != SignalTypeNames().end())
+        {
+            return {.feature_ = Feature::e_Constant,
+                    .arg_ = 0,
+                    .value_ = static_cast<double>(std::to_underlying(signal_type->second))};
+        }
+        Fail(std::format("unknown name '{}'", token.text_), token.pos_);
+    }
+
+    const std::string &text_;
+    std::vector<Step> &program_;
+    std::vector<Token> tokens_;
+    std::size_t next_ = 0;
+};
+
+ScanPredicate::ScanPredicate(std::string text) : text_{std::move(text)}
+{
+    Parser{text_, program_}.Parse();
+}
+
+std::vector<double> ScanPredicate::LoadFeature(const ChartSnapshot &snapshot, const Operand &operand)
+{
+    switch (operand.feature_)
+    {
+        using enum Feature;
+        case e_Constant:
+            return std::vector<double>(snapshot.size(), operand.value_);
+        case e_Columns:
+            return AsDoubles(snapshot.columns_);
+        case e_NewColumns:
+            return AsDoubles(snapshot.new_columns_);
+        case e_Reversal:
+            return AsDoubles(snapshot.reversal_boxes_);
+        case e_BoxSize:
+            return snapshot.box_size_;
+        case e_Percent:
+        {
+            std::vector<double> result(snapshot.size());
+            rng::transform(snapshot.box_scale_, result.begin(),
+                           [](BoxScale scale) { return scale == BoxScale::e_Percent ? 1.0 : 0.0; });
+            return result;
+        }
+        case e_YMin:
+            return snapshot.y_min_;
+        case e_YMax:
+            return snapshot.y_max_;
+        case e_Top:
+            return snapshot.column_top_;
+        case e_Bottom:
+            return snapshot.column_bottom_;
+        case e_BoxesFromHigh:
+            return AsDoubles(snapshot.boxes_from_high_);
+        case e_BoxesFromLow:
+            return AsDoubles(snapshot.boxes_from_low_);
+        case e_Direction:
+            return AsDoubles(snapshot.direction_);
+        case e_RecentDirection:
+        {
+            const auto back = static_cast<std::size_t>(operand.arg_);
+            std::vector<double> result(snapshot.size());
+            for (std::size_t row = 0; row < result.size(); ++row)
+            {
+                result[row] = static_cast<double>(
+                    std::to_underlying(snapshot.recent_directions_[row * ChartSnapshot::kRecentColumns + back]));
+            }
+            return result;
+        }
+        case e_Signal:
+            return AsDoubles(snapshot.current_signal_);
+        case e_SignalAge:
+            return AsDoubles(snapshot.signal_age_[static_cast<std::size_t>(operand.arg_)]);
+        case e_CategorySignalAge:
+        {
+            // most recent of any signal type in the category
+
+            std::vector<int32_t> ages(snapshot.size(), ChartSnapshot::kNoSignalAge);
+            for (std::size_t which = 1; which < ChartSnapshot::kSignalTypes; ++which)
+            {
+                const auto category = SignalCategoryOf(static_cast<PF_SignalType>(which));
+                if (operand.arg_ != std::to_underlying(PF_SignalCategory::e_unknown) &&
+                    operand.arg_ != std::to_underlying(category))
+                {
+                    continue;
+                }
+                const auto &type_ages = snapshot.signal_age_[which];
+                for (std::size_t row = 0; row < ages.size(); ++row)
+                {
+                    ages[row] = std::min(ages[row], type_ages[row]);
+                }
+            }
+            return AsDoubles(ages);
+        }
+        case e_Moved:
+            return AsDoubles(snapshot.moved_);
+        case e_Reversed:
+            return AsDoubles(snapshot.reversed_);
+        case e_NewSignal:
+            return AsDoubles(snapshot.new_signal_);
+        case e_TrendLine:
+            return AsDoubles(snapshot.trend_line_);
+        case e_BoxesFromTrendLine:
+            return AsDoubles(snapshot.boxes_from_trend_line_);
+        case e_TrendLineAge:
+            return AsDoubles(snapshot.trend_line_age_);
+        case e_TrendLineBreached:
+            return AsDoubles(snapshot.trend_line_breached_);
+        case e_Objective:
+            return snapshot.objective_;
+        case e_PctToObjective:
+            return snapshot.pct_to_objective_;
+    }
+    return {};
+}
+
+ScanPredicate::Mask ScanPredicate::Evaluate(const ChartSnapshot &snapshot) const
+{
+    // a feature used more than once in a screen is only loaded once. Constants (numbers
+    // and names) are told apart by their value.
+
+    std::map<std::tuple<Feature, int32_t, double>, std::vector<double>> loaded;
+    auto column_for = [&snapshot, &loaded](const Operand &operand) -> const std::vector<double> & {
+        const auto value = operand.feature_ == Feature::e_Constant ? operand.value_ : 0.0;
+        auto [where, is_new] = loaded.try_emplace({operand.feature_, operand.arg_, value});
+        if (is_new)
+        {
+            where->second = LoadFeature(snapshot, operand);
+        }
+        return where->second;
+    };
+
+    std::vector<Mask> results;
+
+    for (const auto &step : program_)
+    {
+        switch (step.op_)
+        {
+            using enum Op;
+            case e_And:
+            case e_Or:
+            {
+                const auto rhs = std::move(results.back());
+                results.pop_back();
+                auto &lhs = results.back();
+                if (step.op_ == e_And)
+                {
+                    for (std::size_t row = 0; row < lhs.size(); ++row)
+                    {
+                        lhs[row] &= rhs[row];
+                    }
+                }
+                else
+                {
+                    for (std::size_t row = 0; row < lhs.size(); ++row)
+                    {
+                        lhs[row] |= rhs[row];
+                    }
+                }
+                break;
+            }
+            case e_Not:
+            {
+                auto &lhs = results.back();
+                for (std::size_t row = 0; row < lhs.size(); ++row)
+                {
+                    lhs[row] ^= 1;
+                }
+                break;
+            }
+            default:
+            {
+                // the parser keeps constants on the right so a constant is only loaded
+                // as a column when both sides are constant.
+
+                const auto &lhs = column_for(step.lhs_);
+                auto compare = [&step, &lhs](const auto &rhs) {
+                    switch (step.op_)
+                    {
+                        case e_Less:
+                            return CompareKernel(lhs, rhs, std::less<>{});
+                        case e_LessEqual:
+                            return CompareKernel(lhs, rhs, std::less_equal<>{});
+                        case e_Greater:
+                            return CompareKernel(lhs, rhs, std::greater<>{});
+                        case e_GreaterEqual:
+                            return CompareKernel(lhs, rhs, std::greater_equal<>{});
+                        case e_Equal:
+                            return CompareKernel(lhs, rhs, std::equal_to<>{});
+                        default:
+                            return CompareKernel(lhs, rhs, std::not_equal_to<>{});
+                    }
+                };
+                results.push_back(step.rhs_.feature_ == Feature::e_Constant ? compare(step.rhs_.value_)
+                                                                           : compare(column_for(step.rhs_)));
+                break;
+            }
+        }
+    }
+
+    return results.empty() ? Mask(snapshot.size(), 0) : std::move(results.back());
+}
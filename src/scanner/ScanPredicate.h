@@ -0,0 +1,126 @@
+#ifndef PF_SCANPREDICATE_INC
+#define PF_SCANPREDICATE_INC
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "scanner/ChartSnapshot.h"
+
+// =====================================================================================
+//        Class:  ScanPredicate
+//  Description:  an ad hoc screen over the chart snapshot, written as a little
+//                boolean expression instead of another SQL query. For example,
+//                1-box percent charts with a triple top buy in the last 3 columns
+//                which added a column today:
+//
+//      reversal == 1 and percent and signal_age(triple_top_buy) < 3 and new_columns > 0
+//
+//  Comparisons are < <= > >= == != between chart features and numbers, combined
+//  with and, or, not (or &&, ||, !) and parentheses. A feature by itself means
+//  'is not 0'.
+//
+//  features:
+//      columns, new_columns, reversal, box_size, percent, y_min, y_max,
+//      top, bottom (of the current column), boxes_from_high, boxes_from_low,
+//      direction, col(k) (direction k columns back, 0 is current), signal
+//      (type of the current column's signal), moved, reversed, new_signal,
+//      signal_age(type | buy | sell | any) (columns since the most recent one),
+//      trend_line (the 45 degree line in force), boxes_from_trend_line,
+//      trend_line_age (columns since it started), trend_line_breached (by the last move),
+//      objective (price objective of the most recent signal, 0 if none), pct_to_objective
+//      (percent still to go to it).
+//
+//  names:
+//      up, down, support, resistance and signal types, either as formatted
+//      ('triple_top_buy') or as stored in the DB ('tt_buy').
+//
+//  The text is compiled once into a list of steps each of which makes a pass over
+//  whole columns of the snapshot (1 comparison or 1 and/or/not of earlier results)
+//  so a screen over the whole universe is a handful of tight loops. Mistakes in the
+//  text are std::invalid_argument from the constructor.
+// =====================================================================================
+
+class ScanPredicate
+{
+public:
+    using Mask = std::vector<uint8_t>; // 1 per snapshot row, 1 if it matched
+
+    explicit ScanPredicate(std::string text);
+
+    [[nodiscard]] const std::string &GetText() const
+    {
+        return text_;
+    }
+
+    [[nodiscard]] Mask Evaluate(const ChartSnapshot &snapshot) const;
+
+private:
+    class Parser;
+
+    enum class Feature : int32_t
+    {
+        e_Constant,
+        e_Columns,
+        e_NewColumns,
+        e_Reversal,
+        e_BoxSize,
+        e_Percent,
+        e_YMin,
+        e_YMax,
+        e_Top,
+        e_Bottom,
+        e_BoxesFromHigh,
+        e_BoxesFromLow,
+        e_Direction,
+        e_RecentDirection,   // arg is how many columns back
+        e_Signal,
+        e_SignalAge,         // arg is the PF_SignalType
+        e_CategorySignalAge, // arg is the PF_SignalCategory. e_unknown means any signal
+        e_Moved,
+        e_Reversed,
+        e_NewSignal,
+        e_TrendLine,
+        e_BoxesFromTrendLine,
+        e_TrendLineAge,
+        e_TrendLineBreached,
+        e_Objective,
+        e_PctToObjective
+    };
+
+    struct Operand
+    {
+        Feature feature_ = Feature::e_Constant;
+        int32_t arg_ = 0;
+        double value_ = 0.0; // for e_Constant
+    };
+
+    enum class Op : int32_t
+    {
+        e_Less,
+        e_LessEqual,
+        e_Greater,
+        e_GreaterEqual,
+        e_Equal,
+        e_NotEqual,
+        e_And,
+        e_Or,
+        e_Not
+    };
+
+    // comparisons push a result, and/or pop 2 and push 1, not replaces the top one.
+
+    struct Step
+    {
+        Op op_ = Op::e_NotEqual;
+        Operand lhs_;
+        Operand rhs_;
+    };
+
+    [[nodiscard]] static std::vector<double> LoadFeature(const ChartSnapshot &snapshot, const Operand &operand);
+
+    std::string text_;
+    std::vector<Step> program_;
+};
+
+#endif
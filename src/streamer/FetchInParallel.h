@@ -0,0 +1,75 @@
+#ifndef PF_FETCHINPARALLEL_INC
+#define PF_FETCHINPARALLEL_INC
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <vector>
+
+// calls fetch(source, ndx) for each ndx in [0, count) on at most 'concurrency' threads.
+//
+// Each thread makes 1 source with make_source() (which returns a pointer) and uses it for
+// everything it fetches so it keeps 1 connection open for its share of the requests
+// instead of connecting for each of them. Threads take the next index as they finish
+// one so a slow response doesn't hold up the rest.
+//
+// fetch runs concurrently with itself so it must only write to its own ndx's results.
+// It should catch what it can live without. Anything which gets out stops the other
+// threads from starting new requests and is rethrown here once they are all done.
+
+template <typename MakeSource, typename Fetch>
+void FetchInParallel(std::size_t count, int32_t concurrency, MakeSource make_source, Fetch fetch)
+{
+    std::atomic<std::size_t> next_ndx{0};
+
+    auto worker = [&]() {
+        try
+        {
+            auto source = make_source();
+            for (auto ndx = next_ndx.fetch_add(1); ndx < count; ndx = next_ndx.fetch_add(1))
+            {
+                fetch(*source, ndx);
+            }
+        }
+        catch (...)
+        {
+            next_ndx.store(count);
+            throw;
+        }
+    };
+
+    const auto how_many_threads = std::min(count, static_cast<std::size_t>(std::max(1, concurrency)));
+    std::vector<std::future<void>> tasks;
+    tasks.reserve(how_many_threads);
+    for (std::size_t ndx = 0; ndx < how_many_threads; ++ndx)
+    {
+        tasks.push_back(std::async(std::launch::async, worker));
+    }
+
+    // wait for all of them before letting anything out. They're using our locals.
+
+    std::exception_ptr problem;
+    for (auto &task : tasks)
+    {
+        try
+        {
+            task.get();
+        }
+        catch (...)
+        {
+            if (!problem)
+            {
+                problem = std::current_exception();
+            }
+        }
+    }
+    if (problem)
+    {
+        std::rethrow_exception(problem);
+    }
+}
+
+#endif
@@ -0,0 +1,137 @@
+#ifndef PF_LATENCYHISTOGRAM_INC
+#define PF_LATENCYHISTOGRAM_INC
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// counts of values (nanoseconds, queue depths, ...) in log-linear buckets, HdrHistogram
+// style. Values below 2^kSubBucketBits get a bucket each. Above that each power of 2 is
+// split into 2^(kSubBucketBits - 1) buckets so any value is reported to within about 3%
+// no matter how big it is. Values past kMaxValue (about 18 minutes in nanoseconds) are
+// counted as kMaxValue.
+//
+// Exactly 1 thread records. Recording is a bucket calculation and an increment, no
+// locks and no read-modify-write. Any thread can read at any time and get counts which
+// are at most a few values behind.
+
+class LatencyHistogram
+{
+public:
+    static constexpr int32_t kSubBucketBits = 6;
+    static constexpr int32_t kMaxValueBits = 40;
+    static constexpr int64_t kMaxValue = (int64_t{1} << kMaxValueBits) - 1;
+
+    static constexpr int64_t kSubBucketHalf = int64_t{1} << (kSubBucketBits - 1);
+    static constexpr std::size_t kBucketCount =
+        static_cast<std::size_t>((kMaxValueBits - kSubBucketBits + 2) * kSubBucketHalf);
+
+    LatencyHistogram() = default;
+
+    LatencyHistogram(const LatencyHistogram &) = delete;
+    LatencyHistogram(LatencyHistogram &&) = delete;
+    ~LatencyHistogram() = default;
+
+    LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+    LatencyHistogram &operator=(LatencyHistogram &&) = delete;
+
+    // ====================  WRITER SIDE  =======================================
+
+    void Record(int64_t value)
+    {
+        value = std::clamp(value, int64_t{0}, kMaxValue);
+        auto &count = counts_[BucketFor(value)];
+        count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (value > max_.load(std::memory_order_relaxed))
+        {
+            max_.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    // ====================  READER SIDE  =======================================
+
+    // for summing histograms from several threads into 1 for reporting.
+    // Only the thread doing the summing may call Add on 'this'.
+
+    void Add(const LatencyHistogram &other)
+    {
+        for (std::size_t ndx = 0; ndx < kBucketCount; ++ndx)
+        {
+            const auto how_many = other.counts_[ndx].load(std::memory_order_relaxed);
+            if (how_many > 0)
+            {
+                counts_[ndx].store(counts_[ndx].load(std::memory_order_relaxed) + how_many,
+                                   std::memory_order_relaxed);
+            }
+        }
+        max_.store(std::max(max_.load(std::memory_order_relaxed), other.max_.load(std::memory_order_relaxed)),
+                   std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] uint64_t Count() const
+    {
+        uint64_t result{0};
+        for (const auto &count : counts_)
+        {
+            result += count.load(std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+    [[nodiscard]] int64_t Max() const { return max_.load(std::memory_order_relaxed); }
+
+    // highest value in the bucket holding the given percentile (0 - 100). 0 if empty.
+
+    [[nodiscard]] int64_t ValueAtPercentile(double percentile) const
+    {
+        const auto total = Count();
+        if (total == 0)
+        {
+            return 0;
+        }
+        const auto wanted = std::max(
+            uint64_t{1}, static_cast<uint64_t>(std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 * total)));
+        uint64_t so_far{0};
+        for (std::size_t ndx = 0; ndx < kBucketCount; ++ndx)
+        {
+            so_far += counts_[ndx].load(std::memory_order_relaxed);
+            if (so_far >= wanted)
+            {
+                return std::min(HighestValueIn(ndx), Max());
+            }
+        }
+        return Max();
+    }
+
+private:
+    static std::size_t BucketFor(int64_t value)
+    {
+        if (value < 2 * kSubBucketHalf)
+        {
+            return static_cast<std::size_t>(value);
+        }
+        const auto shift = std::bit_width(static_cast<uint64_t>(value)) - kSubBucketBits;
+        return static_cast<std::size_t>(shift * kSubBucketHalf + (value >> shift));
+    }
+
+    static int64_t HighestValueIn(std::size_t bucket)
+    {
+        const auto ndx = static_cast<int64_t>(bucket);
+        if (ndx < 2 * kSubBucketHalf)
+        {
+            return ndx;
+        }
+        const auto shift = ndx / kSubBucketHalf - 1;
+        const auto sub_bucket = ndx - shift * kSubBucketHalf;
+        return ((sub_bucket + 1) << shift) - 1;
+    }
+
+    std::array<std::atomic<uint64_t>, kBucketCount> counts_{};
+    std::atomic<int64_t> max_ = 0;
+};
+
+#endif
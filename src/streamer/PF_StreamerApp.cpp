@@ -32,6 +32,7 @@ namespace vws = std::ranges::views;
 #include "ConstructChartGraphic.h"
 #include "Eodhd.h"
 #include "Tiingo.h"
+#include "streamer/FetchInParallel.h"
 #include "utilities.h"
 
 // =====================================================================================
@@ -78,6 +79,11 @@ void PF_StreamerApp::SetupProgramOptions()
     app_.add_option("--graphics-format", graphics_format_i_, "Graphics format: 'svg' or 'csv'.")
         ->default_val("svg")
         ->check(CLI::IsMember({"svg", "csv"}));
+    app_.add_option("--renderer", renderer_i_,
+                    "What draws 'svg' charts and the summary graphic: 'chartdirector' or 'native' (built in, no "
+                    "ChartDirector).")
+        ->default_val("chartdirector")
+        ->check(CLI::IsMember({"chartdirector", "native"}));
 
     app_.add_option("--max-graphic-cols", max_columns_for_graph_, "Maximum columns in graphic (-1 = all).")
         ->default_val(-1)
@@ -133,7 +139,67 @@ void PF_StreamerApp::SetupProgramOptions()
     atr_or_minmax->add_flag("--use-ATR", use_ATR_, "Compute ATR and use to compute box size.");
     atr_or_minmax->add_flag("--use-MinMax", use_min_max_, "Use MinMax-based box size calculation.");
 
-    app_.add_flag("--resume", resume_mode_, "Resume streaming from saved data files.");
+    app_.add_flag("--resume", resume_mode_, "Resume streaming from today's tick journal or saved data files.");
+    app_.add_flag("--no-tick-journal", no_tick_journal_, "Don't keep a tick journal for crash recovery.");
+    app_.add_option("--tick-journal-commit-ms", tick_journal_commit_ms_,
+                    "Milliseconds between flushes of the tick journal to disk. At most this much is lost in a crash.")
+        ->default_val(100)
+        ->check(CLI::Range(1, 60'000));
+
+    // Pipeline tuning
+    app_.add_option("--ring-buffer-size", ring_buffer_size_,
+                    "Capacity of hand-off buffers between websocket, parser and chart processors.")
+        ->default_val(4096)
+        ->check(CLI::Range(16, 1 << 20));
+    app_.add_option("--spin-count", spin_count_,
+                    "Times a waiting pipeline stage spins before yielding then parking. 0 parks right away.")
+        ->default_val(512)
+        ->check(CLI::NonNegativeNumber);
+    app_.add_option("--streaming-connections", streaming_connections_,
+                    "Number of websocket connections to split the symbols over. Each gets its own thread.")
+        ->default_val(1)
+        ->check(CLI::Range(1, 64));
+    app_.add_option("--fetch-concurrency", fetch_concurrency_,
+                    "Number of quote and history requests to have going at once while setting up charts.")
+        ->default_val(8)
+        ->check(CLI::Range(1, 64));
+    app_.add_option("--processor-threads", processor_threads_,
+                    "Number of chart processing shards (threads). 0 means 1 per core.")
+        ->default_val(0)
+        ->check(CLI::NonNegativeNumber);
+    app_.add_option("--render-interval", render_interval_ms_,
+                    "Minimum milliseconds between redraws of a chart. Updates in between are coalesced.")
+        ->default_val(2000)
+        ->check(CLI::Range(0, 600'000));
+    app_.add_option("--render-threads", render_threads_, "Number of threads drawing updated charts.")
+        ->default_val(2)
+        ->check(CLI::Range(1, 64));
+    app_.add_option("--conflate-backlog", conflate_backlog_,
+                    "When this many ticks are waiting for a shard, skip the ones which can't change a chart. "
+                    "Charts come out the same. 0 turns this off.")
+        ->default_val(0)
+        ->check(CLI::NonNegativeNumber);
+    app_.add_option("--latency-report-seconds", latency_report_seconds_,
+                    "How often to log tick latency percentiles and queue depths. They are always logged when "
+                    "streaming ends. 0 means only then.")
+        ->default_val(300)
+        ->check(CLI::NonNegativeNumber);
+
+    app_.add_option("--breadth-seconds", breadth_seconds_,
+                    "How often to append the streamed charts' bullish percent and percent in X columns to "
+                    "'streamed_breadth.csv' in the output chart dir. 0 turns this off.")
+        ->default_val(60)
+        ->check(CLI::NonNegativeNumber);
+
+    app_.add_option("--signal-bus", signal_bus_name_,
+                    "Shared memory name (e.g. /pf_signals) to publish new signals on for other programs on this "
+                    "machine.");
+
+    // Benchmarking. pf_replay plays back recorded frames over a local websocket.
+    app_.add_option("--record-frames", record_frames_path_,
+                    "Save every frame received, with the time received, for playback by pf_replay.");
+    app_.add_flag("--simulated-clock", simulated_clock_,
+                  "Take the time from the streamed ticks, not the wall clock. Use when streaming from pf_replay.");
 
     // Compatibility options (accepted but ignored for streamer)
     app_.add_option("--new-data-source", new_data_source_i_, "Data source (ignored for streamer).");
@@ -207,6 +273,7 @@ bool PF_StreamerApp::Startup()
 
         // Parse graphics format
         graphics_format_ = graphics_format_i_ == "svg" ? GraphicsFormat::e_svg : GraphicsFormat::e_csv;
+        renderer_ = renderer_i_ == "native" ? GraphicsRenderer::e_native : GraphicsRenderer::e_chartdirector;
 
         // Parse quote data source
         if (!quote_data_source_i_.empty())
@@ -311,9 +378,14 @@ void PF_StreamerApp::Run()
 
 void PF_StreamerApp::Shutdown()
 {
+    // flushes anything not yet on disk. The journal is kept: it is how --resume
+    // rebuilds today's session.
+
+    tick_journal_.reset();
+
     // Save streamed data for resume functionality
-    SaveStreamedPricesToFiles();
-    SaveStreamedSummaryToFile();
+    SaveStreamedPricesToFiles(output_chart_directory_);
+    SaveStreamedSummaryToFile(output_chart_directory_);
 
     for (const auto &[symbol, chart] : charts_)
     {
@@ -327,8 +399,9 @@ void PF_StreamerApp::Shutdown()
             if (graphics_format_ == GraphicsFormat::e_svg)
             {
                 fs::path graph_file_path = output_graphs_directory_ / chart.MakeChartFileName("", "svg");
-                ConstructCDPFChartGraphicAndWriteToFile(chart, graph_file_path, streamed_prices_[chart.GetSymbol()],
-                                                        trend_lines_, X_AxisFormat::e_show_time);
+                ConstructPFChartGraphicAndWriteToFile(chart, graph_file_path,
+                                                      tick_histories_[symbol_ids_.at(symbol)].Snapshot(), trend_lines_,
+                                                      X_AxisFormat::e_show_time, renderer_);
             }
             else
             {
@@ -345,8 +418,15 @@ void PF_StreamerApp::Shutdown()
 
     if (graphics_format_ == GraphicsFormat::e_svg)
     {
-        fs::path summary_graphic_path = output_graphs_directory_ / "PF_StreamingSummary.svg";
-        ConstructCDSummaryGraphic(streamed_summary_, summary_graphic_path);
+        try
+        {
+            fs::path summary_graphic_path = output_graphs_directory_ / "PF_StreamingSummary.svg";
+            ConstructSummaryGraphicAndWriteToFile(MakeStreamedSummary(), summary_graphic_path, renderer_);
+        }
+        catch (const std::exception &e)
+        {
+            spdlog::error(std::format("Problem in shutdown: {} for summary graphic.", e.what()));
+        }
     }
 
     spdlog::info(std::format("\n\n*** End run {}  ***\n",
@@ -357,84 +437,148 @@ void PF_StreamerApp::Shutdown()
 
 void PF_StreamerApp::Run_Streaming()
 {
-    auto params = vws::cartesian_product(symbol_list_, box_size_list_, reversal_boxes_list_, scale_list_);
-
-    auto current_local_time = std::chrono::zoned_seconds(std::chrono::current_zone(),
-                                                         floor<std::chrono::seconds>(std::chrono::system_clock::now()));
-    auto market_status =
-        GetUS_MarketStatus(std::string_view{std::chrono::current_zone()->name()}, current_local_time.get_local_time());
+    // a replayed feed can be played any time. Its ticks say what time it is.
 
-    if (market_status != US_MarketStatus::e_NotOpenYet && market_status != US_MarketStatus::e_OpenForTrading)
+    if (!simulated_clock_)
     {
-        std::cout << "Market not open for trading now so we can't stream quotes.\n";
-        return;
-    }
+        auto current_local_time = std::chrono::zoned_seconds(
+            std::chrono::current_zone(), floor<std::chrono::seconds>(std::chrono::system_clock::now()));
+        auto market_status = GetUS_MarketStatus(std::string_view{std::chrono::current_zone()->name()},
+                                                current_local_time.get_local_time());
 
-    if (market_status == US_MarketStatus::e_NotOpenYet)
-    {
-        std::cout << "Market not open for trading YET so we'll wait." << std::endl;
+        if (market_status != US_MarketStatus::e_NotOpenYet && market_status != US_MarketStatus::e_OpenForTrading)
+        {
+            std::cout << "Market not open for trading now so we can't stream quotes.\n";
+            return;
+        }
+
+        if (market_status == US_MarketStatus::e_NotOpenYet)
+        {
+            std::cout << "Market not open for trading YET so we'll wait." << std::endl;
+        }
     }
 
     // === RESUME MODE: Load existing data ===
-    if (resume_mode_)
+    // today's tick journal has everything since the session started (even if we crashed)
+    // so prefer it unless it is marked incomplete. The JSON files written at shutdown are the fallback.
+
+    const auto journal_path = TickJournalPath();
+    const auto snapshot_path = TickJournalSnapshotPath();
+    TickJournalContents journal_contents;
+    bool use_journal = resume_mode_ && !no_tick_journal_ && fs::exists(journal_path);
+    if (use_journal)
+    {
+        journal_contents = ScanTickJournal(journal_path);
+        if (!journal_contents.complete_)
+        {
+            spdlog::info(std::format("Not using tick journal: {}. It is marked incomplete.", journal_path.string()));
+            use_journal = false;
+        }
+        else if (journal_contents.from_snapshot_ && !fs::exists(snapshot_path))
+        {
+            spdlog::error(std::format("Not using tick journal: {}. Can't find the snapshot it starts from: {}.",
+                                      journal_path.string(), snapshot_path.string()));
+            use_journal = false;
+        }
+    }
+    if (use_journal)
+    {
+        if (journal_contents.from_snapshot_)
+        {
+            LoadChartsFromFiles(snapshot_path);
+            IndexChartsBySymbol();
+            LoadStreamedPricesFromFiles(snapshot_path);
+            LoadStreamedSummaryFromFile(snapshot_path);
+        }
+        else
+        {
+            BuildChartsForStreaming();
+            IndexChartsBySymbol();
+        }
+        ReplayTickJournal(journal_path);
+        OpenTickJournal(TickJournal::OpenMode::e_append);
+        spdlog::info("Resume mode: rebuilt charts from tick journal");
+    }
+    else if (resume_mode_)
     {
-        LoadChartsFromFiles();
-        LoadStreamedPricesFromFiles();
-        LoadStreamedSummaryFromFile();
-        spdlog::info("Resume mode: loaded existing data");
+        LoadChartsFromFiles(output_chart_directory_);
+        IndexChartsBySymbol();
+        LoadStreamedPricesFromFiles(output_chart_directory_);
+        LoadStreamedSummaryFromFile(output_chart_directory_);
+
+        // a crash from here on is covered by a new journal which starts from what we just loaded.
+
+        StartTickJournalFromSnapshot();
+        spdlog::info("Resume mode: loaded existing data from JSON files.");
     }
     else
     {
         // === NORMAL MODE: Create new charts ===
-        std::map<std::string, decimal::Decimal> cache;
+        BuildChartsForStreaming();
+        OpenTickJournal(TickJournal::OpenMode::e_truncate);
 
-        for (const auto &val : params)
+        // a new journal doesn't start from a snapshot so any left from earlier today is of no use.
+
+        std::error_code ec;
+        fs::remove_all(snapshot_path, ec);
+        if (simulated_clock_)
         {
-            const auto &symbol = std::get<PF_Chart::e_symbol>(val);
-            try
+            // today's quotes have nothing to do with a recorded session.
+
+            IndexChartsBySymbol();
+        }
+        else
+        {
+            PrimeChartsForStreaming();
+        }
+    }
+
+    CollectStreamingData();
+}
+
+void PF_StreamerApp::BuildChartsForStreaming()
+{
+    auto params = vws::cartesian_product(symbol_list_, box_size_list_, reversal_boxes_list_, scale_list_);
+
+    // 1 history request per symbol. Get them all at once, not 1 chart at a time.
+
+    const auto atrs = use_ATR_ ? ComputeATRForSymbols(symbol_list_) : std::map<std::string, decimal::Decimal>{};
+
+    for (const auto &val : params)
+    {
+        const auto &symbol = std::get<PF_Chart::e_symbol>(val);
+        try
+        {
+            PF_Chart new_chart;
+            decimal::Decimal atr;
+            if (use_ATR_)
             {
-                PF_Chart new_chart;
-                decimal::Decimal atr;
-                if (use_ATR_)
+                const auto found = atrs.find(symbol);
+                if (found == atrs.end())
                 {
-                    atr = cache.contains(symbol) ? cache[symbol] : (cache[symbol] = ComputeATRForChart(symbol));
-                    new_chart = PF_Chart{atr, val, max_columns_for_graph_ < 1 ? -1 : max_columns_for_graph_};
+                    continue; // already logged
                 }
-                else
-                {
-                    atr = 0;
-                    new_chart = PF_Chart{val, atr, max_columns_for_graph_ < 1 ? -1 : max_columns_for_graph_};
-                }
-                charts_.emplace_back(std::make_pair(symbol, new_chart));
+                atr = found->second;
+                new_chart = PF_Chart{atr, val, max_columns_for_graph_ < 1 ? -1 : max_columns_for_graph_};
             }
-            catch (const std::exception &e)
+            else
             {
-                spdlog::error(std::format("Unable to compute ATR for: '{}' because: {}.\n", symbol, e.what()));
+                atr = 0;
+                new_chart = PF_Chart{val, atr, max_columns_for_graph_ < 1 ? -1 : max_columns_for_graph_};
             }
+            charts_.emplace_back(std::make_pair(symbol, new_chart));
         }
-
-        for (const auto &symbol : symbol_list_)
+        catch (const std::exception &e)
         {
-            streamed_prices_[symbol] = {};
-            streamed_summary_[symbol] = {};
+            spdlog::error(std::format("Unable to compute ATR for: '{}' because: {}.\n", symbol, e.what()));
         }
-
-        PrimeChartsForStreaming();
     }
-
-    // set up time delays between drawing chart updates
-    auto now = std::chrono::system_clock::now();
-    for (const auto &symbol : symbol_list_)
-    {
-        last_draw_times_[symbol] = now;
-    }
-    last_summary_draw_time_ = now;
-
-    CollectStreamingData();
 }
 
 void PF_StreamerApp::PrimeChartsForStreaming()
 {
+    IndexChartsBySymbol();
+
     auto today = std::chrono::year_month_day{floor<std::chrono::days>(std::chrono::system_clock::now())};
     std::chrono::year which_year = today.year();
     auto holidays = MakeHolidayList(which_year);
@@ -445,40 +589,49 @@ void PF_StreamerApp::PrimeChartsForStreaming()
     auto market_status =
         GetUS_MarketStatus(std::string_view{std::chrono::current_zone()->name()}, current_local_time.get_local_time());
 
-    std::unique_ptr<RemoteDataSource> history_getter;
-    if (quote_data_source_ == QuoteDataSource::e_Eodhd)
-    {
-        history_getter = std::make_unique<Eodhd>(Eodhd::Host{quote_host_name_}, Eodhd::Port{quote_host_port_},
-                                                 Eodhd::APIKey{quotes_api_key_}, Eodhd::Prefix{});
-    }
-    else
-    {
-        history_getter = std::make_unique<Tiingo>(Tiingo::Host{quote_host_name_}, Tiingo::Port{quote_host_port_},
-                                                  Tiingo::APIKey{quotes_api_key_}, Tiingo::Prefix{"/iex"});
-    }
+    // 1 request per symbol (or per batch of symbols). Keep several going at once.
+
+    const auto make_quote_source = [this]() { return MakeQuoteSource("/iex"); };
 
     if (market_status == US_MarketStatus::e_NotOpenYet)
     {
+        const auto prime_time_stamp = std::chrono::clock_cast<std::chrono::utc_clock>(current_local_time.get_sys_time());
+
+        auto symbols = charts_ | vws::keys | rng::to<std::vector<std::string>>();
+        const auto [new_end, end] = rng::unique(symbols);
+        symbols.erase(new_end, end);
+
+        std::vector<std::vector<StockDataRecord>> histories(symbols.size());
+        FetchInParallel(symbols.size(), fetch_concurrency_, make_quote_source,
+                        [&](RemoteDataSource &history_getter, std::size_t ndx) {
+                            histories[ndx] = history_getter.GetMostRecentTickerData(
+                                symbols[ndx], today, 2,
+                                price_fld_name_.starts_with("adj") ? UseAdjusted::e_Yes : UseAdjusted::e_No,
+                                &holidays);
+                        });
+
         std::map<std::string, std::vector<StockDataRecord>> cache;
+        for (auto &&[symbol, history] : vws::zip(symbols, histories))
+        {
+            cache.emplace(symbol, std::move(history));
+        }
 
         for (auto &[symbol, chart] : charts_)
         {
-            const auto history =
-                cache.contains(symbol)
-                    ? cache[symbol]
-                    : (cache[symbol] = history_getter->GetMostRecentTickerData(
-                           symbol, today, 2,
-                           price_fld_name_.starts_with("adj") ? UseAdjusted::e_Yes : UseAdjusted::e_No, &holidays));
-            chart.AddValue(history[0].close_,
-                           std::chrono::clock_cast<std::chrono::utc_clock>(current_local_time.get_sys_time()));
+            chart.AddValue(cache[symbol][0].close_, prime_time_stamp);
         }
 
         for (const auto &[symbol, h] : cache)
         {
             try
             {
-                streamed_summary_[symbol].opening_price_ = dec2dbl(h[0].close_);
-                streamed_summary_[symbol].latest_price_ = streamed_summary_[symbol].opening_price_;
+                auto &history = tick_histories_[symbol_ids_.at(symbol)];
+                history.SetOpeningPrice(dec2dbl(h[0].close_));
+                history.SetLatestPrice(dec2dbl(h[0].close_));
+
+                JournalValue(TickJournal::RecordType::e_chart_value, symbol, prime_time_stamp, h[0].close_);
+                JournalValue(TickJournal::RecordType::e_opening_price, symbol, prime_time_stamp, h[0].close_);
+                JournalValue(TickJournal::RecordType::e_latest_price, symbol, prime_time_stamp, h[0].close_);
             }
             catch (const std::exception &e)
             {
@@ -490,8 +643,19 @@ void PF_StreamerApp::PrimeChartsForStreaming()
     }
     else if (market_status == US_MarketStatus::e_OpenForTrading)
     {
-        history_getter->UseSymbols(symbol_list_);
-        auto history = history_getter->GetTopOfBookAndLastClose();
+        // split the symbols into a batch per request.
+
+        const auto batch_size = std::max<std::size_t>(
+            1, (symbol_list_.size() + fetch_concurrency_ - 1) / static_cast<std::size_t>(fetch_concurrency_));
+        const auto batches = symbol_list_ | vws::chunk(batch_size) | rng::to<std::vector<std::vector<std::string>>>();
+
+        std::vector<RemoteDataSource::TopOfBookList> batch_results(batches.size());
+        FetchInParallel(batches.size(), fetch_concurrency_, make_quote_source,
+                        [&](RemoteDataSource &history_getter, std::size_t ndx) {
+                            history_getter.UseSymbols(batches[ndx]);
+                            batch_results[ndx] = history_getter.GetTopOfBookAndLastClose();
+                        });
+        const auto history = batch_results | vws::join | rng::to<RemoteDataSource::TopOfBookList>();
 
         const auto close_time_stamp = std::chrono::clock_cast<std::chrono::utc_clock>(
             GetUS_MarketOpenTime(today).get_sys_time() - std::chrono::seconds{60});
@@ -500,392 +664,1326 @@ void PF_StreamerApp::PrimeChartsForStreaming()
 
         for (const auto &h : history)
         {
-            rng::for_each(
-                charts_ | vws::filter([&h](auto &symbol_and_chart) { return symbol_and_chart.first == h.symbol_; }),
-                [&](auto &symbol_and_chart) {
-                    try
-                    {
-                        symbol_and_chart.second.AddValue(h.previous_close_, close_time_stamp);
+            const auto which_symbol = symbol_ids_.find(h.symbol_);
+            if (which_symbol == symbol_ids_.end())
+            {
+                continue;
+            }
+            JournalValue(TickJournal::RecordType::e_chart_value, h.symbol_, close_time_stamp, h.previous_close_);
+            if (h.open_ != 0)
+            {
+                JournalValue(TickJournal::RecordType::e_chart_value, h.symbol_, open_time_stamp, h.open_);
+                JournalValue(TickJournal::RecordType::e_chart_value, h.symbol_, h.time_stamp_nsecs_, h.last_);
+            }
 
-                        if (h.open_ != 0)
-                        {
-                            symbol_and_chart.second.AddValue(h.open_, open_time_stamp);
-                            symbol_and_chart.second.AddValue(h.last_, h.time_stamp_nsecs_);
-                        }
-                    }
-                    catch (const std::exception &e)
+            const auto [first, last] = symbol_chart_ranges_[which_symbol->second];
+            rng::for_each(charts_ | vws::drop(first) | vws::take(last - first), [&](auto &symbol_and_chart) {
+                try
+                {
+                    symbol_and_chart.second.AddValue(h.previous_close_, close_time_stamp);
+
+                    if (h.open_ != 0)
                     {
-                        spdlog::error(
-                            std::format("Problem initializing PF_Chart with streaming data for symbol: {} because: {}",
-                                        h.symbol_, e.what()));
+                        symbol_and_chart.second.AddValue(h.open_, open_time_stamp);
+                        symbol_and_chart.second.AddValue(h.last_, h.time_stamp_nsecs_);
                     }
-                });
+                }
+                catch (const std::exception &e)
+                {
+                    spdlog::error(
+                        std::format("Problem initializing PF_Chart with streaming data for symbol: {} because: {}",
+                                    h.symbol_, e.what()));
+                }
+            });
         }
 
         for (const auto &h : history)
+        {
+            const auto which_symbol = symbol_ids_.find(h.symbol_);
+            if (which_symbol == symbol_ids_.end())
+            {
+                continue;
+            }
+            try
+            {
+                auto &tick_history = tick_histories_[which_symbol->second];
+                tick_history.SetOpeningPrice(dec2dbl(h.previous_close_));
+                JournalValue(TickJournal::RecordType::e_opening_price, h.symbol_, open_time_stamp, h.previous_close_);
+
+                const auto &latest_price = h.last_ == 0 ? h.previous_close_ : h.last_;
+                tick_history.SetLatestPrice(dec2dbl(latest_price));
+                JournalValue(TickJournal::RecordType::e_latest_price, h.symbol_, open_time_stamp, latest_price);
+            }
+            catch (const std::exception &e)
+            {
+                spdlog::error(
+                    std::format("Problem initializing streamed summary with streaming data for symbol: {} because: {}",
+                                h.symbol_, e.what()));
+            }
+        }
+    }
+}
+
+void PF_StreamerApp::IndexChartsBySymbol()
+{
+    // charts are built symbol by symbol so they should already be grouped but
+    // a stable sort makes sure of it without changing the order within a symbol.
+
+    symbol_ids_.clear();
+    for (int32_t id = 0; const auto &symbol : symbol_list_)
+    {
+        symbol_ids_.emplace(symbol, id++);
+    }
+
+    auto symbol_id = [this](const auto &symbol_and_chart) { return symbol_ids_.at(symbol_and_chart.first); };
+    rng::stable_sort(charts_, {}, symbol_id);
+
+    // everything per symbol is set up here, once, so nothing is created while streaming.
+
+    symbol_locks_ = std::vector<std::mutex>(symbol_list_.size());
+    tick_histories_ = std::vector<StreamedTickHistory>(symbol_list_.size());
+
+    symbol_chart_ranges_.assign(symbol_list_.size(), {0, 0});
+    for (std::size_t first = 0; first < charts_.size();)
+    {
+        const auto id = symbol_id(charts_[first]);
+        auto last = first + 1;
+        while (last < charts_.size() && symbol_id(charts_[last]) == id)
+        {
+            ++last;
+        }
+        symbol_chart_ranges_[id] = {first, last};
+        first = last;
+    }
+}
+
+void PF_StreamerApp::CollectStreamingData()
+{
+    std::cout << std::format("starting {} streaming.",
+                             streaming_data_source_ == StreamingSource::e_Eodhd ? "Eodhd" : "Tiingo")
+              << std::endl;
+
+    had_signal_ = false;
+
+    auto today = std::chrono::year_month_day{floor<std::chrono::days>(std::chrono::system_clock::now())};
+    auto local_market_close =
+        std::chrono::zoned_seconds(std::chrono::current_zone(), GetUS_MarketCloseTime(today).get_sys_time() + 2min);
+
+    const SpinThenPark wait_policy{.spin_count_ = spin_count_, .yield_count_ = spin_count_ > 0 ? 32 : 0};
+
+    // the symbol list can be split over several connections so TLS and websocket work for a
+    // big list isn't all done on 1 core. Each connection has its own io_context thread and parser.
+    //
+    // chart processing runs on a fixed number of shards rather than a thread per symbol.
+    // Each connection's parser feeds its own shards and each symbol is pinned to 1 shard so
+    // its ticks are still handled in the order received and each buffer still has exactly
+    // 1 producer and 1 consumer.
+
+    const auto symbol_count = static_cast<int32_t>(symbol_list_.size());
+    connection_count_ = std::max(1, std::min(streaming_connections_, symbol_count));
+
+    const auto max_shards = processor_threads_ > 0 ? processor_threads_
+                                                   : static_cast<int32_t>(std::max(1U, std::thread::hardware_concurrency()));
+    shards_per_connection_ = std::max(1, std::min(max_shards, symbol_count) / connection_count_);
+    const auto shard_count = connection_count_ * shards_per_connection_;
+
+    std::deque<RemoteDataSource::StreamerContext> streamer_contexts;
+    for (int32_t connection = 0; connection < connection_count_; ++connection)
+    {
+        streamer_contexts.emplace_back(static_cast<size_t>(ring_buffer_size_), wait_policy);
+    }
+    std::deque<RemoteDataSource::ProcessorContext> processor_contexts;
+    for (int32_t shard = 0; shard < shard_count; ++shard)
+    {
+        processor_contexts.emplace_back(static_cast<size_t>(ring_buffer_size_), wait_policy);
+    }
+
+    spdlog::info(std::format("Streaming {} symbols over {} connections. Processing on {} shards.", symbol_count,
+                             connection_count_, shard_count));
+
+    // drawing is slow compared to applying a tick so it gets its own threads.
+
+    render_data_.clear();
+    render_data_.resize(charts_.size());
+    render_scheduler_ = std::make_unique<RenderScheduler>(charts_.size() + 1,
+                                                          std::chrono::milliseconds{render_interval_ms_},
+                                                          render_threads_,
+                                                          [this](std::size_t which) { RenderStreamedUpdate(which); });
+
+    if (!record_frames_path_.empty())
+    {
+        frame_recording_.open(record_frames_path_, std::ios::out | std::ios::trunc);
+        if (!frame_recording_)
+        {
+            spdlog::error(
+                std::format("Unable to open file to record frames: {}. Not recording.", record_frames_path_.string()));
+        }
+    }
+
+    // the tick journal has been replayed by now so only new signals get published.
+
+    if (!signal_bus_name_.empty())
+    {
+        try
+        {
+            signal_bus_ = std::make_unique<SignalBus>(signal_bus_name_);
+            spdlog::info(std::format("Publishing new signals on: {}", signal_bus_name_));
+        }
+        catch (const std::exception &e)
+        {
+            spdlog::error(std::format("Unable to set up signal bus. Not publishing signals. {}", e.what()));
+        }
+    }
+
+    // every chart is looked at once here. After that only changes move the counts.
+
+    if (breadth_seconds_ > 0)
+    {
+        breadth_tracker_ = std::make_unique<BreadthTracker>();
+        const auto breadth_group = breadth_tracker_->AddGroup("STREAMED");
+        for (const auto &[symbol, chart] : charts_)
+        {
+            breadth_tracker_->AddChart(breadth_group, ChartBreadthState::ForChart(chart));
+        }
+    }
+
+    shard_latencies_.clear();
+    connection_queue_depths_.clear();
+    for (int32_t shard = 0; shard < shard_count; ++shard)
+    {
+        shard_latencies_.emplace_back();
+    }
+    for (int32_t connection = 0; connection < connection_count_; ++connection)
+    {
+        connection_queue_depths_.emplace_back();
+    }
+
+    std::vector<std::thread> processor_threads;
+    for (auto &&[context, latency] : vws::zip(processor_contexts, shard_latencies_))
+    {
+        processor_threads.emplace_back(&PF_StreamerApp::ProcessUpdatesForShard, this, std::ref(context),
+                                       std::ref(latency));
+    }
+
+    // each connection subscribes to just the symbols it will be sent.
+
+    std::vector<std::unique_ptr<RemoteDataSource>> streamers;
+    try
+    {
+        for (int32_t connection = 0; connection < connection_count_; ++connection)
+        {
+            streamers.push_back(MakeStreamingSource());
+            streamers.back()->UseSymbols(symbol_list_ | vws::drop(connection) | vws::stride(connection_count_) |
+                                         rng::to<std::vector<std::string>>());
+        }
+    }
+    catch (std::exception &e)
+    {
+        spdlog::error(std::format("Problem setting up {} streaming. Message: {}",
+                                  streaming_data_source_ == StreamingSource::e_Eodhd ? "Eodhd" : "Tiingo", e.what()));
+        streamers.clear();
+        had_signal_ = true;
+    }
+
+    std::vector<std::future<void>> parsing_tasks;
+    for (int32_t connection = 0; connection < static_cast<int32_t>(streamers.size()); ++connection)
+    {
+        parsing_tasks.push_back(std::async(std::launch::async, &PF_StreamerApp::StreamedDataParser, this,
+                                           std::ref(*streamers[connection]), connection,
+                                           std::ref(streamer_contexts[connection]), std::ref(processor_contexts)));
+    }
+
+    auto latency_report_task = std::async(std::launch::async, &PF_StreamerApp::ReportLatencyPeriodically, this,
+                                          std::cref(streamer_contexts), std::cref(processor_contexts));
+    auto breadth_task = std::async(std::launch::async, &PF_StreamerApp::RecordBreadthPeriodically, this);
+
+    auto timer_task =
+        simulated_clock_
+            ? std::async(std::launch::async, &PF_StreamerApp::WaitForSimulatedMarketClose, this)
+            : std::async(std::launch::async, &PF_AppBase::WaitForTimer, local_market_close);
+
+    // every connection reconnects (with backoff) on its own. When 1 of them is finished
+    // for good it sets had_signal_ and the rest stop after their next read.
+
+    std::vector<std::future<void>> streaming_tasks;
+    for (int32_t connection = 0; connection < static_cast<int32_t>(streamers.size()); ++connection)
+    {
+        streaming_tasks.push_back(std::async(std::launch::async, &RemoteDataSource::StreamData,
+                                             streamers[connection].get(), &had_signal_,
+                                             std::ref(streamer_contexts[connection])));
+    }
+    for (auto &streaming_task : streaming_tasks)
+    {
+        try
+        {
+            streaming_task.get();
+        }
+        catch (std::exception &e)
+        {
+            spdlog::error(std::format("Problem with {} streaming. Message: {}",
+                                      streaming_data_source_ == StreamingSource::e_Eodhd ? "Eodhd" : "Tiingo",
+                                      e.what()));
+        }
+        had_signal_ = true;
+    }
+
+    for (auto &context : streamer_contexts)
+    {
+        context.streamed_data_.Close();
+    }
+    for (auto &parsing_task : parsing_tasks)
+    {
+        parsing_task.get();
+    }
+
+    for (auto &context : processor_contexts)
+    {
+        context.extracted_data_.Close();
+    }
+
+    for (auto &thread : processor_threads)
+    {
+        thread.join();
+    }
+
+    // anything still waiting to be drawn will be drawn by Shutdown.
+
+    render_scheduler_.reset();
+    signal_bus_.reset();
+
+    breadth_task.get();
+    RecordBreadth();
+    breadth_tracker_.reset();
+
+    if (frame_recording_.is_open())
+    {
+        frame_recording_.close();
+    }
+    ReportStageStats();
+
+    latency_report_task.get();
+    ReportLatency(streamer_contexts, processor_contexts);
+
+    timer_task.get();
+    spdlog::debug("got here after timer expired");
+}
+
+std::unique_ptr<RemoteDataSource> PF_StreamerApp::MakeStreamingSource() const
+{
+    if (streaming_data_source_ == StreamingSource::e_Eodhd)
+    {
+        return std::make_unique<Eodhd>(Eodhd::Host{streaming_host_name_}, Eodhd::Port{streaming_host_port_},
+                                       Eodhd::APIKey{streaming_api_key_},
+                                       Eodhd::Prefix{std::string("/ws/us?api_token=") + streaming_api_key_});
+    }
+    return std::make_unique<Tiingo>(Tiingo::Host{streaming_host_name_}, Tiingo::Port{streaming_host_port_},
+                                    Tiingo::APIKey{streaming_api_key_}, Tiingo::Prefix{"/iex"});
+}
+
+std::size_t PF_StreamerApp::ShardForSymbol(int32_t symbol_id) const
+{
+    // connection first, then 1 of that connection's shards.
+
+    const auto connection = symbol_id % connection_count_;
+    const auto shard_in_connection = (symbol_id / connection_count_) % shards_per_connection_;
+    return static_cast<std::size_t>(connection * shards_per_connection_ + shard_in_connection);
+}
+
+void PF_StreamerApp::StreamedDataParser(RemoteDataSource &streamer, int32_t connection,
+                                        RemoteDataSource::StreamerContext &streamer_context,
+                                        std::deque<RemoteDataSource::ProcessorContext> &processor_contexts)
+{
+    // 1 of these runs per connection.
+    // symbols are assigned to connections and shards by their ID so the shard lookup is just arithmetic.
+
+    // take whatever has accumulated in one go. At the open that can be a lot.
+
+    constexpr std::size_t kMaxBatch = 256;
+    std::vector<RemoteDataSource::StreamedFrame> batch;
+    batch.reserve(kMaxBatch);
+
+    auto &queue_depth = connection_queue_depths_[connection];
+
+    while (streamer_context.streamed_data_.WaitForData(streamer_context.wait_policy_))
+    {
+        const auto batch_started = StageStats::Clock::now();
+        queue_depth.Record(static_cast<int64_t>(streamer_context.streamed_data_.size()));
+        streamer_context.streamed_data_.PopBatch(batch, kMaxBatch);
+        if (frame_recording_.is_open())
+        {
+            RecordFrames(batch);
+        }
+
+        int64_t newest_tick_ns = 0;
+        for (const auto &[new_data, received_ns] : batch)
         {
             try
             {
-                streamed_summary_[h.symbol_].opening_price_ = dec2dbl(h.previous_close_);
+                RemoteDataSource::PF_Data extracted_data = streamer.ExtractStreamedData(new_data);
+                if (extracted_data.ticker_.empty())
+                {
+                    continue;
+                }
+
+                // a symbol we didn't ask this connection for would give its shard a 2nd producer.
 
-                if (h.last_ == 0)
+                const auto which_symbol = symbol_ids_.find(extracted_data.ticker_);
+                if (which_symbol == symbol_ids_.end() || which_symbol->second % connection_count_ != connection)
                 {
-                    streamed_summary_[h.symbol_].latest_price_ = dec2dbl(h.previous_close_);
+                    continue;
                 }
-                else
+                extracted_data.symbol_id_ = which_symbol->second;
+                extracted_data.received_ns_ = received_ns;
+                newest_tick_ns =
+                    std::max(newest_tick_ns, extracted_data.time_stamp_nanoseconds_utc_.time_since_epoch().count());
+
+                // same test Do_ProcessUpdatesForSymbol uses to decide whether to use a tick.
+
+                if (tick_journal_ && extracted_data.last_price_ != -1 && extracted_data.last_size_ != 1)
                 {
-                    streamed_summary_[h.symbol_].latest_price_ = dec2dbl(h.last_);
+                    JournalValue(TickJournal::RecordType::e_tick, extracted_data.symbol_id_,
+                                 extracted_data.time_stamp_nanoseconds_utc_, extracted_data.last_price_);
                 }
+                auto &processor_ctx = processor_contexts[ShardForSymbol(extracted_data.symbol_id_)];
+                extracted_data.parsed_ns_ = RemoteDataSource::WallClockNanoseconds();
+                processor_ctx.extracted_data_.Push(std::move(extracted_data), processor_ctx.wait_policy_);
             }
             catch (const std::exception &e)
             {
-                spdlog::error(
-                    std::format("Problem initializing streamed summary with streaming data for symbol: {} because: {}",
-                                h.symbol_, e.what()));
+                spdlog::error("Error parsing websocket data: {}\n{}", new_data, e.what());
+            }
+        }
+        if (simulated_clock_)
+        {
+            auto simulated_now = simulated_now_ns_.load(std::memory_order_relaxed);
+            while (newest_tick_ns > simulated_now &&
+                   !simulated_now_ns_.compare_exchange_weak(simulated_now, newest_tick_ns, std::memory_order_relaxed))
+            {
             }
         }
+        parser_stats_.Record(batch.size(), batch_started, StageStats::Clock::now());
+        batch.clear();
+    }
+    std::println("Consumer/Producer: Work complete.");
+}
+
+void PF_StreamerApp::ProcessUpdatesForShard(RemoteDataSource::ProcessorContext &processor_context,
+                                            ShardLatency &latency)
+{
+    std::exception_ptr ep = nullptr;
+
+    constexpr std::size_t kMaxBatch = 256;
+    std::vector<RemoteDataSource::PF_Data> batch;
+    batch.reserve(kMaxBatch);
+
+    // 1 of these runs per shard. A batch can hold ticks for any of the shard's symbols
+    // but each symbol's ticks stay in arrival order.
+
+    while (processor_context.extracted_data_.WaitForData(processor_context.wait_policy_))
+    {
+        const auto batch_started = StageStats::Clock::now();
+        latency.queue_depth_.Record(static_cast<int64_t>(processor_context.extracted_data_.size()));
+        processor_context.extracted_data_.PopBatch(batch, kMaxBatch);
+
+        // fallen behind? Take everything waiting, group it by symbol (keeping each symbol's
+        // ticks in order) and let each symbol skip the ticks which can't change its charts.
+
+        const bool conflate = conflate_backlog_ > 0 && batch.size() + processor_context.extracted_data_.size() >=
+                                                           static_cast<std::size_t>(conflate_backlog_);
+        if (conflate)
+        {
+            processor_context.extracted_data_.PopBatch(batch, processor_context.extracted_data_.capacity());
+            rng::stable_sort(batch, {}, &RemoteDataSource::PF_Data::symbol_id_);
+        }
+
+        for (auto next = batch.begin(); next != batch.end();)
+        {
+            const auto run_end = conflate ? std::find_if(next, batch.end(),
+                                                         [symbol_id = next->symbol_id_](const auto &pf_data) {
+                                                             return pf_data.symbol_id_ != symbol_id;
+                                                         })
+                                          : next + 1;
+            try
+            {
+                if (conflate)
+                {
+                    Do_ProcessConflatedUpdatesForSymbol(std::span{next, run_end}, &latency);
+                }
+                else
+                {
+                    Do_ProcessUpdatesForSymbol(*next, &latency);
+                }
+            }
+            catch (std::system_error &e)
+            {
+                spdlog::error(e.what());
+                auto ec = e.code();
+                spdlog::error("Category: {}. Value: {}. Message: {}.", ec.category().name(), ec.value(), ec.message());
+
+                if (!ep)
+                {
+                    ep = std::current_exception();
+                }
+            }
+            catch (std::exception &e)
+            {
+                spdlog::error(e.what());
+
+                if (!ep)
+                {
+                    ep = std::current_exception();
+                }
+            }
+            catch (...)
+            {
+                spdlog::error("Unknown problem with an async download process");
+
+                if (!ep)
+                {
+                    ep = std::current_exception();
+                }
+            }
+            next = run_end;
+        }
+        processor_stats_.Record(batch.size(), batch_started, StageStats::Clock::now());
+        batch.clear();
+    }
+    std::println("Consumer: Work complete.");
+
+    if (ep)
+    {
+        std::rethrow_exception(ep);
+    }
+}
+
+void PF_StreamerApp::Do_ProcessUpdatesForSymbol(const RemoteDataSource::PF_Data &update, ShardLatency *latency)
+{
+    if (update.last_price_ == -1 || update.last_size_ == 1 || update.symbol_id_ < 0)
+    {
+        return;
+    }
+
+    // only this symbol's charts. No searching and no string compares.
+    // We just note what needs to be redrawn. Drawing happens elsewhere.
+
+    PF_SignalType new_signal{PF_SignalType::e_unknown};
+    int64_t updated_ns{0};
+
+    const auto [first, last] = symbol_chart_ranges_[update.symbol_id_];
+    {
+        std::lock_guard<std::mutex> lock(symbol_locks_[update.symbol_id_]);
+        for (auto ndx = first; ndx < last; ++ndx)
+        {
+            auto &chart = charts_[ndx].second;
+            try
+            {
+                const auto breadth_before = ChartBreadthState::ForChart(chart);
+                auto chart_changed =
+                    chart.AddValue(update.last_price_, PF_Column::TmPt{update.time_stamp_nanoseconds_utc_});
+                if (chart_changed != PF_Column::Status::e_Ignored)
+                {
+                    // no scheduler while replaying the tick journal. Nothing is drawn until we're live.
+
+                    if (render_scheduler_)
+                    {
+                        render_scheduler_->MarkDirty(ndx);
+                    }
+                    if (breadth_tracker_)
+                    {
+                        breadth_tracker_->Update(0, breadth_before, ChartBreadthState::ForChart(chart));
+                    }
+                    if (chart_changed == PF_Column::Status::e_AcceptedWithSignal)
+                    {
+                        const auto signal = chart.GetMostRecentSignal().value();
+                        new_signal = signal.signal_type_;
+                        if (signal_bus_)
+                        {
+                            signal_bus_->Publish(chart, signal);
+                        }
+                    }
+                }
+            }
+            catch (std::exception &e)
+            {
+                spdlog::error(std::format("Problem adding streamed value to chart for symbol: {} because: {}.",
+                                          update.ticker_, e.what()));
+            }
+        }
+
+        updated_ns = RemoteDataSource::WallClockNanoseconds();
+        CollectStreamedData(update, new_signal);
+    }
+
+    if (render_scheduler_)
+    {
+        render_scheduler_->MarkDirty(charts_.size());
+    }
+    if (latency != nullptr)
+    {
+        RecordLatency(update, updated_ns,
+                      new_signal != PF_SignalType::e_unknown ? RemoteDataSource::WallClockNanoseconds() : 0, *latency);
+    }
+}
+
+void PF_StreamerApp::Do_ProcessConflatedUpdatesForSymbol(std::span<const RemoteDataSource::PF_Data> updates,
+                                                         ShardLatency *latency)
+{
+    // same outcome as Do_ProcessUpdatesForSymbol on each tick in turn but a chart only
+    // sees the ticks which could change it. Anything inside the chart's quiet range would
+    // be ignored anyway. The last tick always goes through so the chart's 'last checked'
+    // bookkeeping ends up the same too.
+
+    std::vector<const RemoteDataSource::PF_Data *> ticks;
+    ticks.reserve(updates.size());
+    for (const auto &update : updates)
+    {
+        if (update.last_price_ != -1 && update.last_size_ != 1 && update.symbol_id_ >= 0)
+        {
+            ticks.push_back(&update);
+        }
+    }
+    if (ticks.empty())
+    {
+        return;
+    }
+
+    const auto symbol_id = ticks.front()->symbol_id_;
+    std::vector<PF_SignalType> new_signals(ticks.size(), PF_SignalType::e_unknown);
+    int64_t skipped{0};
+    int64_t updated_ns{0};
+
+    const auto [first, last] = symbol_chart_ranges_[symbol_id];
+    {
+        std::lock_guard<std::mutex> lock(symbol_locks_[symbol_id]);
+        for (auto ndx = first; ndx < last; ++ndx)
+        {
+            auto &chart = charts_[ndx].second;
+            bool chart_changed = false;
+            const auto breadth_before = ChartBreadthState::ForChart(chart);
+            auto quiet = chart.QuietRange();
+            for (std::size_t i = 0; i < ticks.size(); ++i)
+            {
+                const auto &update = *ticks[i];
+                if (i + 1 < ticks.size() && quiet && quiet->first < update.last_price_ &&
+                    update.last_price_ < quiet->second)
+                {
+                    ++skipped;
+                    continue;
+                }
+                try
+                {
+                    const auto status =
+                        chart.AddValue(update.last_price_, PF_Column::TmPt{update.time_stamp_nanoseconds_utc_});
+                    if (status != PF_Column::Status::e_Ignored)
+                    {
+                        chart_changed = true;
+                        quiet = chart.QuietRange();
+                        if (status == PF_Column::Status::e_AcceptedWithSignal)
+                        {
+                            const auto signal = chart.GetMostRecentSignal().value();
+                            new_signals[i] = signal.signal_type_;
+                            if (signal_bus_)
+                            {
+                                signal_bus_->Publish(chart, signal);
+                            }
+                        }
+                    }
+                }
+                catch (std::exception &e)
+                {
+                    spdlog::error(std::format("Problem adding streamed value to chart for symbol: {} because: {}.",
+                                              update.ticker_, e.what()));
+                }
+            }
+            if (chart_changed && render_scheduler_)
+            {
+                render_scheduler_->MarkDirty(ndx);
+            }
+            if (chart_changed && breadth_tracker_)
+            {
+                breadth_tracker_->Update(0, breadth_before, ChartBreadthState::ForChart(chart));
+            }
+        }
+
+        updated_ns = RemoteDataSource::WallClockNanoseconds();
+
+        // streamed prices keep only the last price in each second along with the latest
+        // signal in that second so the last tick of each second is all they need.
+
+        auto second_of = [](const RemoteDataSource::PF_Data *update) {
+            return std::chrono::duration_cast<std::chrono::seconds>(
+                       update->time_stamp_nanoseconds_utc_.time_since_epoch())
+                .count();
+        };
+        PF_SignalType signal_this_second{PF_SignalType::e_unknown};
+        for (std::size_t i = 0; i < ticks.size(); ++i)
+        {
+            if (new_signals[i] != PF_SignalType::e_unknown)
+            {
+                signal_this_second = new_signals[i];
+            }
+            if (i + 1 == ticks.size() || second_of(ticks[i + 1]) != second_of(ticks[i]))
+            {
+                CollectStreamedData(*ticks[i], signal_this_second);
+                signal_this_second = PF_SignalType::e_unknown;
+            }
+        }
+    }
+    conflated_updates_.fetch_add(skipped, std::memory_order_relaxed);
+
+    if (render_scheduler_)
+    {
+        render_scheduler_->MarkDirty(charts_.size());
+    }
+    if (latency != nullptr)
+    {
+        // skipped ticks count too. They were done with when their run was.
+
+        const auto signal_ns =
+            rng::any_of(new_signals, [](auto signal) { return signal != PF_SignalType::e_unknown; })
+                ? RemoteDataSource::WallClockNanoseconds()
+                : 0;
+        for (std::size_t i = 0; i < ticks.size(); ++i)
+        {
+            RecordLatency(*ticks[i], updated_ns, new_signals[i] != PF_SignalType::e_unknown ? signal_ns : 0,
+                          *latency);
+        }
+    }
+}
+
+void PF_StreamerApp::RenderStreamedUpdate(std::size_t which)
+{
+    // runs on a render thread. Copy what we need while holding the symbol's lock
+    // then draw from the copy so tick processing only waits for the copy.
+
+    const auto render_started = StageStats::Clock::now();
+    if (which == charts_.size())
+    {
+        try
+        {
+            fs::path summary_graphic_path = output_graphs_directory_ / "PF_StreamingSummary.svg";
+            ConstructSummaryGraphicAndWriteToFile(MakeStreamedSummary(), summary_graphic_path, renderer_);
+        }
+        catch (const std::exception &e)
+        {
+            spdlog::error(std::string("Problem creating summary graphic for updated streamed values: ") + e.what());
+        }
+        render_stats_.Record(1, render_started, StageStats::Clock::now());
+        return;
+    }
+
+    const auto &[symbol, live_chart] = charts_[which];
+    const auto symbol_id = symbol_ids_.at(symbol);
+    auto [chart, prices] = [&] {
+        std::lock_guard<std::mutex> lock(symbol_locks_[symbol_id]);
+        return std::pair{live_chart, tick_histories_[symbol_id].Snapshot()};
+    }();
+
+    try
+    {
+        fs::path graph_file_path = output_graphs_directory_ / (chart.MakeChartFileName("", "svg"));
+        ConstructPFChartGraphicAndWriteToFile(chart, graph_file_path, prices, trend_lines_, X_AxisFormat::e_show_time,
+                                              renderer_, &render_data_[which]);
+
+        fs::path chart_file_path = output_chart_directory_ / (chart.MakeChartFileName("", "json"));
+        chart.ConvertChartToJsonAndWriteToFile(chart_file_path);
+    }
+    catch (std::exception &e)
+    {
+        spdlog::error(std::string("Problem creating graphic for updated streamed value: ") +
+                      chart.GetChartBaseName() + " " + e.what());
+    }
+    render_stats_.Record(1, render_started, StageStats::Clock::now());
+}
+
+void PF_StreamerApp::CollectStreamedData(const RemoteDataSource::PF_Data &update, PF_SignalType new_signal)
+{
+    // only the shard which owns this symbol gets here so we are the only writer.
+
+    auto &history = tick_histories_[update.symbol_id_];
+    const auto new_price = dec2dbl(update.last_price_);
+
+    const auto new_time_stamp =
+        std::chrono::duration_cast<std::chrono::seconds>(update.time_stamp_nanoseconds_utc_.time_since_epoch()).count();
+    if (!history.empty() && new_time_stamp <= history.LastTimestamp())
+    {
+        history.UpdateLast(new_price, new_signal != PF_SignalType::e_unknown
+                                          ? std::optional<int32_t>{std::to_underlying(new_signal)}
+                                          : std::nullopt);
+    }
+    else
+    {
+        history.Append(new_time_stamp, new_price, std::to_underlying(new_signal));
+    }
+
+    history.SetLatestPrice(new_price);
+}
+
+PF_StreamedSummary PF_StreamerApp::MakeStreamedSummary() const
+{
+    PF_StreamedSummary summary;
+    for (const auto &[symbol, id] : symbol_ids_)
+    {
+        summary.emplace(symbol, tick_histories_[id].SummarySnapshot());
+    }
+    return summary;
+}
+
+void PF_StreamerApp::RecordFrames(const std::vector<RemoteDataSource::StreamedFrame> &frames)
+{
+    // 1 frame per line: receive time (nanoseconds since epoch) <tab> frame.
+    // Frames are compact JSON but make sure a stray newline can't split one.
+    // Each connection's parser writes here so whole batches are written under the lock.
+
+    std::lock_guard<std::mutex> lock(frame_recording_mtx_);
+    for (const auto &[frame, received_ns] : frames)
+    {
+        frame_recording_ << received_ns << '\t';
+        if (frame.find('\n') == std::string::npos)
+        {
+            frame_recording_ << frame;
+        }
+        else
+        {
+            auto one_line = frame;
+            rng::replace(one_line, '\n', ' ');
+            frame_recording_ << one_line;
+        }
+        frame_recording_ << '\n';
+    }
+}
+
+void PF_StreamerApp::WaitForSimulatedMarketClose()
+{
+    // same as WaitForTimer but 'now' is the newest tick seen. We stop at the close of
+    // the day the first tick was on or when the feed ends, whichever comes first.
+
+    std::optional<std::chrono::sys_seconds> stop_at;
+    while (!had_signal_)
+    {
+        const auto newest_tick_ns = simulated_now_ns_.load(std::memory_order_relaxed);
+        if (newest_tick_ns != 0)
+        {
+            const auto now = std::chrono::clock_cast<std::chrono::system_clock>(
+                std::chrono::utc_time<std::chrono::nanoseconds>{std::chrono::nanoseconds{newest_tick_ns}});
+            if (!stop_at)
+            {
+                const std::chrono::year_month_day trading_day{floor<std::chrono::days>(now)};
+                stop_at = GetUS_MarketCloseTime(trading_day).get_sys_time() + 2min;
+                spdlog::info(std::format("Simulated clock. Streaming stops at: {:%F %T} UTC.", *stop_at));
+            }
+            if (now >= *stop_at)
+            {
+                std::cout << "\n*** Simulated timer expired. ***" << std::endl;
+                had_signal_ = true;
+                break;
+            }
+        }
+        std::this_thread::sleep_for(100ms);
+    }
+}
+
+void PF_StreamerApp::ReportStageStats() const
+{
+    // rate is over the time the stage was active (first batch started to last batch finished).
+    // busy time per message is how long the stage itself spent on each, not counting waiting.
+    // The processors are added up over all shards.
+
+    auto report = [](std::string_view stage, const StageStats &stats) {
+        const auto messages = stats.messages_.load(std::memory_order_relaxed);
+        if (messages == 0)
+        {
+            spdlog::info(std::format("{:<10} nothing processed.", stage));
+            return;
+        }
+        const auto elapsed_seconds =
+            static_cast<double>(stats.last_ns_.load(std::memory_order_relaxed) -
+                                stats.first_ns_.load(std::memory_order_relaxed)) / 1e9;
+        const auto busy_us = static_cast<double>(stats.busy_ns_.load(std::memory_order_relaxed)) / 1e3;
+        spdlog::info(std::format("{:<10} {:>10} in {:>9.3f} s = {:>10.0f} per sec. Busy {:>9.2f} us each.", stage,
+                                 messages, elapsed_seconds, elapsed_seconds > 0 ? messages / elapsed_seconds : 0.0,
+                                 busy_us / static_cast<double>(messages)));
+    };
+
+    report("parser", parser_stats_);
+    report("processor", processor_stats_);
+    report("renderer", render_stats_);
+
+    const auto parser_done = parser_stats_.last_ns_.load(std::memory_order_relaxed);
+    const auto processors_done = processor_stats_.last_ns_.load(std::memory_order_relaxed);
+    if (parser_done != 0 && processors_done != 0)
+    {
+        spdlog::info(std::format("Processors finished {:.3f} ms after the parser.",
+                                 static_cast<double>(processors_done - parser_done) / 1e6));
+    }
+    if (conflate_backlog_ > 0)
+    {
+        spdlog::info(std::format("Conflation skipped {} chart updates.",
+                                 conflated_updates_.load(std::memory_order_relaxed)));
     }
 }
 
-void PF_StreamerApp::CollectStreamingData()
+void PF_StreamerApp::RecordLatency(const RemoteDataSource::PF_Data &update, int64_t updated_ns, int64_t signal_ns,
+                                   ShardLatency &latency) const
 {
-    std::cout << std::format("starting {} streaming.",
-                             streaming_data_source_ == StreamingSource::e_Eodhd ? "Eodhd" : "Tiingo")
-              << std::endl;
-
-    had_signal_ = false;
+    // ticks replayed from the tick journal were never received so there is nothing to time.
 
-    auto today = std::chrono::year_month_day{floor<std::chrono::days>(std::chrono::system_clock::now())};
-    auto local_market_close =
-        std::chrono::zoned_seconds(std::chrono::current_zone(), GetUS_MarketCloseTime(today).get_sys_time() + 2min);
+    if (update.received_ns_ == 0)
+    {
+        return;
+    }
 
-    RemoteDataSource::StreamerContext streamer_context;
-    std::vector<RemoteDataSource::ProcessorContext> processor_contexts(symbol_list_.size());
+    // the services' clocks aren't ours so a little negative lag shows up as 0.
+    // Replayed frames carry the original feed times so feed lag means nothing then.
 
-    std::map<std::string, int> symbol_to_context_map;
-    int indx = 0;
-    for (const auto &symbol : symbol_list_)
+    if (!simulated_clock_)
     {
-        symbol_to_context_map[symbol] = indx++;
+        const auto feed_ns =
+            std::chrono::utc_clock::to_sys(update.time_stamp_nanoseconds_utc_).time_since_epoch().count();
+        latency.feed_lag_.Record(update.received_ns_ - feed_ns);
     }
-
-    std::vector<std::thread> processor_threads;
-    for (auto &context : processor_contexts)
+    latency.parse_.Record(update.parsed_ns_ - update.received_ns_);
+    latency.update_.Record(updated_ns - update.parsed_ns_);
+    latency.end_to_end_.Record(updated_ns - update.received_ns_);
+    if (signal_ns != 0)
     {
-        processor_threads.emplace_back(&PF_StreamerApp::ProcessUpdatesForSymbol, this, std::ref(context));
+        latency.signal_.Record(signal_ns - update.received_ns_);
     }
+}
 
-    auto parsing_task =
-        std::async(std::launch::async, &PF_StreamerApp::StreamedDataParser, this, std::ref(streamer_context),
-                   std::ref(processor_contexts), std::ref(symbol_to_context_map));
-
-    auto timer_task = std::async(std::launch::async, &PF_AppBase::WaitForTimer, local_market_close);
+void PF_StreamerApp::ReportLatencyPeriodically(
+    const std::deque<RemoteDataSource::StreamerContext> &streamer_contexts,
+    const std::deque<RemoteDataSource::ProcessorContext> &processor_contexts) const
+{
+    if (latency_report_seconds_ == 0)
+    {
+        return;
+    }
 
-    try
+    const auto interval = std::chrono::seconds{latency_report_seconds_};
+    auto next_report = std::chrono::steady_clock::now() + interval;
+    while (!had_signal_)
     {
-        if (streaming_data_source_ == StreamingSource::e_Eodhd)
+        std::this_thread::sleep_for(1s);
+        if (std::chrono::steady_clock::now() >= next_report)
         {
-            PF_streamer_ = std::make_unique<Eodhd>(
-                Eodhd::Host{streaming_host_name_}, Eodhd::Port{streaming_host_port_}, Eodhd::APIKey{streaming_api_key_},
-                Eodhd::Prefix{std::string("/ws/us?api_token=") + streaming_api_key_});
+            ReportLatency(streamer_contexts, processor_contexts);
+            next_report += interval;
         }
-        else
+    }
+}
+
+void PF_StreamerApp::RecordBreadthPeriodically() const
+{
+    if (!breadth_tracker_)
+    {
+        return;
+    }
+
+    const auto interval = std::chrono::seconds{breadth_seconds_};
+    auto next_record = std::chrono::steady_clock::now() + interval;
+    while (!had_signal_)
+    {
+        std::this_thread::sleep_for(1s);
+        if (std::chrono::steady_clock::now() >= next_record)
         {
-            PF_streamer_ =
-                std::make_unique<Tiingo>(Tiingo::Host{streaming_host_name_}, Tiingo::Port{streaming_host_port_},
-                                         Tiingo::APIKey{streaming_api_key_}, Tiingo::Prefix{"/iex"});
+            RecordBreadth();
+            next_record += interval;
         }
+    }
+}
+
+void PF_StreamerApp::RecordBreadth() const
+{
+    if (!breadth_tracker_)
+    {
+        return;
+    }
+
+    // 1 line per sample so the file is a time series which survives restarts.
 
-        PF_streamer_->UseSymbols(symbol_list_);
+    const auto now = simulated_clock_ ? std::chrono::clock_cast<std::chrono::system_clock>(
+                                            std::chrono::utc_time<std::chrono::nanoseconds>{
+                                                std::chrono::nanoseconds{simulated_now_ns_.load()}})
+                                      : std::chrono::system_clock::now();
 
-        auto streaming_task = std::async(std::launch::async, &RemoteDataSource::StreamData, PF_streamer_.get(),
-                                         &had_signal_, std::ref(streamer_context));
-        streaming_task.get();
+    const fs::path breadth_file = output_chart_directory_ / "streamed_breadth.csv";
+    const bool new_file = !fs::exists(breadth_file);
+    std::ofstream breadth_output{breadth_file, std::ios::out | std::ios::app};
+    if (!breadth_output)
+    {
+        spdlog::error(std::format("Unable to open file: {} to record breadth.", breadth_file));
+        return;
     }
-    catch (std::exception &e)
+    if (new_file)
     {
-        spdlog::error(std::format("Problem with {} streaming. Message: {}",
-                                  streaming_data_source_ == StreamingSource::e_Eodhd ? "Eodhd" : "Tiingo", e.what()));
-        had_signal_ = true;
+        breadth_output << "time,group,charts,in_x_columns,on_buy_signal,percent_in_x_columns,bullish_percent\n";
+    }
+    for (std::size_t group = 0; group < breadth_tracker_->GroupCount(); ++group)
+    {
+        const auto tally = breadth_tracker_->GetTally(group);
+        breadth_output << std::format("{:%F %T},{},{},{},{},{:.2f},{:.2f}\n",
+                                      std::chrono::floor<std::chrono::seconds>(now),
+                                      breadth_tracker_->GroupName(group), tally.charts_, tally.in_x_columns_,
+                                      tally.on_buy_signal_, tally.PercentInXColumns(), tally.BullishPercent());
+        spdlog::debug(std::format("{}: bullish percent: {:.1f}%. In X columns: {:.1f}%.",
+                                  breadth_tracker_->GroupName(group), tally.BullishPercent(),
+                                  tally.PercentInXColumns()));
     }
+}
 
-    streamer_context.done_ = true;
-    streamer_context.cv_.notify_one();
-    parsing_task.get();
+void PF_StreamerApp::ReportLatency(const std::deque<RemoteDataSource::StreamerContext> &streamer_contexts,
+                                   const std::deque<RemoteDataSource::ProcessorContext> &processor_contexts) const
+{
+    // everything since streaming started, all shards together.
+
+    auto report = [](std::string_view what, const LatencyHistogram &histogram, double scale) {
+        spdlog::info(std::format("{:<24} {:>10} {:>10.1f} {:>10.1f} {:>10.1f} {:>10.1f}", what, histogram.Count(),
+                                 static_cast<double>(histogram.ValueAtPercentile(50.0)) / scale,
+                                 static_cast<double>(histogram.ValueAtPercentile(99.0)) / scale,
+                                 static_cast<double>(histogram.ValueAtPercentile(99.9)) / scale,
+                                 static_cast<double>(histogram.Max()) / scale));
+    };
+    auto report_stage = [this, &report](std::string_view what, LatencyHistogram ShardLatency::*stage) {
+        LatencyHistogram all_shards;
+        for (const auto &latency : shard_latencies_)
+        {
+            all_shards.Add(latency.*stage);
+        }
+        report(what, all_shards, 1e3);
+    };
 
-    for (auto &context : processor_contexts)
+    spdlog::info(std::format("{:<24} {:>10} {:>10} {:>10} {:>10} {:>10}", "Tick latency (us)", "count", "p50", "p99",
+                             "p99.9", "max"));
+    if (!simulated_clock_)
     {
-        context.done_ = true;
-        context.cv_.notify_one();
+        report_stage("feed -> received", &ShardLatency::feed_lag_);
     }
+    report_stage("received -> parsed", &ShardLatency::parse_);
+    report_stage("parsed -> charts updated", &ShardLatency::update_);
+    report_stage("received -> charts", &ShardLatency::end_to_end_);
+    report_stage("received -> signal", &ShardLatency::signal_);
 
-    for (auto &thread : processor_threads)
+    // depths are sampled by each consumer as it takes a batch.
+
+    LatencyHistogram parser_depths;
+    for (const auto &depths : connection_queue_depths_)
     {
-        thread.join();
+        parser_depths.Add(depths);
+    }
+    LatencyHistogram shard_depths;
+    for (const auto &latency : shard_latencies_)
+    {
+        shard_depths.Add(latency.queue_depth_);
     }
 
-    timer_task.get();
-    spdlog::debug("got here after timer expired");
+    spdlog::info(std::format("{:<24} {:>10} {:>10} {:>10} {:>10} {:>10}", "Queue depth (messages)", "batches", "p50",
+                             "p99", "p99.9", "max"));
+    report("waiting to be parsed", parser_depths, 1.0);
+    report("waiting for shards", shard_depths, 1.0);
+
+    auto sizes = [](const auto &contexts, auto which) {
+        return contexts | vws::transform([which](const auto &context) { return (context.*which).size(); }) |
+               rng::to<std::vector<std::size_t>>();
+    };
+    spdlog::info(std::format("Waiting now. Parsers: {} Shards: {}",
+                             sizes(streamer_contexts, &RemoteDataSource::StreamerContext::streamed_data_),
+                             sizes(processor_contexts, &RemoteDataSource::ProcessorContext::extracted_data_)));
 }
 
-void PF_StreamerApp::StreamedDataParser(RemoteDataSource::StreamerContext &streamer_context,
-                                        std::vector<RemoteDataSource::ProcessorContext> &processor_contexts,
-                                        std::map<std::string, int> &symbol_to_context_map)
+std::unique_ptr<RemoteDataSource> PF_StreamerApp::MakeQuoteSource(const std::string &tiingo_prefix) const
 {
-    while (true)
+    if (quote_data_source_ == QuoteDataSource::e_Eodhd)
     {
-        std::string new_data;
-        {
-            std::unique_lock<std::mutex> lock(streamer_context.mtx_);
+        return std::make_unique<Eodhd>(Eodhd::Host{quote_host_name_}, Eodhd::Port{quote_host_port_},
+                                       Eodhd::APIKey{quotes_api_key_}, Eodhd::Prefix{});
+    }
+    return std::make_unique<Tiingo>(Tiingo::Host{quote_host_name_}, Tiingo::Port{quote_host_port_},
+                                    Tiingo::APIKey{quotes_api_key_}, Tiingo::Prefix{tiingo_prefix});
+}
 
-            streamer_context.cv_.wait(lock, [&streamer_context] {
-                return !streamer_context.streamed_data_.empty() || streamer_context.done_;
-            });
+decimal::Decimal PF_StreamerApp::ComputeATRForChart(RemoteDataSource &history_getter, const std::string &symbol) const
+{
+    std::chrono::year_month_day today{--floor<std::chrono::days>(std::chrono::system_clock::now())};
+    auto holidays = MakeHolidayList(today.year());
+    rng::copy(MakeHolidayList(--(today.year())), std::back_inserter(holidays));
 
-            if (streamer_context.done_ && streamer_context.streamed_data_.empty())
-            {
-                std::println("Consumer/Producer: Work complete.");
-                break;
-            }
+    const auto history = history_getter.GetMostRecentTickerData(symbol, today, number_of_days_history_for_ATR_ + 1,
+                                                                UseAdjusted::e_Yes, &holidays);
 
-            if (streamer_context.streamed_data_.empty())
-            {
-                continue;
-            }
-            new_data = std::move(streamer_context.streamed_data_.front());
-            streamer_context.streamed_data_.pop();
-        }
+    return ComputeATR(symbol, history, number_of_days_history_for_ATR_);
+}
 
-        try
-        {
-            const RemoteDataSource::PF_Data extracted_data = PF_streamer_->ExtractStreamedData(new_data);
-            if (extracted_data.ticker_.empty())
+std::map<std::string, decimal::Decimal> PF_StreamerApp::ComputeATRForSymbols(
+    const std::vector<std::string> &symbols) const
+{
+    // symbols we can't get an ATR for are logged and left out.
+
+    std::vector<std::optional<decimal::Decimal>> atrs(symbols.size());
+
+    const auto started = std::chrono::steady_clock::now();
+    FetchInParallel(
+        symbols.size(), fetch_concurrency_, [this]() { return MakeQuoteSource(""); },
+        [&](RemoteDataSource &history_getter, std::size_t ndx) {
+            try
             {
-                continue;
+                atrs[ndx] = ComputeATRForChart(history_getter, symbols[ndx]);
             }
-            auto &processor_ctx = processor_contexts[symbol_to_context_map.at(extracted_data.ticker_)];
-
+            catch (const std::exception &e)
             {
-                std::lock_guard<std::mutex> lock(processor_ctx.mtx_);
-                processor_ctx.extracted_data_.emplace(extracted_data);
+                spdlog::error(std::format("Unable to compute ATR for: '{}' because: {}.", symbols[ndx], e.what()));
             }
+        });
 
-            processor_ctx.cv_.notify_one();
-        }
-        catch (const std::exception &e)
+    std::map<std::string, decimal::Decimal> result;
+    for (const auto &[symbol, atr] : vws::zip(symbols, atrs))
+    {
+        if (atr)
         {
-            spdlog::error("Error parsing websocket data: {}\n{}", new_data, e.what());
+            result.emplace(symbol, *atr);
         }
     }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - started;
+    spdlog::info(std::format("Computed ATR for {} of {} symbols in {:.2f} seconds.", result.size(), symbols.size(),
+                             elapsed.count()));
+    return result;
 }
 
-void PF_StreamerApp::ProcessUpdatesForSymbol(RemoteDataSource::ProcessorContext &processor_context)
+fs::path PF_StreamerApp::TickJournalPath() const
 {
-    std::exception_ptr ep = nullptr;
+    // 1 journal per trading day. Keep a replayed session from clobbering the real one.
 
-    while (true)
+    if (simulated_clock_)
     {
-        RemoteDataSource::PF_Data pf_data;
-        {
-            std::unique_lock<std::mutex> lock(processor_context.mtx_);
-
-            processor_context.cv_.wait(lock, [&processor_context] {
-                return !processor_context.extracted_data_.empty() || processor_context.done_;
-            });
-
-            if (processor_context.done_ && processor_context.extracted_data_.empty())
-            {
-                std::println("Consumer: Work complete.");
-                break;
-            }
-
-            if (processor_context.extracted_data_.empty())
-            {
-                continue;
-            }
-            pf_data = std::move(processor_context.extracted_data_.front());
-            processor_context.extracted_data_.pop();
-        }
-
-        try
-        {
-            Do_ProcessUpdatesForSymbol(pf_data);
-        }
-        catch (std::system_error &e)
-        {
-            spdlog::error(e.what());
-            auto ec = e.code();
-            spdlog::error("Category: {}. Value: {}. Message: {}.", ec.category().name(), ec.value(), ec.message());
-
-            if (!ep)
-            {
-                ep = std::current_exception();
-            }
-            continue;
-        }
-        catch (std::exception &e)
-        {
-            spdlog::error(e.what());
+        return output_chart_directory_ / "PF_Streamer_ticks_simulated.journal";
+    }
+    const std::chrono::year_month_day today{
+        floor<std::chrono::days>(std::chrono::current_zone()->to_local(std::chrono::system_clock::now()))};
+    return output_chart_directory_ / std::format("PF_Streamer_ticks_{:%F}.journal", today);
+}
 
-            if (!ep)
-            {
-                ep = std::current_exception();
-            }
-            continue;
-        }
-        catch (...)
-        {
-            spdlog::error("Unknown problem with an async download process");
+void PF_StreamerApp::OpenTickJournal(TickJournal::OpenMode mode)
+{
+    if (no_tick_journal_)
+    {
+        return;
+    }
+    try
+    {
+        tick_journal_ = std::make_unique<TickJournal>(TickJournalPath(), symbol_list_,
+                                                      std::chrono::milliseconds{tick_journal_commit_ms_}, mode);
+    }
+    catch (const std::exception &e)
+    {
+        // streaming is more important than being able to recover from a crash.
 
-            if (!ep)
-            {
-                ep = std::current_exception();
-            }
-            continue;
-        }
+        spdlog::error(std::format("Unable to start tick journal: {}. Continuing without it.", e.what()));
     }
-    if (ep)
+}
+
+void PF_StreamerApp::JournalValue(TickJournal::RecordType type, const std::string &symbol,
+                                  TickJournal::TmPt time_stamp, const decimal::Decimal &price)
+{
+    if (tick_journal_)
     {
-        std::rethrow_exception(ep);
+        JournalValue(type, symbol_ids_.at(symbol), time_stamp, price);
     }
 }
 
-void PF_StreamerApp::Do_ProcessUpdatesForSymbol(const RemoteDataSource::PF_Data &update)
+void PF_StreamerApp::JournalValue(TickJournal::RecordType type, int32_t symbol_id, TickJournal::TmPt time_stamp,
+                                  const decimal::Decimal &price)
 {
-    if (update.last_price_ == -1 || update.last_size_ == 1)
+    // a journal problem must never cost the charts a value. The journal marks itself
+    // incomplete and ignores anything more so this is only logged once.
+
+    try
     {
-        return;
+        tick_journal_->Append(type, symbol_id, time_stamp, price);
+    }
+    catch (const std::exception &e)
+    {
+        spdlog::error(std::format("Problem with tick journal: {}. --resume will use the JSON files instead.",
+                                  e.what()));
     }
+}
 
-    std::vector<PF_Chart *> need_to_update_graph;
-    PF_SignalType new_signal{PF_SignalType::e_unknown};
+PF_StreamerApp::TickJournalContents PF_StreamerApp::ScanTickJournal(const fs::path &journal_path)
+{
+    TickJournalContents result;
+    TickJournal::Replay(journal_path, [&result](const TickJournal::Record &record) {
+        result.complete_ = result.complete_ && record.type_ != TickJournal::RecordType::e_incomplete;
+        result.from_snapshot_ = result.from_snapshot_ || record.type_ == TickJournal::RecordType::e_snapshot;
+    });
+    return result;
+}
 
-    rng::for_each(
-        charts_ |
-            vws::filter([&update](const auto &symbol_and_chart) { return symbol_and_chart.first == update.ticker_; }),
-        [this, &need_to_update_graph, &update, &new_signal](auto &symbol_and_chart) {
-            try
-            {
-                auto chart_changed = symbol_and_chart.second.AddValue(
-                    update.last_price_, PF_Column::TmPt{update.time_stamp_nanoseconds_utc_});
-                if (chart_changed != PF_Column::Status::e_Ignored)
-                {
-                    need_to_update_graph.push_back(&symbol_and_chart.second);
-                    if (chart_changed == PF_Column::Status::e_AcceptedWithSignal)
-                    {
-                        new_signal = symbol_and_chart.second.GetMostRecentSignal().value().signal_type_;
-                    }
-                }
-            }
-            catch (std::exception &e)
-            {
-                spdlog::error(std::format("Problem adding streamed value to chart for symbol: {} because: {}.",
-                                          update.ticker_, e.what()));
-            }
-        });
+fs::path PF_StreamerApp::TickJournalSnapshotPath() const
+{
+    // a directory next to the journal it belongs to.
 
-    CollectStreamedData(update, new_signal);
+    auto result = TickJournalPath();
+    result.replace_extension("snapshot");
+    return result;
+}
 
-    rng::sort(need_to_update_graph);
-    const auto [first, last] = rng::unique(need_to_update_graph);
-    need_to_update_graph.erase(first, last);
+void PF_StreamerApp::StartTickJournalFromSnapshot()
+{
+    // the journal only has prices in it. It can't hold the charts we just loaded so save a
+    // copy of them (and the streamed prices and summary) for it to start from. The JSON files
+    // we loaded them from get rewritten as we go so they won't do.
 
-    auto now = std::chrono::system_clock::now();
-    for (const PF_Chart *chart : need_to_update_graph)
+    if (no_tick_journal_)
+    {
+        return;
+    }
+    const auto snapshot_path = TickJournalSnapshotPath();
+    auto temp_path = snapshot_path;
+    temp_path += ".tmp";
+    try
     {
-        auto last_drawn = last_draw_times_.at(chart->GetSymbol());
-        if (now < last_drawn + minimum_delay_)
+        fs::remove_all(temp_path);
+        fs::create_directories(temp_path);
+        for (const auto &[symbol, chart] : charts_)
         {
-            continue;
+            if (!chart.empty())
+            {
+                chart.ConvertChartToJsonAndWriteToFile(temp_path / chart.MakeChartFileName("", "json"));
+            }
         }
-        try
-        {
-            fs::path graph_file_path = output_graphs_directory_ / (chart->MakeChartFileName("", "svg"));
-            ConstructCDPFChartGraphicAndWriteToFile(*chart, graph_file_path, streamed_prices_[chart->GetSymbol()],
-                                                    trend_lines_, X_AxisFormat::e_show_time);
+        SaveStreamedPricesToFiles(temp_path);
+        SaveStreamedSummaryToFile(temp_path);
 
-            fs::path chart_file_path = output_chart_directory_ / (chart->MakeChartFileName("", "json"));
-            chart->ConvertChartToJsonAndWriteToFile(chart_file_path);
-            last_draw_times_.at(chart->GetSymbol()) = now;
-        }
-        catch (std::exception &e)
-        {
-            spdlog::error(std::string("Problem creating graphic for updated streamed value: ") +
-                          chart->GetChartBaseName() + " " + e.what());
-        }
+        // all or nothing.
+
+        fs::remove_all(snapshot_path);
+        fs::rename(temp_path, snapshot_path);
+    }
+    catch (const std::exception &e)
+    {
+        spdlog::error(std::format("Unable to save snapshot for tick journal: {}. Continuing without it.", e.what()));
+        return;
     }
 
-    if (now > last_summary_draw_time_ + minimum_delay_)
+    OpenTickJournal(TickJournal::OpenMode::e_truncate);
+    if (tick_journal_)
     {
-        fs::path summary_graphic_path = output_graphs_directory_ / "PF_StreamingSummary.svg";
-        ConstructCDSummaryGraphic(streamed_summary_, summary_graphic_path);
-        last_summary_draw_time_ = now;
+        // must be on disk before any ticks are or a resume would start from nothing.
+
+        JournalValue(TickJournal::RecordType::e_snapshot, 0,
+                     std::chrono::clock_cast<std::chrono::utc_clock>(std::chrono::system_clock::now()),
+                     decimal::Decimal{0});
+        tick_journal_->Commit();
     }
 }
 
-void PF_StreamerApp::CollectStreamedData(const RemoteDataSource::PF_Data &update, PF_SignalType new_signal)
+void PF_StreamerApp::ReplayTickJournal(const fs::path &journal_path)
 {
-    const auto new_time_stamp =
-        std::chrono::duration_cast<std::chrono::seconds>(update.time_stamp_nanoseconds_utc_.time_since_epoch()).count();
-    if (!streamed_prices_[update.ticker_].timestamp_seconds_.empty())
-    {
-        if (new_time_stamp > streamed_prices_[update.ticker_].timestamp_seconds_.back())
-        {
-            streamed_prices_[update.ticker_].timestamp_seconds_.push_back(new_time_stamp);
-            streamed_prices_[update.ticker_].price_.push_back(dec2dbl(update.last_price_));
-            streamed_prices_[update.ticker_].signal_type_.push_back(std::to_underlying(new_signal));
-        }
-        else
+    // journal symbol indexes -> our symbol IDs. Each session which wrote to the
+    // journal defined its own so they can change part way through.
+
+    std::vector<int32_t> journal_symbol_ids;
+    int64_t skipped{0};
+
+    const auto started = std::chrono::steady_clock::now();
+
+    const auto how_many = TickJournal::Replay(journal_path, [&](const TickJournal::Record &record) {
+        if (record.type_ == TickJournal::RecordType::e_symbol)
         {
-            streamed_prices_[update.ticker_].price_.back() = dec2dbl(update.last_price_);
-            if (new_signal != PF_SignalType::e_unknown)
+            if (record.symbol_id_ >= std::ssize(journal_symbol_ids))
             {
-                streamed_prices_[update.ticker_].signal_type_.back() = std::to_underlying(new_signal);
+                journal_symbol_ids.resize(record.symbol_id_ + 1, -1);
             }
+            const auto which_symbol = symbol_ids_.find(std::string{record.Ticker()});
+            journal_symbol_ids[record.symbol_id_] = which_symbol == symbol_ids_.end() ? -1 : which_symbol->second;
+            return;
         }
-    }
-    else
-    {
-        streamed_prices_[update.ticker_].timestamp_seconds_.push_back(new_time_stamp);
-        streamed_prices_[update.ticker_].price_.push_back(dec2dbl(update.last_price_));
-        streamed_prices_[update.ticker_].signal_type_.push_back(std::to_underlying(new_signal));
-    }
 
-    streamed_summary_[update.ticker_].latest_price_ = dec2dbl(update.last_price_);
-}
+        const auto price = record.Price();
+        if (record.symbol_id_ < 0 || record.symbol_id_ >= std::ssize(journal_symbol_ids) ||
+            journal_symbol_ids[record.symbol_id_] < 0 || !price)
+        {
+            ++skipped;
+            return;
+        }
+        const auto symbol_id = journal_symbol_ids[record.symbol_id_];
 
-decimal::Decimal PF_StreamerApp::ComputeATRForChart(const std::string &symbol) const
-{
-    std::unique_ptr<RemoteDataSource> history_getter;
-    if (quote_data_source_ == QuoteDataSource::e_Eodhd)
-    {
-        history_getter = std::make_unique<Eodhd>(Eodhd::Host{quote_host_name_}, Eodhd::Port{quote_host_port_},
-                                                 Eodhd::APIKey{quotes_api_key_}, Eodhd::Prefix{});
-    }
-    else
-    {
-        history_getter = std::make_unique<Tiingo>(Tiingo::Host{quote_host_name_}, Tiingo::Port{quote_host_port_},
-                                                  Tiingo::APIKey{quotes_api_key_}, Tiingo::Prefix{});
-    }
+        switch (record.type_)
+        {
+            case TickJournal::RecordType::e_tick:
+            {
+                RemoteDataSource::PF_Data update;
+                update.ticker_ = symbol_list_[symbol_id];
+                update.time_stamp_nanoseconds_utc_ = record.TimeStamp();
+                update.last_price_ = *price;
+                update.symbol_id_ = symbol_id;
+                Do_ProcessUpdatesForSymbol(update, nullptr);
+                break;
+            }
+            case TickJournal::RecordType::e_chart_value:
+            {
+                const auto [first, last] = symbol_chart_ranges_[symbol_id];
+                for (auto ndx = first; ndx < last; ++ndx)
+                {
+                    try
+                    {
+                        charts_[ndx].second.AddValue(*price, PF_Column::TmPt{record.TimeStamp()});
+                    }
+                    catch (const std::exception &e)
+                    {
+                        spdlog::error(std::format("Problem replaying journaled value for symbol: {} because: {}",
+                                                  symbol_list_[symbol_id], e.what()));
+                    }
+                }
+                break;
+            }
+            case TickJournal::RecordType::e_opening_price:
+                tick_histories_[symbol_id].SetOpeningPrice(dec2dbl(*price));
+                break;
 
-    std::chrono::year_month_day today{--floor<std::chrono::days>(std::chrono::system_clock::now())};
-    auto holidays = MakeHolidayList(today.year());
-    rng::copy(MakeHolidayList(--(today.year())), std::back_inserter(holidays));
+            case TickJournal::RecordType::e_latest_price:
+                tick_histories_[symbol_id].SetLatestPrice(dec2dbl(*price));
+                break;
 
-    const auto history = history_getter->GetMostRecentTickerData(symbol, today, number_of_days_history_for_ATR_ + 1,
-                                                                 UseAdjusted::e_Yes, &holidays);
+            case TickJournal::RecordType::e_snapshot:
+                break; // loaded before replay started
 
-    return ComputeATR(symbol, history, number_of_days_history_for_ATR_);
+            default:
+                ++skipped;
+                break;
+        }
+    });
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - started;
+    spdlog::info(std::format("Replayed {} tick journal records ({} skipped) from: {} in {:.3f} seconds.", how_many,
+                             skipped, journal_path.string(), elapsed.count()));
 }
 
-void PF_StreamerApp::LoadChartsFromFiles()
+void PF_StreamerApp::LoadChartsFromFiles(const fs::path &directory)
 {
     auto params = vws::cartesian_product(symbol_list_, box_size_list_, reversal_boxes_list_, scale_list_);
 
+    // new charts need an ATR. Fetch those up front, all at once.
+
+    std::map<std::string, decimal::Decimal> atrs;
+    if (use_ATR_)
+    {
+        std::vector<std::string> need_atr;
+        for (const auto &val : params)
+        {
+            const auto &symbol = std::get<PF_Chart::e_symbol>(val);
+            if ((need_atr.empty() || need_atr.back() != symbol) &&
+                !fs::exists(directory / MakeChartNameFromParams(val, "", "json")))
+            {
+                need_atr.push_back(symbol);
+            }
+        }
+        atrs = ComputeATRForSymbols(need_atr);
+    }
+
     for (const auto &val : params)
     {
         const auto &symbol = std::get<PF_Chart::e_symbol>(val);
-        fs::path chart_file_path = output_chart_directory_ / MakeChartNameFromParams(val, "", "json");
+        fs::path chart_file_path = directory / MakeChartNameFromParams(val, "", "json");
 
         try
         {
@@ -902,7 +2000,11 @@ void PF_StreamerApp::LoadChartsFromFiles()
             }
             else
             {
-                decimal::Decimal atr = use_ATR_ ? ComputeATRForChart(symbol) : 0;
+                if (use_ATR_ && !atrs.contains(symbol))
+                {
+                    throw std::runtime_error(std::format("No ATR for new chart for: {}", symbol));
+                }
+                decimal::Decimal atr = use_ATR_ ? atrs.at(symbol) : 0;
                 PF_Chart new_chart = use_ATR_
                                          ? PF_Chart{atr, val, max_columns_for_graph_ < 1 ? -1 : max_columns_for_graph_}
                                          : PF_Chart{val, atr, max_columns_for_graph_ < 1 ? -1 : max_columns_for_graph_};
@@ -919,11 +2021,11 @@ void PF_StreamerApp::LoadChartsFromFiles()
     }
 }
 
-void PF_StreamerApp::LoadStreamedPricesFromFiles()
+void PF_StreamerApp::LoadStreamedPricesFromFiles(const fs::path &directory)
 {
     for (const auto &symbol : symbol_list_)
     {
-        fs::path prices_file = output_chart_directory_ / (symbol + "_streamed_prices.json");
+        fs::path prices_file = directory / (symbol + "_streamed_prices.json");
 
         if (fs::exists(prices_file))
         {
@@ -960,7 +2062,7 @@ void PF_StreamerApp::LoadStreamedPricesFromFiles()
                     }
                 }
 
-                streamed_prices_[symbol] = prices;
+                tick_histories_[symbol_ids_.at(symbol)].Load(prices);
                 spdlog::info("Loaded streamed prices for {} from {}", symbol, prices_file.string());
             }
             catch (const Json::Exception &e)
@@ -973,14 +2075,13 @@ void PF_StreamerApp::LoadStreamedPricesFromFiles()
         else
         {
             spdlog::info("No streamed prices file for {}, starting fresh", symbol);
-            streamed_prices_[symbol] = {};
         }
     }
 }
 
-void PF_StreamerApp::LoadStreamedSummaryFromFile()
+void PF_StreamerApp::LoadStreamedSummaryFromFile(const fs::path &directory)
 {
-    fs::path summary_file = output_chart_directory_ / "streamed_summary.json";
+    fs::path summary_file = directory / "streamed_summary.json";
 
     if (fs::exists(summary_file))
     {
@@ -997,11 +2098,10 @@ void PF_StreamerApp::LoadStreamedSummaryFromFile()
                 if (summary_data.isMember(symbol_key))
                 {
                     const auto &symbol_data = summary_data[symbol_key];
-                    StreamedSummary summary;
-                    summary.opening_price_ = symbol_data["opening_price"].asDouble();
-                    summary.latest_price_ = symbol_data["latest_price"].asDouble();
-                    summary.curent_signal_type_ = symbol_data["curent_signal_type"].asInt();
-                    streamed_summary_[symbol] = summary;
+                    auto &history = tick_histories_[symbol_ids_.at(symbol)];
+                    history.SetOpeningPrice(symbol_data["opening_price"].asDouble());
+                    history.SetLatestPrice(symbol_data["latest_price"].asDouble());
+                    history.SetSignalType(symbol_data["curent_signal_type"].asInt());
                 }
             }
             spdlog::info("Loaded streamed summary from {}", summary_file.string());
@@ -1015,23 +2115,20 @@ void PF_StreamerApp::LoadStreamedSummaryFromFile()
     else
     {
         spdlog::info("No summary file found, starting fresh");
-        for (const auto &symbol : symbol_list_)
-        {
-            streamed_summary_[symbol] = {};
-        }
     }
 }
 
-void PF_StreamerApp::SaveStreamedPricesToFiles()
+void PF_StreamerApp::SaveStreamedPricesToFiles(const fs::path &directory)
 {
-    for (const auto &[symbol, prices] : streamed_prices_)
+    for (const auto &[symbol, id] : symbol_ids_)
     {
+        const auto prices = tick_histories_[id].Snapshot();
         if (prices.timestamp_seconds_.empty())
         {
             continue;
         }
 
-        fs::path prices_file = output_chart_directory_ / (symbol + "_streamed_prices.json");
+        fs::path prices_file = directory / (symbol + "_streamed_prices.json");
         std::ofstream out(prices_file);
 
         Json::Value root;
@@ -1055,16 +2152,16 @@ void PF_StreamerApp::SaveStreamedPricesToFiles()
         out << root << std::endl;
         out.close();
     }
-    spdlog::info("Saved streamed prices to {}", output_chart_directory_.string());
+    spdlog::info("Saved streamed prices to {}", directory.string());
 }
 
-void PF_StreamerApp::SaveStreamedSummaryToFile()
+void PF_StreamerApp::SaveStreamedSummaryToFile(const fs::path &directory)
 {
-    fs::path summary_file = output_chart_directory_ / "streamed_summary.json";
+    fs::path summary_file = directory / "streamed_summary.json";
     std::ofstream out(summary_file);
 
     Json::Value root;
-    for (const auto &[symbol, summary] : streamed_summary_)
+    for (const auto &[symbol, summary] : MakeStreamedSummary())
     {
         std::string symbol_key = symbol;
         root[symbol_key]["opening_price"] = summary.opening_price_;
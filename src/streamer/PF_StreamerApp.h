@@ -1,15 +1,32 @@
 #ifndef PF_STREAMERAPP_INC
 #define PF_STREAMERAPP_INC
 
+#include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <span>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 using namespace std::chrono_literals;
 
+#include "ConstructChartGraphic.h"
 #include "PF_Chart.h"
 #include "Streamer.h"
+#include "common/BreadthTracker.h"
 #include "common/PF_AppBase.h"
+#include "streamer/LatencyHistogram.h"
+#include "streamer/RenderScheduler.h"
+#include "streamer/SignalBus.h"
+#include "streamer/StreamedTickHistory.h"
+#include "streamer/TickJournal.h"
 #include "utilities.h"
 
 class PF_StreamerApp : public PF_AppBase
@@ -35,37 +52,183 @@ protected:
 
 private:
     void Run_Streaming();
+    void BuildChartsForStreaming();
     void PrimeChartsForStreaming();
+    void IndexChartsBySymbol();
     void CollectStreamingData();
     void CollectStreamedData(const RemoteDataSource::PF_Data &update, PF_SignalType new_signal);
-    void StreamedDataParser(RemoteDataSource::StreamerContext &streamer_context,
-                            std::vector<RemoteDataSource::ProcessorContext> &processor_contexts,
-                            std::map<std::string, int> &symbol_to_context_map);
-    void ProcessUpdatesForSymbol(RemoteDataSource::ProcessorContext &processor_context);
-    void Do_ProcessUpdatesForSymbol(const RemoteDataSource::PF_Data &update);
+    [[nodiscard]] std::unique_ptr<RemoteDataSource> MakeStreamingSource() const;
+    [[nodiscard]] std::size_t ShardForSymbol(int32_t symbol_id) const;
+    void StreamedDataParser(RemoteDataSource &streamer, int32_t connection,
+                            RemoteDataSource::StreamerContext &streamer_context,
+                            std::deque<RemoteDataSource::ProcessorContext> &processor_contexts);
+    struct ShardLatency;
+    void ProcessUpdatesForShard(RemoteDataSource::ProcessorContext &processor_context, ShardLatency &latency);
+    void Do_ProcessUpdatesForSymbol(const RemoteDataSource::PF_Data &update, ShardLatency *latency);
+    void Do_ProcessConflatedUpdatesForSymbol(std::span<const RemoteDataSource::PF_Data> updates,
+                                             ShardLatency *latency);
+    void RenderStreamedUpdate(std::size_t which);
+    [[nodiscard]] PF_StreamedSummary MakeStreamedSummary() const;
 
-    [[nodiscard]] decimal::Decimal ComputeATRForChart(const std::string &symbol) const;
+    // benchmarking against pf_replay
+    void RecordFrames(const std::vector<RemoteDataSource::StreamedFrame> &frames);
+    void WaitForSimulatedMarketClose();
+    void ReportStageStats() const;
+
+    // latency and queue depths, while streaming and when done
+    void RecordLatency(const RemoteDataSource::PF_Data &update, int64_t updated_ns, int64_t signal_ns,
+                       ShardLatency &latency) const;
+    void ReportLatencyPeriodically(const std::deque<RemoteDataSource::StreamerContext> &streamer_contexts,
+                                   const std::deque<RemoteDataSource::ProcessorContext> &processor_contexts) const;
+    void ReportLatency(const std::deque<RemoteDataSource::StreamerContext> &streamer_contexts,
+                       const std::deque<RemoteDataSource::ProcessorContext> &processor_contexts) const;
+
+    // bullish percent and percent in X columns over the session
+    void RecordBreadthPeriodically() const;
+    void RecordBreadth() const;
+
+    // REST requests for quotes and history. Tiingo's top of book needs the '/iex' prefix, its history doesn't.
+    [[nodiscard]] std::unique_ptr<RemoteDataSource> MakeQuoteSource(const std::string &tiingo_prefix) const;
+    [[nodiscard]] decimal::Decimal ComputeATRForChart(RemoteDataSource &history_getter,
+                                                      const std::string &symbol) const;
+    [[nodiscard]] std::map<std::string, decimal::Decimal> ComputeATRForSymbols(
+        const std::vector<std::string> &symbols) const;
 
     // Resume functionality
-    void LoadChartsFromFiles();
-    void LoadStreamedPricesFromFiles();
-    void LoadStreamedSummaryFromFile();
-    void SaveStreamedPricesToFiles();
-    void SaveStreamedSummaryToFile();
+    [[nodiscard]] fs::path TickJournalPath() const;
+    void OpenTickJournal(TickJournal::OpenMode mode);
+    void JournalValue(TickJournal::RecordType type, const std::string &symbol, TickJournal::TmPt time_stamp,
+                      const decimal::Decimal &price);
+    void JournalValue(TickJournal::RecordType type, int32_t symbol_id, TickJournal::TmPt time_stamp,
+                      const decimal::Decimal &price);
+
+    // what --resume needs to know about a journal before replaying it.
+
+    struct TickJournalContents
+    {
+        bool complete_ = true;       // no e_incomplete record
+        bool from_snapshot_ = false; // session started from TickJournalSnapshotPath(), not from scratch
+    };
 
-    PF_StreamedPrices streamed_prices_;
-    PF_StreamedSummary streamed_summary_;
+    [[nodiscard]] static TickJournalContents ScanTickJournal(const fs::path &journal_path);
+    [[nodiscard]] fs::path TickJournalSnapshotPath() const;
+    void StartTickJournalFromSnapshot();
+    void ReplayTickJournal(const fs::path &journal_path);
+    void LoadChartsFromFiles(const fs::path &directory);
+    void LoadStreamedPricesFromFiles(const fs::path &directory);
+    void LoadStreamedSummaryFromFile(const fs::path &directory);
+    void SaveStreamedPricesToFiles(const fs::path &directory);
+    void SaveStreamedSummaryToFile(const fs::path &directory);
 
     PF_Charts charts_;
 
-    std::chrono::time_point<std::chrono::system_clock> last_summary_draw_time_;
-    std::map<std::string, std::chrono::time_point<std::chrono::system_clock>> last_draw_times_;
-    const std::chrono::seconds minimum_delay_ = 2s;
+    // a symbol's ID is its position in symbol_list_. charts_ is kept grouped by symbol
+    // so all charts for a symbol are the range [first, second) in charts_.
+
+    std::unordered_map<std::string, int32_t> symbol_ids_;
+    std::vector<std::pair<std::size_t, std::size_t>> symbol_chart_ranges_;
+
+    // streamed prices and summary data, also by symbol ID.
+
+    std::vector<StreamedTickHistory> tick_histories_;
+
+    // a symbol's charts are only touched while holding its lock.
+    // Processors hold it while applying a tick, the renderer while copying a chart.
+
+    std::vector<std::mutex> symbol_locks_;
+
+    // render jobs are chart indexes. The summary graphic is 1 past the last chart.
+
+    std::unique_ptr<RenderScheduler> render_scheduler_;
+
+    // what the last drawing of each chart was made from so the next one only redoes the
+    // columns which changed. Only used by the render thread drawing that chart. The
+    // scheduler never draws the same chart on 2 threads at once.
+
+    std::vector<PF_ChartRenderData> render_data_;
+
+    // every accepted tick (and the values charts were primed with) for crash recovery.
+
+    std::unique_ptr<TickJournal> tick_journal_;
+
+    // new signals go here for other programs on this machine while streaming.
+
+    std::unique_ptr<SignalBus> signal_bus_;
+
+    // breadth of all the streamed charts, moved along by each chart change. Like the
+    // render scheduler, not there while replaying the tick journal.
+
+    std::unique_ptr<BreadthTracker> breadth_tracker_;
+
+    // counts and timings for each pipeline stage, reported when streaming ends.
+    // Updated once per batch (once per drawing for the renderer) so they cost next to nothing.
+
+    struct StageStats
+    {
+        using Clock = std::chrono::steady_clock;
+
+        std::atomic<int64_t> messages_ = 0;
+        std::atomic<int64_t> busy_ns_ = 0;
+        std::atomic<int64_t> first_ns_ = 0;
+        std::atomic<int64_t> last_ns_ = 0;
+
+        void Record(std::size_t how_many, Clock::time_point started, Clock::time_point finished)
+        {
+            const auto started_ns = started.time_since_epoch().count();
+            const auto finished_ns = finished.time_since_epoch().count();
+            messages_.fetch_add(static_cast<int64_t>(how_many), std::memory_order_relaxed);
+            busy_ns_.fetch_add(finished_ns - started_ns, std::memory_order_relaxed);
+
+            auto first = first_ns_.load(std::memory_order_relaxed);
+            while ((first == 0 || started_ns < first) &&
+                   !first_ns_.compare_exchange_weak(first, started_ns, std::memory_order_relaxed))
+            {
+            }
+            auto last = last_ns_.load(std::memory_order_relaxed);
+            while (finished_ns > last && !last_ns_.compare_exchange_weak(last, finished_ns, std::memory_order_relaxed))
+            {
+            }
+        }
+    };
+
+    StageStats parser_stats_;
+    StageStats processor_stats_;
+    StageStats render_stats_;
+
+    // per tick latency (nanoseconds) for each pipeline stage. Times are WallClockNanoseconds().
+    // Each shard records its own so no 2 threads ever write the same histogram.
+    // Queue depths are recorded once per batch by the consumer.
+
+    struct ShardLatency
+    {
+        LatencyHistogram feed_lag_;      // feed time stamp -> read from socket
+        LatencyHistogram parse_;         // read from socket -> parsed (includes wait to be parsed)
+        LatencyHistogram update_;        // parsed -> charts updated (includes wait for the shard)
+        LatencyHistogram end_to_end_;    // read from socket -> charts updated
+        LatencyHistogram signal_;        // read from socket -> signal recorded. Ticks with a signal only.
+        LatencyHistogram queue_depth_;   // ticks waiting for this shard
+    };
+
+    std::deque<ShardLatency> shard_latencies_;
+    std::deque<LatencyHistogram> connection_queue_depths_; // frames waiting for each connection's parser
+
+    // chart updates skipped by conflation.
+
+    std::atomic<int64_t> conflated_updates_ = 0;
+
+    // raw frames as received, for pf_replay to play back later.
+
+    std::mutex frame_recording_mtx_;
+    std::ofstream frame_recording_;
+
+    // with a simulated clock 'now' is the time of the newest tick seen (utc nanoseconds).
 
-    std::unique_ptr<RemoteDataSource> PF_streamer_;
+    std::atomic<int64_t> simulated_now_ns_ = 0;
 
     fs::path output_chart_directory_;
     fs::path output_graphs_directory_;
+    fs::path record_frames_path_;
+    std::string signal_bus_name_;
 
     std::string streaming_host_name_;
     fs::path streaming_host_api_key_;
@@ -101,12 +264,14 @@ private:
     std::string quotes_api_key_;
     std::string streaming_api_key_;
     std::string graphics_format_i_;
+    std::string renderer_i_;
     std::vector<std::string> scale_i_list_;
     std::vector<std::string> box_size_i_list_;
 
     StreamingSource streaming_data_source_ = StreamingSource::e_unknown;
     QuoteDataSource quote_data_source_ = QuoteDataSource::e_unknown;
     GraphicsFormat graphics_format_ = GraphicsFormat::e_unknown;
+    GraphicsRenderer renderer_ = GraphicsRenderer::e_chartdirector;
 
     std::vector<std::string> symbol_list_;
     std::vector<BoxScale> scale_list_;
@@ -118,9 +283,24 @@ private:
 
     int32_t max_columns_for_graph_ = -1;
     int32_t number_of_days_history_for_ATR_ = 0;
+    int32_t ring_buffer_size_ = 0;
+    int32_t spin_count_ = 0;
+    int32_t processor_threads_ = 0;
+    int32_t streaming_connections_ = 0;
+    int32_t fetch_concurrency_ = 0;
+    int32_t connection_count_ = 1;
+    int32_t shards_per_connection_ = 1;
+    int32_t render_interval_ms_ = 0;
+    int32_t render_threads_ = 0;
+    int32_t conflate_backlog_ = 0;
+    int32_t latency_report_seconds_ = 0;
+    int32_t breadth_seconds_ = 0;
+    int32_t tick_journal_commit_ms_ = 0;
     bool use_ATR_ = false;
     bool use_min_max_ = false;
     bool resume_mode_ = false;
+    bool no_tick_journal_ = false;
+    bool simulated_clock_ = false;
 
     // Options accepted but ignored (for CLI compatibility with tests)
     std::string new_data_source_i_;
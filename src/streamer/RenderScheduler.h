@@ -0,0 +1,198 @@
+#ifndef PF_RENDERSCHEDULER_INC
+#define PF_RENDERSCHEDULER_INC
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <format>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+// moves drawing off the tick processing threads.
+// Processors just say 'this thing changed'. Changes to the same thing are coalesced
+// so each thing is drawn at most once per interval and the last change is always
+// drawn (no dropped trailing update). Drawing happens on the scheduler's own threads.
+// Things are identified by a small integer (the streamer uses chart index) fixed at
+// construction.
+//
+// MarkDirty is lock free unless it is the first change since the thing was last
+// scheduled so a busy symbol costs about 1 atomic op per tick.
+
+class RenderScheduler
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    using RenderFunction = std::function<void(std::size_t)>;
+
+    RenderScheduler(std::size_t how_many, std::chrono::milliseconds interval, int32_t thread_count,
+                    RenderFunction render)
+        : interval_{interval}, render_{std::move(render)}, states_(how_many), last_render_(how_many)
+    {
+        for (int32_t i = 0; i < std::max(1, thread_count); ++i)
+        {
+            workers_.emplace_back(&RenderScheduler::Work, this);
+        }
+    }
+
+    RenderScheduler() = delete;
+    RenderScheduler(const RenderScheduler &) = delete;
+    RenderScheduler(RenderScheduler &&) = delete;
+    ~RenderScheduler() { Stop(); }
+
+    RenderScheduler &operator=(const RenderScheduler &) = delete;
+    RenderScheduler &operator=(RenderScheduler &&) = delete;
+
+    void MarkDirty(std::size_t which)
+    {
+        auto &state = states_[which];
+        auto current = state.load(std::memory_order_acquire);
+        while (true)
+        {
+            switch (current)
+            {
+                case State::e_pending:
+                case State::e_rendering_dirty:
+                    return;
+
+                case State::e_rendering:
+                    if (state.compare_exchange_weak(current, State::e_rendering_dirty, std::memory_order_acq_rel))
+                    {
+                        return;
+                    }
+                    break;
+
+                case State::e_idle:
+                    if (state.compare_exchange_weak(current, State::e_pending, std::memory_order_acq_rel))
+                    {
+                        std::lock_guard<std::mutex> lock(mtx_);
+                        Schedule(which, std::max(Clock::now(), last_render_[which] + interval_));
+                        return;
+                    }
+                    break;
+            }
+        }
+    }
+
+    // pending work is dropped. Call before doing a final draw of everything.
+
+    void Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            if (stopping_)
+            {
+                return;
+            }
+            stopping_ = true;
+        }
+        work_available_.notify_all();
+        for (auto &worker : workers_)
+        {
+            worker.join();
+        }
+    }
+
+private:
+    enum class State : int32_t
+    {
+        e_idle,
+        e_pending,
+        e_rendering,
+        e_rendering_dirty
+    };
+
+    using Job = std::pair<Clock::time_point, std::size_t>;
+
+    // caller holds mtx_
+
+    void Schedule(std::size_t which, Clock::time_point when)
+    {
+        const bool new_earliest = jobs_.empty() || when < jobs_.top().first;
+        jobs_.emplace(when, which);
+        if (new_earliest)
+        {
+            work_available_.notify_one();
+        }
+    }
+
+    void Work()
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        while (!stopping_)
+        {
+            if (jobs_.empty())
+            {
+                work_available_.wait(lock);
+                continue;
+            }
+            const auto [when, which] = jobs_.top();
+            if (Clock::now() < when)
+            {
+                work_available_.wait_until(lock, when);
+                continue;
+            }
+            jobs_.pop();
+
+            // somebody else may have been waiting on a later job.
+
+            if (!jobs_.empty())
+            {
+                work_available_.notify_one();
+            }
+            states_[which].store(State::e_rendering, std::memory_order_release);
+            const auto started = Clock::now();
+            lock.unlock();
+
+            try
+            {
+                render_(which);
+            }
+            catch (const std::exception &e)
+            {
+                spdlog::error(std::format("Problem rendering streamed update: {}", e.what()));
+            }
+            catch (...)
+            {
+                spdlog::error("Unknown problem rendering streamed update.");
+            }
+
+            lock.lock();
+            last_render_[which] = started;
+            auto expected = State::e_rendering;
+            if (!states_[which].compare_exchange_strong(expected, State::e_idle, std::memory_order_acq_rel))
+            {
+                // changed while we were drawing. Draw again when its interval is up.
+
+                states_[which].store(State::e_pending, std::memory_order_release);
+                Schedule(which, started + interval_);
+            }
+        }
+    }
+
+    const std::chrono::milliseconds interval_;
+    RenderFunction render_;
+
+    std::vector<std::atomic<State>> states_;
+
+    // guarded by mtx_
+
+    std::mutex mtx_;
+    std::condition_variable work_available_;
+    std::priority_queue<Job, std::vector<Job>, std::greater<>> jobs_;
+    std::vector<Clock::time_point> last_render_;
+    bool stopping_ = false;
+
+    std::vector<std::thread> workers_;
+};
+
+#endif
@@ -0,0 +1,342 @@
+#include "streamer/SignalBus.h"
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <format>
+#include <new>
+#include <ranges>
+#include <stdexcept>
+#include <utility>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "PF_Chart.h"
+#include "PF_Signals.h"
+
+namespace rng = std::ranges;
+
+namespace
+{
+constexpr std::array<char, 8> kBusMagic{'P', 'F', 'S', 'I', 'G', 'N', 'A', 'L'};
+constexpr uint32_t kBusVersion = 1;
+
+constexpr std::size_t kEventWords = sizeof(SignalEvent) / sizeof(uint64_t);
+using EventWords = std::array<uint64_t, kEventWords>;
+
+std::size_t MappingSize(uint64_t capacity)
+{
+    return sizeof(SignalBus::Header) + capacity * sizeof(SignalBus::Slot);
+}
+
+bool HeaderIsValid(const SignalBus::Header &header)
+{
+    return header.magic_ == kBusMagic && header.version_ == kBusVersion &&
+           header.slot_size_ == sizeof(SignalBus::Slot) && header.capacity_ > 0 &&
+           std::has_single_bit(header.capacity_);
+}
+
+// shared (not private) futex. The waiters are in other processes.
+
+void FutexWait(std::atomic<uint32_t> &word, uint32_t seen, std::chrono::nanoseconds timeout)
+{
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+    timespec wait_for{.tv_sec = seconds.count(), .tv_nsec = (timeout - seconds).count()};
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT, seen, &wait_for, nullptr, 0);
+}
+
+void FutexWakeAll(std::atomic<uint32_t> &word)
+{
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+// too long just gets cut off. Nothing we publish should come close.
+
+void CopyText(std::string_view text, std::array<char, 16> &destination)
+{
+    rng::copy(text.substr(0, destination.size()), destination.begin());
+}
+} // namespace
+
+std::string_view SignalEvent::Text(const std::array<char, 16> &text)
+{
+    return {text.data(), static_cast<std::size_t>(rng::find(text, '\0') - text.begin())};
+}
+
+// =====================================================================================
+//        Class:  SignalBus
+// =====================================================================================
+
+SignalBus::SignalBus(const std::string &name, uint64_t capacity) : name_{name}
+{
+    capacity = std::bit_ceil(std::max<uint64_t>(capacity, 2));
+    mapping_size_ = MappingSize(capacity);
+
+    // keep a ring left by an earlier run (same layout) so its subscribers carry on. Any
+    // other ring is unlinked, never resized or cleared in place: its subscribers still
+    // have it mapped and would fault past its new end or read a cleared header. They keep
+    // the old ring, which gets nothing new, until they open the name again.
+
+    if (const int fd = ::shm_open(name_.c_str(), O_RDWR | O_CLOEXEC, 0); fd >= 0)
+    {
+        struct stat file_info{};
+        ::fstat(fd, &file_info);
+        if (static_cast<std::size_t>(file_info.st_size) == mapping_size_)
+        {
+            mapping_ = ::mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            mapping_ = mapping_ == MAP_FAILED ? nullptr : mapping_;
+        }
+        ::close(fd);
+
+        header_ = static_cast<Header *>(mapping_);
+        if (header_ != nullptr && HeaderIsValid(*header_) && header_->capacity_ == capacity)
+        {
+            slots_ = reinterpret_cast<Slot *>(static_cast<char *>(mapping_) + sizeof(Header));
+            mask_ = capacity - 1;
+            return;
+        }
+        if (mapping_ != nullptr)
+        {
+            ::munmap(mapping_, mapping_size_);
+            mapping_ = nullptr;
+        }
+        ::shm_unlink(name_.c_str());
+    }
+
+    // O_EXCL: if somebody else made one since, there is another publisher.
+
+    const int fd = ::shm_open(name_.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        throw std::runtime_error(std::format("Unable to create signal bus: {}: {}", name_, std::strerror(errno)));
+    }
+    if (::ftruncate(fd, static_cast<off_t>(mapping_size_)) != 0)
+    {
+        const auto problem = std::strerror(errno);
+        ::close(fd);
+        ::shm_unlink(name_.c_str());
+        throw std::runtime_error(std::format("Unable to size signal bus: {}: {}", name_, problem));
+    }
+
+    mapping_ = ::mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping_ == MAP_FAILED)
+    {
+        mapping_ = nullptr;
+        throw std::runtime_error(std::format("Unable to map signal bus: {}: {}", name_, std::strerror(errno)));
+    }
+
+    // fresh (zero filled) memory nobody else has mapped yet. Subscribers check the header
+    // so fill it in before the magic anyway.
+
+    header_ = new (mapping_) Header{};
+    header_->version_ = kBusVersion;
+    header_->slot_size_ = sizeof(Slot);
+    header_->capacity_ = capacity;
+    std::atomic_thread_fence(std::memory_order_release);
+    header_->magic_ = kBusMagic;
+
+    slots_ = reinterpret_cast<Slot *>(static_cast<char *>(mapping_) + sizeof(Header));
+    mask_ = capacity - 1;
+}
+
+SignalBus::~SignalBus()
+{
+    // the shared memory stays (see above). Remove it with 'rm /dev/shm/<name>'.
+
+    if (mapping_ != nullptr)
+    {
+        ::munmap(mapping_, mapping_size_);
+    }
+}
+
+void SignalBus::Publish(const PF_Chart &chart, const PF_Signal &signal)
+{
+    SignalEvent event{
+        .signal_time_ns_ =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(signal.tpt_.time_since_epoch()).count(),
+        .signal_type_ = std::to_underlying(signal.signal_type_),
+        .signal_category_ = std::to_underlying(signal.signal_category_),
+        .priority_ = std::to_underlying(signal.priority_),
+        .reversal_boxes_ = chart.GetReversalboxes(),
+        .box_scale_ = std::to_underlying(chart.GetBoxScale()),
+        .column_number_ = signal.column_number_};
+
+    CopyText(chart.GetSymbol(), event.symbol_);
+    CopyText(chart.GetFNameBoxSize().format("f"), event.box_size_);
+    CopyText(signal.signal_price_.format("f"), event.signal_price_);
+    CopyText(signal.box_.format("f"), event.box_);
+
+    Publish(event);
+}
+
+void SignalBus::Publish(const SignalEvent &event)
+{
+    // signals are rare so a lock to keep to 1 writer at a time costs nothing.
+
+    std::lock_guard<std::mutex> lock(publish_mtx_);
+
+    auto to_publish = event;
+    to_publish.published_ns_ =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    const auto words = std::bit_cast<EventWords>(to_publish);
+
+    const auto event_number = header_->published_.load(std::memory_order_relaxed);
+    auto &slot = slots_[event_number & mask_];
+
+    slot.sequence_.store(2 * event_number + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (std::size_t ndx = 0; ndx < kEventWords; ++ndx)
+    {
+        std::atomic_ref<uint64_t>{slot.event_[ndx]}.store(words[ndx], std::memory_order_relaxed);
+    }
+    slot.sequence_.store(2 * event_number + 2, std::memory_order_release);
+
+    // pairs with the subscriber's checks in Next(): either it sees this event before
+    // it sleeps or we see it is (about to be) sleeping.
+
+    header_->published_.store(event_number + 1, std::memory_order_seq_cst);
+    header_->wake_count_.fetch_add(1, std::memory_order_seq_cst);
+    if (header_->sleepers_.load(std::memory_order_seq_cst) > 0)
+    {
+        FutexWakeAll(header_->wake_count_);
+    }
+}
+
+uint64_t SignalBus::Published() const
+{
+    return header_->published_.load(std::memory_order_acquire);
+}
+
+// =====================================================================================
+//        Class:  SignalSubscriber
+// =====================================================================================
+
+SignalSubscriber::SignalSubscriber(const std::string &name, StartAt start_at)
+{
+    const int fd = ::shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        throw std::runtime_error(std::format("Unable to open signal bus: {}: {}", name, std::strerror(errno)));
+    }
+
+    struct stat file_info{};
+    ::fstat(fd, &file_info);
+    mapping_size_ = static_cast<std::size_t>(file_info.st_size);
+    if (mapping_size_ < sizeof(SignalBus::Header))
+    {
+        ::close(fd);
+        throw std::runtime_error(std::format("Not a usable signal bus: {}", name));
+    }
+
+    // we only write the sleeper count but that needs write access too.
+
+    mapping_ = ::mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping_ == MAP_FAILED)
+    {
+        mapping_ = nullptr;
+        throw std::runtime_error(std::format("Unable to map signal bus: {}: {}", name, std::strerror(errno)));
+    }
+
+    header_ = static_cast<SignalBus::Header *>(mapping_);
+    if (!HeaderIsValid(*header_) || MappingSize(header_->capacity_) != mapping_size_)
+    {
+        ::munmap(mapping_, mapping_size_);
+        mapping_ = nullptr;
+        throw std::runtime_error(std::format("Not a usable signal bus: {}", name));
+    }
+    slots_ = reinterpret_cast<SignalBus::Slot *>(static_cast<char *>(mapping_) + sizeof(SignalBus::Header));
+    mask_ = header_->capacity_ - 1;
+
+    const auto published = header_->published_.load(std::memory_order_acquire);
+    if (start_at == StartAt::e_next)
+    {
+        next_event_ = published;
+    }
+    else
+    {
+        next_event_ = published > header_->capacity_ ? published - header_->capacity_ : 0;
+    }
+}
+
+SignalSubscriber::~SignalSubscriber()
+{
+    if (mapping_ != nullptr)
+    {
+        ::munmap(mapping_, mapping_size_);
+    }
+}
+
+std::optional<SignalEvent> SignalSubscriber::TryNext()
+{
+    while (true)
+    {
+        const auto published = header_->published_.load(std::memory_order_acquire);
+        if (next_event_ >= published)
+        {
+            return {};
+        }
+        if (published - next_event_ > header_->capacity_)
+        {
+            missed_ += published - header_->capacity_ - next_event_;
+            next_event_ = published - header_->capacity_;
+        }
+
+        auto &slot = slots_[next_event_ & mask_];
+        const auto expected = 2 * next_event_ + 2;
+        if (slot.sequence_.load(std::memory_order_acquire) == expected)
+        {
+            EventWords words;
+            for (std::size_t ndx = 0; ndx < kEventWords; ++ndx)
+            {
+                words[ndx] = std::atomic_ref<uint64_t>{slot.event_[ndx]}.load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence_.load(std::memory_order_relaxed) == expected)
+            {
+                ++next_event_;
+                return std::bit_cast<SignalEvent>(words);
+            }
+        }
+
+        // the publisher has lapped us and is writing (or has written) a later event
+        // into this slot. It's gone.
+
+        ++missed_;
+        ++next_event_;
+    }
+}
+
+std::optional<SignalEvent> SignalSubscriber::Next(std::chrono::milliseconds timeout)
+{
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (true)
+    {
+        if (auto event = TryNext(); event)
+        {
+            return event;
+        }
+        const auto remaining = deadline - std::chrono::steady_clock::now();
+        if (remaining <= std::chrono::nanoseconds{0})
+        {
+            return {};
+        }
+
+        const auto seen = header_->wake_count_.load(std::memory_order_seq_cst);
+        header_->sleepers_.fetch_add(1, std::memory_order_seq_cst);
+        if (header_->published_.load(std::memory_order_seq_cst) == next_event_)
+        {
+            FutexWait(header_->wake_count_, seen, remaining);
+        }
+        header_->sleepers_.fetch_sub(1, std::memory_order_seq_cst);
+    }
+}
@@ -0,0 +1,175 @@
+#ifndef PF_SIGNALBUS_INC
+#define PF_SIGNALBUS_INC
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+
+class PF_Chart;
+struct PF_Signal;
+
+// =====================================================================================
+//        Class:  SignalBus
+//  Description:  publishes new signals to other processes on this machine through a
+//                broadcast ring in POSIX shared memory (/dev/shm/<name>).
+//
+//  There is 1 publisher (the streamer) and any number of subscribers. Only 1 process may
+//  publish on a bus: Publish() serializes threads within the process but nothing keeps
+//  2 processes from writing the same slot. Subscribers don't write anything but a count
+//  of who is asleep so they can come and go as they like and each goes at its own pace.
+//  The publisher never waits for anybody: when a subscriber falls more than a ring's
+//  worth behind it finds out (Missed()) and picks up with the oldest event still
+//  available.
+//
+//  Each slot has a sequence number which is odd while the slot is being written and
+//  2 * (event number + 1) once it's done (a seqlock). A subscriber copies the event
+//  and then checks the sequence number did not change while it was copying.
+//
+//  Subscribers can spin on TryNext() for the lowest latency or sleep in Next() and be
+//  woken by a futex when something is published.
+//
+//  The ring is left in place when the streamer stops so subscribers can finish
+//  reading. A restarted streamer picks up where the last one left off if it asks for
+//  the same capacity. Otherwise it unlinks the old ring and makes a new one; subscribers
+//  still reading the old one must open the bus again to see new events.
+// =====================================================================================
+
+// compact and fixed size. Text is NUL padded, not terminated. Values are what goes in
+// the chart's file names so a subscriber can find the chart if it wants more.
+
+struct SignalEvent
+{
+    int64_t signal_time_ns_ = 0; // time of the tick which made the signal. utc_clock nanoseconds.
+    int64_t published_ns_ = 0;   // system_clock nanoseconds when we published it.
+    int32_t signal_type_ = 0;    // PF_SignalType
+    int32_t signal_category_ = 0;
+    int32_t priority_ = 0;
+    int32_t reversal_boxes_ = 0;
+    int32_t box_scale_ = 0; // BoxScale
+    int32_t column_number_ = 0;
+    std::array<char, 16> symbol_{};
+    std::array<char, 16> box_size_{};
+    std::array<char, 16> signal_price_{};
+    std::array<char, 16> box_{};
+    std::array<char, 8> unused_{};
+
+    [[nodiscard]] static std::string_view Text(const std::array<char, 16> &text);
+};
+static_assert(sizeof(SignalEvent) == 112);
+
+class SignalBus
+{
+public:
+    static constexpr uint64_t kDefaultCapacity = 4096;
+
+    // ====================  LIFECYCLE     =======================================
+
+    // 'name' is a shared memory name: '/pf_signals'. capacity is rounded up to a power of 2.
+
+    SignalBus(const std::string &name, uint64_t capacity = kDefaultCapacity);
+
+    SignalBus() = delete;
+    SignalBus(const SignalBus &) = delete;
+    SignalBus(SignalBus &&) = delete;
+    ~SignalBus();
+
+    SignalBus &operator=(const SignalBus &) = delete;
+    SignalBus &operator=(SignalBus &&) = delete;
+
+    // ====================  MUTATORS      =======================================
+
+    // any thread. Never waits on a subscriber.
+
+    void Publish(const PF_Chart &chart, const PF_Signal &signal);
+    void Publish(const SignalEvent &event);
+
+    // ====================  ACCESSORS     =======================================
+
+    [[nodiscard]] uint64_t Published() const;
+
+    // the shared memory layout. Also used by SignalSubscriber.
+
+    struct Slot
+    {
+        std::atomic<uint64_t> sequence_;
+        std::array<uint64_t, sizeof(SignalEvent) / sizeof(uint64_t)> event_; // only touched through atomic_ref
+        uint64_t unused_;
+    };
+    static_assert(sizeof(Slot) == 128);
+
+    struct Header
+    {
+        std::array<char, 8> magic_;
+        uint32_t version_;
+        uint32_t slot_size_;
+        uint64_t capacity_;
+        alignas(64) std::atomic<uint64_t> published_;  // events published so far (next event number)
+        alignas(64) std::atomic<uint32_t> wake_count_; // futex word. Bumped on every publish.
+        std::atomic<uint32_t> sleepers_;               // subscribers waiting on the futex
+    };
+
+private:
+    const std::string name_;
+    std::mutex publish_mtx_;
+    void *mapping_ = nullptr;
+    std::size_t mapping_size_ = 0;
+    Header *header_ = nullptr;
+    Slot *slots_ = nullptr;
+    uint64_t mask_ = 0;
+};
+
+// =====================================================================================
+//        Class:  SignalSubscriber
+//  Description:  reads events from a SignalBus in another process (or this one).
+// =====================================================================================
+
+class SignalSubscriber
+{
+public:
+    enum class StartAt : int32_t
+    {
+        e_next,  // only events published from now on
+        e_oldest // everything still in the ring
+    };
+
+    // the bus must already exist.
+
+    explicit SignalSubscriber(const std::string &name, StartAt start_at = StartAt::e_next);
+
+    SignalSubscriber() = delete;
+    SignalSubscriber(const SignalSubscriber &) = delete;
+    SignalSubscriber(SignalSubscriber &&) = delete;
+    ~SignalSubscriber();
+
+    SignalSubscriber &operator=(const SignalSubscriber &) = delete;
+    SignalSubscriber &operator=(SignalSubscriber &&) = delete;
+
+    // next event if there is one. Never blocks.
+
+    std::optional<SignalEvent> TryNext();
+
+    // next event, sleeping up to 'timeout' for one to be published.
+
+    std::optional<SignalEvent> Next(std::chrono::milliseconds timeout);
+
+    // events which were overwritten before we got to them.
+
+    [[nodiscard]] uint64_t Missed() const { return missed_; }
+
+private:
+    void *mapping_ = nullptr;
+    std::size_t mapping_size_ = 0;
+    SignalBus::Header *header_ = nullptr;
+    SignalBus::Slot *slots_ = nullptr;
+    uint64_t mask_ = 0;
+    uint64_t next_event_ = 0;
+    uint64_t missed_ = 0;
+};
+
+#endif
@@ -0,0 +1,154 @@
+#ifndef PF_STREAMEDTICKHISTORY_INC
+#define PF_STREAMEDTICKHISTORY_INC
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+#include <spdlog/spdlog.h>
+
+#include "utilities.h"
+
+// the streamed price history (1 entry per second) and summary data for 1 symbol.
+//
+// Exactly 1 thread writes (the shard that owns the symbol). Any thread can take a
+// snapshot at any time without locking. Entries are stored by column in fixed size
+// chunks which are never moved or freed while streaming so a reader can copy
+// everything up to the published size while the writer keeps appending. The only
+// entry ever changed after it is published is the last one (more ticks in the same
+// second) so price and signal are atomics. Their loads/stores are plain moves on x86.
+
+class StreamedTickHistory
+{
+public:
+    static constexpr std::size_t kChunkSize = 1024;
+    static constexpr std::size_t kMaxChunks = 128; // > 36 hours of seconds
+
+    StreamedTickHistory() { chunks_[0] = std::make_unique<Chunk>(); }
+
+    StreamedTickHistory(const StreamedTickHistory &) = delete;
+    StreamedTickHistory(StreamedTickHistory &&) = delete;
+    ~StreamedTickHistory() = default;
+
+    StreamedTickHistory &operator=(const StreamedTickHistory &) = delete;
+    StreamedTickHistory &operator=(StreamedTickHistory &&) = delete;
+
+    // ====================  WRITER SIDE  =======================================
+
+    void Append(int64_t timestamp_seconds, double price, int32_t signal_type)
+    {
+        const auto ndx = size_.load(std::memory_order_relaxed);
+        if (ndx == kChunkSize * kMaxChunks)
+        {
+            // don't expect this in a trading day. Keep the latest price at least.
+
+            spdlog::error("Streamed price history is full. Updating last entry instead.");
+            UpdateLast(price, signal_type);
+            return;
+        }
+        auto &chunk = chunks_[ndx / kChunkSize];
+        if (!chunk)
+        {
+            chunk = std::make_unique<Chunk>();
+        }
+        const auto slot = ndx % kChunkSize;
+        chunk->timestamp_seconds_[slot] = timestamp_seconds;
+        chunk->price_[slot].store(price, std::memory_order_relaxed);
+        chunk->signal_type_[slot].store(signal_type, std::memory_order_relaxed);
+        size_.store(ndx + 1, std::memory_order_release);
+    }
+
+    // only valid if !empty()
+
+    void UpdateLast(double price, std::optional<int32_t> signal_type)
+    {
+        const auto ndx = size_.load(std::memory_order_relaxed) - 1;
+        auto &chunk = *chunks_[ndx / kChunkSize];
+        chunk.price_[ndx % kChunkSize].store(price, std::memory_order_relaxed);
+        if (signal_type)
+        {
+            chunk.signal_type_[ndx % kChunkSize].store(*signal_type, std::memory_order_relaxed);
+        }
+    }
+
+    [[nodiscard]] int64_t LastTimestamp() const
+    {
+        const auto ndx = size_.load(std::memory_order_relaxed) - 1;
+        return chunks_[ndx / kChunkSize]->timestamp_seconds_[ndx % kChunkSize];
+    }
+
+    // for resume. Only before streaming starts.
+
+    void Load(const StreamedPrices &prices)
+    {
+        const auto how_many =
+            std::min({prices.timestamp_seconds_.size(), prices.price_.size(), prices.signal_type_.size()});
+        for (std::size_t i = 0; i < how_many; ++i)
+        {
+            Append(prices.timestamp_seconds_[i], prices.price_[i], prices.signal_type_[i]);
+        }
+    }
+
+    void SetOpeningPrice(double price) { opening_price_.store(price, std::memory_order_relaxed); }
+    void SetLatestPrice(double price) { latest_price_.store(price, std::memory_order_relaxed); }
+    void SetSignalType(int32_t signal_type) { signal_type_.store(signal_type, std::memory_order_relaxed); }
+
+    // ====================  READER SIDE  =======================================
+
+    [[nodiscard]] std::size_t size() const { return size_.load(std::memory_order_acquire); }
+    [[nodiscard]] bool empty() const { return size() == 0; }
+
+    [[nodiscard]] StreamedPrices Snapshot() const
+    {
+        const auto how_many = size_.load(std::memory_order_acquire);
+
+        StreamedPrices result;
+        result.timestamp_seconds_.reserve(how_many);
+        result.price_.reserve(how_many);
+        result.signal_type_.reserve(how_many);
+
+        for (std::size_t first = 0; first < how_many; first += kChunkSize)
+        {
+            const auto &chunk = *chunks_[first / kChunkSize];
+            const auto in_chunk = std::min(kChunkSize, how_many - first);
+            result.timestamp_seconds_.insert(result.timestamp_seconds_.end(), chunk.timestamp_seconds_.begin(),
+                                             chunk.timestamp_seconds_.begin() + in_chunk);
+            for (std::size_t slot = 0; slot < in_chunk; ++slot)
+            {
+                result.price_.push_back(chunk.price_[slot].load(std::memory_order_relaxed));
+                result.signal_type_.push_back(chunk.signal_type_[slot].load(std::memory_order_relaxed));
+            }
+        }
+        return result;
+    }
+
+    [[nodiscard]] StreamedSummary SummarySnapshot() const
+    {
+        StreamedSummary result;
+        result.opening_price_ = opening_price_.load(std::memory_order_relaxed);
+        result.latest_price_ = latest_price_.load(std::memory_order_relaxed);
+        result.curent_signal_type_ = signal_type_.load(std::memory_order_relaxed);
+        return result;
+    }
+
+private:
+    struct Chunk
+    {
+        std::array<int64_t, kChunkSize> timestamp_seconds_{};
+        std::array<std::atomic<double>, kChunkSize> price_{};
+        std::array<std::atomic<int32_t>, kChunkSize> signal_type_{};
+    };
+
+    std::array<std::unique_ptr<Chunk>, kMaxChunks> chunks_;
+    std::atomic<std::size_t> size_ = 0;
+
+    std::atomic<double> opening_price_ = 0.0;
+    std::atomic<double> latest_price_ = 0.0;
+    std::atomic<int32_t> signal_type_ = 0;
+};
+
+#endif
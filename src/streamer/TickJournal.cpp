@@ -0,0 +1,277 @@
+#include "streamer/TickJournal.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <ranges>
+#include <stdexcept>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <spdlog/spdlog.h>
+
+namespace rng = std::ranges;
+
+namespace
+{
+struct JournalHeader
+{
+    std::array<char, 8> magic_{};
+    uint32_t version_ = 0;
+    uint32_t record_size_ = 0;
+    std::array<char, 16> unused_{};
+};
+static_assert(sizeof(JournalHeader) == 32);
+
+constexpr std::array<char, 8> kJournalMagic{'P', 'F', 'T', 'I', 'C', 'K', 'S', '\0'};
+constexpr uint32_t kJournalVersion = 2; // 1 kept prices as 16 characters of text
+
+bool WriteAll(int fd, const void *data, std::size_t length)
+{
+    const auto *next = static_cast<const char *>(data);
+    while (length > 0)
+    {
+        const auto written = ::write(fd, next, length);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        next += written;
+        length -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+bool HeaderIsValid(const JournalHeader &header)
+{
+    return header.magic_ == kJournalMagic && header.version_ == kJournalVersion &&
+           header.record_size_ == sizeof(TickJournal::Record);
+}
+} // namespace
+
+std::string_view TickJournal::Record::Ticker() const
+{
+    return {ticker_.data(), static_cast<std::size_t>(rng::find(ticker_, '\0') - ticker_.begin())};
+}
+
+std::optional<decimal::Decimal> TickJournal::Record::Price() const
+{
+    if (type_ == RecordType::e_symbol || type_ == RecordType::e_unknown)
+    {
+        return {};
+    }
+    return decimal::Decimal{price_coefficient_}.scaleb(decimal::Decimal{price_exponent_});
+}
+
+TickJournal::TickJournal(const fs::path &journal_path, const std::vector<std::string> &symbols,
+                         std::chrono::milliseconds commit_interval, OpenMode mode)
+    : journal_path_{journal_path}, commit_interval_{commit_interval}
+{
+    const int flags = O_RDWR | O_CREAT | O_CLOEXEC | (mode == OpenMode::e_truncate ? O_TRUNC : 0);
+    fd_ = ::open(journal_path_.c_str(), flags, 0644);
+    if (fd_ < 0)
+    {
+        throw std::runtime_error(
+            std::format("Unable to open tick journal: {}: {}", journal_path_.string(), std::strerror(errno)));
+    }
+
+    struct stat file_info{};
+    ::fstat(fd_, &file_info);
+    auto file_size = static_cast<std::size_t>(file_info.st_size);
+
+    if (file_size >= sizeof(JournalHeader))
+    {
+        JournalHeader header;
+        if (::pread(fd_, &header, sizeof(header), 0) != sizeof(header) || !HeaderIsValid(header))
+        {
+            ::close(fd_);
+            throw std::runtime_error(
+                std::format("Not a usable tick journal: {}. Version {} journals only.", journal_path_.string(),
+                            kJournalVersion));
+        }
+
+        // a crash can leave part of a record at the end. Drop it so we stay aligned.
+
+        const auto whole_records = (file_size - sizeof(JournalHeader)) / sizeof(Record);
+        const auto good_size = sizeof(JournalHeader) + whole_records * sizeof(Record);
+        if (good_size != file_size)
+        {
+            spdlog::info(std::format("Trimming partial record from end of tick journal: {}", journal_path_.string()));
+            if (::ftruncate(fd_, static_cast<off_t>(good_size)) != 0)
+            {
+                spdlog::error(std::format("Unable to trim tick journal: {}", std::strerror(errno)));
+            }
+        }
+        ::lseek(fd_, 0, SEEK_END);
+    }
+    else
+    {
+        JournalHeader header{.magic_ = kJournalMagic, .version_ = kJournalVersion, .record_size_ = sizeof(Record)};
+        if (::ftruncate(fd_, 0) != 0 || !WriteAll(fd_, &header, sizeof(header)))
+        {
+            ::close(fd_);
+            throw std::runtime_error(
+                std::format("Unable to write tick journal header: {}: {}", journal_path_.string(), std::strerror(errno)));
+        }
+    }
+
+    // (re)define the symbol indexes used by everything we append from here on.
+
+    for (int32_t symbol_id = 0; const auto &symbol : symbols)
+    {
+        Record record{.symbol_id_ = symbol_id++, .type_ = RecordType::e_symbol};
+        if (symbol.size() > record.ticker_.size())
+        {
+            ::close(fd_);
+            throw std::runtime_error(
+                std::format("Symbol: {} too long for tick journal. Its ticks could not be replayed.", symbol));
+        }
+        rng::copy(symbol, record.ticker_.begin());
+        AppendRecord(record);
+    }
+    Commit();
+
+    committer_ = std::thread(&TickJournal::CommitLoop, this);
+}
+
+TickJournal::~TickJournal()
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        stopping_ = true;
+    }
+    wake_committer_.notify_all();
+    if (committer_.joinable())
+    {
+        committer_.join();
+    }
+    Commit();
+    ::close(fd_);
+}
+
+void TickJournal::Append(RecordType type, int32_t symbol_id, TmPt time_stamp, const decimal::Decimal &price)
+{
+    if (incomplete_.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    Record record{.time_stamp_nanoseconds_ = time_stamp.time_since_epoch().count(),
+                  .symbol_id_ = symbol_id,
+                  .type_ = type};
+
+    // scaleb only moves the exponent so the coefficient has the price's own digits unless
+    // there are more than the context keeps, which the check back catches. i64() throws if
+    // there are more than fit.
+
+    try
+    {
+        if (!price.isfinite())
+        {
+            throw std::invalid_argument("not a finite number");
+        }
+        const auto exponent = price.exponent();
+        record.price_coefficient_ = price.scaleb(decimal::Decimal{-exponent}).i64();
+        record.price_exponent_ = static_cast<int32_t>(exponent);
+        if (record.Price() != price)
+        {
+            throw std::invalid_argument("too many digits");
+        }
+    }
+    catch (const std::exception &e)
+    {
+        MarkIncomplete(record.time_stamp_nanoseconds_);
+        throw std::runtime_error(std::format("Price: {} can't be stored in tick journal: {}. Journal stopped.",
+                                             price.format("f"), e.what()));
+    }
+    AppendRecord(record);
+}
+
+void TickJournal::MarkIncomplete(int64_t time_stamp_nanoseconds)
+{
+    if (!incomplete_.exchange(true))
+    {
+        AppendRecord(Record{.time_stamp_nanoseconds_ = time_stamp_nanoseconds, .type_ = RecordType::e_incomplete});
+    }
+}
+
+void TickJournal::AppendRecord(const Record &record)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    pending_.push_back(record);
+}
+
+void TickJournal::Commit()
+{
+    std::lock_guard<std::mutex> io_lock(io_mtx_);
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        writing_.swap(pending_);
+    }
+    if (writing_.empty() || write_failed_)
+    {
+        writing_.clear();
+        return;
+    }
+    if (!WriteAll(fd_, writing_.data(), writing_.size() * sizeof(Record)) || ::fdatasync(fd_) != 0)
+    {
+        // anything written after this would follow a gap. Stop here so what is on disk is
+        // still a whole prefix of the session.
+
+        spdlog::error(std::format("Problem writing tick journal: {}: {}. Journal stopped. {} records may be lost.",
+                                  journal_path_.string(), std::strerror(errno), writing_.size()));
+        write_failed_ = true;
+        incomplete_ = true;
+    }
+    writing_.clear();
+}
+
+void TickJournal::CommitLoop()
+{
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            if (wake_committer_.wait_for(lock, commit_interval_, [this] { return stopping_; }))
+            {
+                return;
+            }
+        }
+        Commit();
+    }
+}
+
+int64_t TickJournal::Replay(const fs::path &journal_path, const std::function<void(const Record &)> &apply)
+{
+    // read it all in 1 go. Even a long, busy session is only a few 10s of MB.
+
+    std::ifstream journal{journal_path, std::ios::in | std::ios::binary};
+    if (!journal)
+    {
+        throw std::runtime_error(std::format("Unable to open tick journal: {}", journal_path.string()));
+    }
+
+    JournalHeader header;
+    if (!journal.read(reinterpret_cast<char *>(&header), sizeof(header)) || !HeaderIsValid(header))
+    {
+        throw std::runtime_error(std::format("Not a usable tick journal: {}. Version {} journals only.",
+                                             journal_path.string(), kJournalVersion));
+    }
+
+    const auto data_size = fs::file_size(journal_path) - sizeof(JournalHeader);
+    std::vector<Record> records(data_size / sizeof(Record));
+    journal.read(reinterpret_cast<char *>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(Record)));
+    records.resize(static_cast<std::size_t>(journal.gcount()) / sizeof(Record));
+
+    rng::for_each(records, apply);
+    return static_cast<int64_t>(records.size());
+}
@@ -0,0 +1,141 @@
+#ifndef PF_TICKJOURNAL_INC
+#define PF_TICKJOURNAL_INC
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <decimal.hh>
+
+namespace fs = std::filesystem;
+
+// =====================================================================================
+//        Class:  TickJournal
+//  Description:  append only binary log of everything needed to rebuild a streaming
+//                session: the values charts were primed with and every accepted tick.
+//
+//  The file is a small header followed by fixed size records. Symbols are written as
+//  records too (index -> ticker) so a restarted session can keep appending with a
+//  different symbol list without rewriting anything.
+//
+//  Appends just go into memory. A committer thread writes and fdatasync()s whatever has
+//  accumulated every 'commit interval' so many ticks share 1 disk flush (group commit).
+//  A crash can lose at most the last interval. A torn record at the end of the file is
+//  ignored on replay and trimmed before appending again.
+//
+//  A journal with a gap in it would rebuild the wrong charts. So a tick which can't be
+//  stored leaves an e_incomplete record and nothing more is appended. A failed write
+//  stops all writing so the file is a whole prefix of the session, as after a crash.
+// =====================================================================================
+
+class TickJournal
+{
+public:
+    using TmPt = std::chrono::utc_time<std::chrono::nanoseconds>;
+
+    enum class RecordType : int16_t
+    {
+        e_unknown,
+        e_symbol,        // symbol_id_ is the index used by later records, ticker_ is the ticker
+        e_tick,          // streamed trade. Goes to charts and streamed prices.
+        e_chart_value,   // priming value. Goes to charts only.
+        e_opening_price, // summary opening price
+        e_latest_price,  // summary latest price
+        e_incomplete,    // something after this was not stored. Don't rebuild from this journal.
+        e_snapshot       // session started from a saved snapshot of charts and prices, not from scratch.
+    };
+
+    enum class OpenMode : int32_t
+    {
+        e_truncate,
+        e_append
+    };
+
+    struct Record
+    {
+        int64_t time_stamp_nanoseconds_ = 0;
+        int32_t symbol_id_ = -1;
+        RecordType type_ = RecordType::e_unknown;
+        int16_t unused_ = 0;
+        std::array<char, 16> ticker_{}; // NUL padded, not terminated.
+
+        // price is coefficient x 10^exponent so it is exact, trailing zeros and all, and
+        // any price a tick can carry fits.
+
+        int64_t price_coefficient_ = 0;
+        int32_t price_exponent_ = 0;
+        int32_t unused2_ = 0;
+
+        [[nodiscard]] std::string_view Ticker() const;
+        [[nodiscard]] TmPt TimeStamp() const { return TmPt{std::chrono::nanoseconds{time_stamp_nanoseconds_}}; }
+        [[nodiscard]] std::optional<decimal::Decimal> Price() const; // empty for symbol records
+    };
+    static_assert(sizeof(Record) == 48);
+
+    // ====================  LIFECYCLE     =======================================
+
+    TickJournal(const fs::path &journal_path, const std::vector<std::string> &symbols,
+                std::chrono::milliseconds commit_interval, OpenMode mode);
+
+    TickJournal() = delete;
+    TickJournal(const TickJournal &) = delete;
+    TickJournal(TickJournal &&) = delete;
+    ~TickJournal();
+
+    TickJournal &operator=(const TickJournal &) = delete;
+    TickJournal &operator=(TickJournal &&) = delete;
+
+    // ====================  MUTATORS      =======================================
+
+    // any thread. symbol_id is the position of the symbol in the list given to the constructor.
+    // Throws std::runtime_error if the price can't be stored (not finite or too many digits).
+    // The journal is then marked incomplete and later appends are ignored.
+
+    void Append(RecordType type, int32_t symbol_id, TmPt time_stamp, const decimal::Decimal &price);
+
+    // write and flush everything appended so far. Blocks until it is on disk.
+
+    void Commit();
+
+    // ====================  OPERATIONS    =======================================
+
+    // calls 'apply' for every complete record in order. Returns number of records.
+
+    static int64_t Replay(const fs::path &journal_path, const std::function<void(const Record &)> &apply);
+
+private:
+    void AppendRecord(const Record &record);
+    void CommitLoop();
+    void MarkIncomplete(int64_t time_stamp_nanoseconds);
+
+    fs::path journal_path_;
+
+    // serializes write + flush so batches reach the file in the order they were taken.
+
+    std::mutex io_mtx_;
+    int fd_ = -1;
+    std::vector<Record> writing_;
+    bool write_failed_ = false;
+
+    std::mutex mtx_;
+    std::condition_variable wake_committer_;
+    std::vector<Record> pending_;
+    bool stopping_ = false;
+
+    std::atomic<bool> incomplete_{false};
+
+    const std::chrono::milliseconds commit_interval_;
+    std::thread committer_;
+};
+
+#endif
@@ -1,6 +1,7 @@
 #include "updater/PF_UpdaterApp.h"
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <format>
 #include <fstream>
@@ -8,6 +9,7 @@
 #include <ranges>
 #include <sstream>
 #include <string_view>
+#include <thread>
 
 namespace rng = std::ranges;
 namespace vws = std::ranges::views;
@@ -19,6 +21,9 @@ namespace vws = std::ranges::views;
 #include "PF_Chart.h"
 #include "PF_Column.h"
 #include "PointAndFigureDB.h"
+#include "common/AtomicFileWrite.h"
+#include "common/BoundedQueue.h"
+#include "common/WorkerPool.h"
 #include "utilities.h"
 
 using decimal::Decimal;
@@ -228,6 +233,15 @@ void PF_UpdaterApp::SetupProgramOptions()
     app_.add_option("--graphics-format", graphics_format_i_, "Graphics format: 'svg' or 'csv'.")
         ->default_val("svg")
         ->check(CLI::IsMember({"svg", "csv"}));
+    app_.add_option("--renderer", renderer_i_,
+                    "What draws 'svg' graphics: 'chartdirector' or 'native' (built in, no ChartDirector).")
+        ->default_val("chartdirector")
+        ->check(CLI::IsMember({"chartdirector", "native"}));
+
+    app_.add_option("--graphics-threads", graphics_threads_,
+                    "Number of workers writing charts and graphics at shutdown. 0 means use default.")
+        ->default_val(0)
+        ->check(CLI::NonNegativeNumber);
 
     app_.add_flag("--use-ATR", use_ATR_, "Use ATR-based box size calculation.");
 
@@ -333,6 +347,12 @@ bool PF_UpdaterApp::CheckArgs()
     }
 
     graphics_format_ = graphics_format_i_ == "svg" ? GraphicsFormat::e_svg : GraphicsFormat::e_csv;
+    renderer_ = renderer_i_ == "native" ? GraphicsRenderer::e_native : GraphicsRenderer::e_chartdirector;
+
+    // nothing else is running when graphics are made so they get the cores.
+
+    const int32_t cores = std::max(1U, std::thread::hardware_concurrency());
+    graphics_threads_ = graphics_threads_ > 0 ? graphics_threads_ : cores;
 
     if (destination_ == Destination::e_file)
     {
@@ -655,75 +675,134 @@ Decimal PF_UpdaterApp::ComputeATRForChartFromDB(const std::string &symbol) const
 
 void PF_UpdaterApp::ShutdownAndStoreOutputInFiles()
 {
-    for (const auto &[symbol, chart] : charts_)
-    {
+    // drawing is most of the work here so charts are written on a pool of workers.
+    // Each file is written under a temporary name then renamed so nobody reading the
+    // output directories ever sees half a file.
+
+    const std::string interval = new_data_source_ == Source::e_streaming ? "" : interval_i_;
+    const auto date_or_time = interval_ != Interval::e_eod ? X_AxisFormat::e_show_time : X_AxisFormat::e_show_date;
+
+    std::atomic<int32_t> chart_count = 0;
+    const auto started = std::chrono::steady_clock::now();
+
+    ForEachOnWorkerPool(charts_, graphics_threads_, [&](const auto &symbol_and_chart) {
+        const auto &chart = symbol_and_chart.second;
         if (chart.empty())
-            continue;
+        {
+            return;
+        }
         try
         {
-            fs::path output_file_name =
-                output_chart_directory_ /
-                chart.MakeChartFileName((new_data_source_ == Source::e_streaming ? "" : interval_i_), "json");
-            chart.ConvertChartToJsonAndWriteToFile(output_file_name);
+            WriteFileAtomically(
+                output_chart_directory_ / chart.MakeChartFileName(interval, "json"),
+                [&chart](const fs::path &temp_file) { chart.ConvertChartToJsonAndWriteToFile(temp_file); });
 
             if (graphics_format_ == GraphicsFormat::e_svg)
             {
-                fs::path graph_file_path =
-                    output_graphs_directory_ /
-                    (chart.MakeChartFileName((new_data_source_ == Source::e_streaming ? "" : interval_i_), "svg"));
-                ConstructCDPFChartGraphicAndWriteToFile(chart, graph_file_path, StreamedPrices{}, trend_lines_,
-                                                        interval_ != Interval::e_eod ? X_AxisFormat::e_show_time
-                                                                                     : X_AxisFormat::e_show_date);
+                WriteFileAtomically(output_graphs_directory_ / chart.MakeChartFileName(interval, "svg"),
+                                    [&](const fs::path &temp_file) {
+                                        ConstructPFChartGraphicAndWriteToFile(chart, temp_file, StreamedPrices{},
+                                                                              trend_lines_, date_or_time, renderer_);
+                                    });
             }
             else
             {
-                fs::path graph_file_path =
-                    output_graphs_directory_ /
-                    (chart.MakeChartFileName((new_data_source_ == Source::e_streaming ? "" : interval_i_), "csv"));
-                chart.ConvertChartToTableAndWriteToFile(graph_file_path, interval_ != Interval::e_eod
-                                                                             ? X_AxisFormat::e_show_time
-                                                                             : X_AxisFormat::e_show_date);
+                WriteFileAtomically(output_graphs_directory_ / chart.MakeChartFileName(interval, "csv"),
+                                    [&](const fs::path &temp_file) {
+                                        chart.ConvertChartToTableAndWriteToFile(temp_file, date_or_time);
+                                    });
             }
+            ++chart_count;
         }
         catch (const std::exception &e)
         {
-            spdlog::error(
-                std::format("Problem in shutdown: {} for chart: {}.\nTrying to "
-                            "complete shutdown.",
-                            e.what(),
-                            chart.MakeChartFileName((new_data_source_ == Source::e_streaming ? "" : interval_i_), "")));
+            spdlog::error(std::format("Problem in shutdown: {} for chart: {}.\nTrying to "
+                                      "complete shutdown.",
+                                      e.what(), chart.MakeChartFileName(interval, "")));
         }
-    }
+    });
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - started;
+    spdlog::info(std::format("Wrote {} charts using {} workers in {:.1f} seconds.", chart_count.load(),
+                             graphics_threads_, elapsed.count()));
 }
 
 void PF_UpdaterApp::ShutdownAndStoreOutputInDB()
 {
-    int32_t chart_count = 0;
+    // graphics (and csv tables) are made on a pool of workers. Storing stays on this
+    // thread, 1 writer keeps DB inserts simple. Charts ready to store wait in a bounded
+    // queue so the workers can't get far ahead of the DB.
+
+    const auto date_or_time = interval_ != Interval::e_eod ? X_AxisFormat::e_show_time : X_AxisFormat::e_show_date;
+
+    struct ChartReadyToStore
+    {
+        const PF_Chart *chart_ = nullptr;
+        std::string graphics_table_;
+    };
+
+    // open the DB first. If we can't, there is nobody to empty the queue.
+
     PF_DB pf_db{db_params_};
-    for (const auto &[symbol, chart] : charts_)
+    BoundedQueue<ChartReadyToStore> ready_queue{static_cast<size_t>(std::max(1, graphics_threads_)) * 2};
+
+    std::jthread graphics_stage{[&]() {
+        try
+        {
+            ForEachOnWorkerPool(charts_, graphics_threads_, [&](const auto &symbol_and_chart) {
+                const auto &chart = symbol_and_chart.second;
+                if (chart.empty())
+                {
+                    return;
+                }
+                try
+                {
+                    ChartReadyToStore ready{.chart_ = &chart};
+                    if (graphics_format_ == GraphicsFormat::e_svg)
+                    {
+                        WriteFileAtomically(output_graphs_directory_ / chart.MakeChartFileName(interval_i_, "svg"),
+                                            [&](const fs::path &temp_file) {
+                                                ConstructPFChartGraphicAndWriteToFile(chart, temp_file,
+                                                                                      StreamedPrices{}, trend_lines_,
+                                                                                      date_or_time, renderer_);
+                                            });
+                    }
+                    else
+                    {
+                        std::ostringstream oss{};
+                        chart.ConvertChartToTableAndWriteToStream(oss, date_or_time);
+                        ready.graphics_table_ = oss.str();
+                    }
+                    ready_queue.Push(std::move(ready));
+                }
+                catch (const std::exception &e)
+                {
+                    spdlog::error(std::format("Problem storing data in DB in shutdown: {} for chart: "
+                                              "{}.\nTrying to complete shutdown.",
+                                              e.what(), chart.MakeChartFileName(interval_i_, "")));
+                }
+            });
+        }
+        catch (const std::exception &e)
+        {
+            spdlog::error(std::format("Problem making graphics in shutdown: {}.", e.what()));
+        }
+        ready_queue.Close();
+    }};
+
+    int32_t chart_count = 0;
+    while (auto ready = ready_queue.Pop())
     {
-        if (chart.empty())
-            continue;
         try
         {
-            if (graphics_format_ == GraphicsFormat::e_svg)
-            {
-                fs::path graph_file_path = output_graphs_directory_ / (chart.MakeChartFileName(interval_i_, "svg"));
-                ConstructCDPFChartGraphicAndWriteToFile(chart, graph_file_path, StreamedPrices{}, trend_lines_,
-                                                        interval_ != Interval::e_eod ? X_AxisFormat::e_show_time
-                                                                                     : X_AxisFormat::e_show_date);
-            }
-            chart.StoreChartInChartsDB(pf_db, interval_i_,
-                                       interval_ != Interval::e_eod ? X_AxisFormat::e_show_time
-                                                                    : X_AxisFormat::e_show_date,
-                                       graphics_format_ == GraphicsFormat::e_csv);
+            pf_db.StorePFChartDataIntoDB(*ready->chart_, interval_i_, ready->graphics_table_);
             ++chart_count;
         }
         catch (const std::exception &e)
         {
             spdlog::error(std::format("Problem storing data in DB in shutdown: {} for chart: "
                                       "{}.\nTrying to complete shutdown.",
-                                      e.what(), chart.MakeChartFileName(interval_i_, "")));
+                                      e.what(), ready->chart_->MakeChartFileName(interval_i_, "")));
         }
     }
     spdlog::info(std::format("Stored {} charts in DB.", chart_count));
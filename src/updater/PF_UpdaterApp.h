@@ -134,6 +134,7 @@ private:
 
     std::string quote_data_source_i_;
     std::string graphics_format_i_;
+    std::string renderer_i_;
     std::string destination_i_;
     std::string interval_i_;
     std::string source_format_i_;
@@ -148,6 +149,7 @@ private:
     SourceFormat source_format_ = SourceFormat::e_csv;
     Destination destination_ = Destination::e_unknown;
     GraphicsFormat graphics_format_ = GraphicsFormat::e_unknown;
+    GraphicsRenderer renderer_ = GraphicsRenderer::e_chartdirector;
     BoxsizeSource boxsize_source_ = BoxsizeSource::e_unknown;
     QuoteDataSource quote_data_source_ = QuoteDataSource::e_unknown;
     Interval interval_ = Interval::e_unknown;
@@ -168,6 +170,7 @@ private:
     int64_t min_close_volume_ = 100'000;
     int32_t max_columns_for_graph_ = -1;
     int32_t number_of_days_history_for_ATR_ = 0;
+    int32_t graphics_threads_ = 0;
     bool use_ATR_ = false;
     bool use_min_max_ = false;
     std::vector<std::string> exchange_list_;